@@ -274,7 +274,7 @@ newremove(char* tabname, struct ast* attr)
 
 /*---------------------------create pair ast -----------------------------*/
 struct ast*
-newcreate_pair(char* name, int type)
+newcreate_pair(char* name, int type, int inline_size)
 {
     struct create_pair_ast* create_pair = malloc(sizeof(struct create_pair_ast));
     if (!create_pair) {
@@ -284,6 +284,7 @@ newcreate_pair(char* name, int type)
     create_pair->nodetype = NT_CREATE_PAIR;
     create_pair->name = name;
     create_pair->type = type;
+    create_pair->inline_size = inline_size;
     return (struct ast*)create_pair;
 }
 
@@ -316,6 +317,22 @@ newdrop(char* name)
     return (struct ast*)drop;
 }
 
+/*---------------------------create index ast -----------------------------*/
+struct ast*
+newcreate_index(char* tabname, char* attr_name, int hash)
+{
+    struct create_index_ast* create_index = malloc(sizeof(struct create_index_ast));
+    if (!create_index) {
+        fprintf(stderr, "out of space");
+        return NULL;
+    }
+    create_index->nodetype = NT_CREATE_INDEX;
+    create_index->tabname = tabname;
+    create_index->attr_name = attr_name;
+    create_index->hash = hash;
+    return (struct ast*)create_index;
+}
+
 
 static void print_indent(FILE* stream, int level)
 {
@@ -397,6 +414,15 @@ void print_ast(FILE* stream, struct ast* ast, int level)
             print_node(stream, level, "}\n");
             break;
         }
+        case NT_CREATE_INDEX: {
+            struct create_index_ast* indexast = (struct create_index_ast*)ast;
+            print_node(stream, level, "create_index: {\n");
+            print_node(stream, level+1, "tabname: %s\n", indexast->tabname);
+            print_node(stream, level+1, "attribute: %s\n", indexast->attr_name);
+            print_node(stream, level+1, "method: %s\n", indexast->hash ? "hash" : "btree");
+            print_node(stream, level, "}\n");
+            break;
+        }
         case NT_LIST: {
             struct list_ast* listast = (struct list_ast*)ast;
             print_ast(stream, listast->next, level);
@@ -418,6 +444,9 @@ void print_ast(FILE* stream, struct ast* ast, int level)
             print_node(stream, level, "definition: {\n");
             print_node(stream, level+1, "name: %s\n", create_pairast->name);
             print_node(stream, level+1, "type: %s\n", str_type[create_pairast->type]);
+            if (create_pairast->inline_size > 0) {
+                print_node(stream, level+1, "inline: %d\n", create_pairast->inline_size);
+            }
             print_node(stream, level, "}\n");
             break;
         }
@@ -560,6 +589,13 @@ void free_ast(struct ast* ast){
             free(dropast);
             break;
         }
+        case NT_CREATE_INDEX: {
+            struct create_index_ast* indexast = (struct create_index_ast*)ast;
+            free(indexast->tabname);
+            free(indexast->attr_name);
+            free(indexast);
+            break;
+        }
         case NT_LIST: {
             struct list_ast* listast = (struct list_ast*)ast;
             free_ast(listast->value);
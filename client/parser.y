@@ -32,7 +32,7 @@ extern int yyerror(struct ast** ast, const char *s, ...);
 
 
     /* keywords */
-%token FOR RETURN FILTER INSERT UPDATE REMOVE WITH INTO CREATE DROP MERGE
+%token FOR RETURN FILTER INSERT UPDATE REMOVE WITH INTO CREATE DROP MERGE INDEX HASH
 
     /* types */
 %token<subtok> TYPE
@@ -49,7 +49,7 @@ extern int yyerror(struct ast** ast, const char *s, ...);
 %type <ast> query terminal non_terminal_list 
 %type <ast> insert_stmt document pairs pair
 %type <ast> update_stmt remove_stmt drop_stmt
-%type <ast> create_stmt create_pairs create_pair
+%type <ast> create_stmt create_pairs create_pair create_index_stmt
 
 %glr-parser
 
@@ -65,6 +65,7 @@ terminal: return_stmt
     | remove_stmt
     | create_stmt
     | drop_stmt
+    | create_index_stmt
     ;
 
 query: terminal YYEOF                            { $$ = $1;}
@@ -152,7 +153,13 @@ create_stmt: CREATE VARNAME WITH '{' create_pairs '}'       { $$ = newcreate($2,
 create_pairs: create_pair                           { $$ = newlist($1, NULL); *root= $$;}
     | create_pairs ',' create_pair                  { $$ = newlist($3, $1); *root= $$;}
     ;
-create_pair: VARNAME ':' TYPE                      { $$ = newcreate_pair($1, $3); *root= $$;}
+create_pair: VARNAME ':' TYPE                      { $$ = newcreate_pair($1, $3, 0); *root= $$;}
+    | VARNAME ':' TYPE '(' INTVAL ')'                 { $$ = newcreate_pair($1, $3, $5); *root= $$;}
+    ;
+
+/*---------------create index-----------------*/
+create_index_stmt: CREATE INDEX VARNAME '(' VARNAME ')'     { $$ = newcreate_index($3, $5, 0); *root= $$;}
+    | CREATE HASH INDEX VARNAME '(' VARNAME ')'                { $$ = newcreate_index($4, $6, 1); *root= $$;}
     ;
 
 /*---------------drop-----------------*/
@@ -70,6 +70,17 @@ void add_node(xmlNodePtr parent, struct ast *node)
         xmlNewProp(xmlNode, BAD_CAST "tabname", BAD_CAST buffer);
         break;
     }
+    case NT_CREATE_INDEX:
+    {
+        struct create_index_ast *index_ast = (struct create_index_ast *)node;
+        xmlNode = xmlNewChild(parent, NULL, BAD_CAST "create_index", NULL);
+        snprintf(buffer, sizeof(buffer), "%s", index_ast->tabname);
+        xmlNewProp(xmlNode, BAD_CAST "tabname", BAD_CAST buffer);
+        snprintf(buffer, sizeof(buffer), "%s", index_ast->attr_name);
+        xmlNewProp(xmlNode, BAD_CAST "attribute", BAD_CAST buffer);
+        xmlNewProp(xmlNode, BAD_CAST "method", BAD_CAST (index_ast->hash ? "hash" : "btree"));
+        break;
+    }
     case NT_LIST:
     {
         struct list_ast *list_ast = (struct list_ast *)node;
@@ -94,6 +105,10 @@ void add_node(xmlNodePtr parent, struct ast *node)
         xmlNewProp(xmlNode, BAD_CAST "name", BAD_CAST buffer);
         snprintf(buffer, sizeof(buffer), "%s", str_type[create_pair_ast->type]);
         xmlNewProp(xmlNode, BAD_CAST "type", BAD_CAST buffer);
+        if (create_pair_ast->inline_size > 0) {
+            snprintf(buffer, sizeof(buffer), "%d", create_pair_ast->inline_size);
+            xmlNewProp(xmlNode, BAD_CAST "inline", BAD_CAST buffer);
+        }
         break;
     }
     case NT_MERGE:
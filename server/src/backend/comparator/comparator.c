@@ -13,11 +13,19 @@ data_t comp_cmp(db_t* db, datatype_t type, void* val1, void* val2){
     data_t data;
     switch (type) {
         case DT_INT: {
-            data.int_val = (*(int64_t *) val1 - *(int64_t *) val2);
+            /* Difference of far apart values overflows, only its sign is needed */
+            int64_t int1, int2;
+            /* Values may come from rows in declaration order, which are not aligned */
+            memcpy(&int1, val1, sizeof(int1));
+            memcpy(&int2, val2, sizeof(int2));
+            data.int_val = (int1 > int2) - (int1 < int2);
             break;
         }
         case DT_FLOAT: {
-            data.float_val = *(double *) val1 - *(double *) val2;
+            double float1, float2;
+            memcpy(&float1, val1, sizeof(float1));
+            memcpy(&float2, val2, sizeof(float2));
+            data.float_val = float1 - float2;
             break;
         }
         case DT_CHAR: {
@@ -29,16 +37,7 @@ data_t comp_cmp(db_t* db, datatype_t type, void* val1, void* val2){
             break;
         }
         case DT_VARCHAR: {
-            vch_ticket_t* vch1 = val1;
-            vch_ticket_t* vch2 = val2;
-            char* str1 = malloc(vch1->size);
-            vch_get(db->varchar_mgr_idx, vch1, str1);
-            char* str2 = malloc(vch2->size);
-            vch_get(db->varchar_mgr_idx, vch2, str2);
-            int res = strcmp(str1, str2);
-            free(str1);
-            free(str2);
-            data.int_val = res;
+            data.int_val = vch_cmp(db->varchar_mgr_idx, val1, val2);
             break;
         }
         case DT_UNKNOWN:
@@ -58,6 +57,10 @@ data_t comp_cmp(db_t* db, datatype_t type, void* val1, void* val2){
  */
 
 bool comp_eq(db_t* db, datatype_t type, void* val1, void* val2){
+    if(type == DT_VARCHAR){
+        /* Size and hash in tickets decide most inequalities */
+        return vch_eq(db->varchar_mgr_idx, val1, val2);
+    }
     data_t data = comp_cmp(db, type, val1, val2);
     switch (type) {
         case DT_INT: {
@@ -192,3 +195,235 @@ bool comp_compare(db_t* db, datatype_t type, void* val1, void* val2, condition_t
 }
 
 
+
+/**
+ * @brief       Define tests of element of fixed size type with constant of predicate
+ * @param[in]   name: suffix of names of the tests
+ * @param[in]   type: C type of the element
+ * @param[in]   member: member of constant of predicate
+ */
+
+#define COMP_DEFINE_TESTS(name, type, member) \
+    COMP_DEFINE_TEST(name##_eq, type, member, ==) \
+    COMP_DEFINE_TEST(name##_neq, type, member, !=) \
+    COMP_DEFINE_TEST(name##_lt, type, member, <) \
+    COMP_DEFINE_TEST(name##_le, type, member, <=) \
+    COMP_DEFINE_TEST(name##_gt, type, member, >) \
+    COMP_DEFINE_TEST(name##_ge, type, member, >=) \
+    static const comp_test_t comp_##name##_tests[] = { \
+        [COND_EQ] = comp_##name##_eq, [COND_NEQ] = comp_##name##_neq, [COND_LT] = comp_##name##_lt, \
+        [COND_LTE] = comp_##name##_le, [COND_GT] = comp_##name##_gt, [COND_GTE] = comp_##name##_ge \
+    };
+
+#define COMP_DEFINE_TEST(name, type, member, op) \
+    static bool comp_##name(const comp_pred_t* pred, const void* element){ \
+        type val; \
+        memcpy(&val, element, sizeof(type)); \
+        return val op pred->constant.member; \
+    }
+
+COMP_DEFINE_TESTS(int, int64_t, int_val)
+COMP_DEFINE_TESTS(float, double, float_val)
+COMP_DEFINE_TESTS(bool, bool, bool_val)
+
+/**
+ * @brief       Apply condition to result of comparison
+ * @param[in]   cond: comparison condition
+ * @param[in]   cmp: result of comparison, sign of it matters
+ * @return      true, or false depends on comparison condition
+ */
+
+static bool comp_cond(condition_t cond, int cmp){
+    switch (cond) {
+        case COND_EQ:
+            return cmp == 0;
+        case COND_NEQ:
+            return cmp != 0;
+        case COND_LT:
+            return cmp < 0;
+        case COND_LTE:
+            return cmp <= 0;
+        case COND_GT:
+            return cmp > 0;
+        case COND_GTE:
+            return cmp >= 0;
+    }
+    return false;
+}
+
+static bool comp_char(const comp_pred_t* pred, const void* element){
+    return comp_cond(pred->cond, strcmp(element, pred->value));
+}
+
+static bool comp_varchar(const comp_pred_t* pred, const void* element){
+    /* Inline value may continue past the ticket in a wider slot, only strings in memory are copied */
+    vch_ticket_t* vch = vch_is_transient(&pred->constant.vch) ? (vch_ticket_t*) &pred->constant.vch : pred->value;
+    if(pred->cond == COND_EQ || pred->cond == COND_NEQ){
+        return vch_eq(pred->db->varchar_mgr_idx, (vch_ticket_t*) element, vch) == (pred->cond == COND_EQ);
+    }
+    return comp_cond(pred->cond, vch_cmp(pred->db->varchar_mgr_idx, (vch_ticket_t*) element, vch));
+}
+
+static bool comp_dict_code(const comp_pred_t* pred, const void* element){
+    int32_t code;
+    memcpy(&code, element, sizeof(int32_t));
+    return (code == pred->code) == (pred->cond == COND_EQ);
+}
+
+static bool comp_dict_varchar(const comp_pred_t* pred, const void* element){
+    vch_ticket_t ticket;
+    vch_ticket_t* vch = sch_varchar_ticket(pred->field, (void*) element, &ticket);
+    return vch != NULL && comp_varchar(pred, vch);
+}
+
+static bool comp_never(const comp_pred_t* pred, const void* element){
+    (void) pred;
+    (void) element;
+    return false;
+}
+
+/**
+ * @brief       Prepare comparison of field elements with a value
+ * @param[out]  pred: predicate to initialize
+ * @param[in]   db: pointer to db
+ * @param[in]   field: field of elements
+ * @param[in]   cond: comparison condition
+ * @param[in]   value: value to compare with, varchar value is a ticket
+ */
+
+void comp_pred_init(comp_pred_t* pred, db_t* db, const field_t* field, condition_t cond, void* value){
+    pred->db = db;
+    pred->field = field;
+    pred->cond = cond;
+    pred->value = value;
+    pred->by_code = false;
+    pred->code = DICT_NOT_FOUND;
+    pred->test = comp_never;
+    switch (field->type) {
+        case DT_INT:
+            memcpy(&pred->constant.int_val, value, sizeof(int64_t));
+            pred->test = comp_int_tests[cond];
+            return;
+        case DT_FLOAT:
+            memcpy(&pred->constant.float_val, value, sizeof(double));
+            pred->test = comp_float_tests[cond];
+            return;
+        case DT_BOOL:
+            memcpy(&pred->constant.bool_val, value, sizeof(bool));
+            pred->test = comp_bool_tests[cond];
+            return;
+        case DT_CHAR:
+            pred->test = comp_char;
+            return;
+        case DT_VARCHAR:
+            memcpy(&pred->constant.vch, value, sizeof(vch_ticket_t));
+            pred->test = sch_is_dict_field(field) ? comp_dict_varchar : comp_varchar;
+            break;
+        case DT_UNKNOWN:
+            return;
+    }
+    if(!sch_is_dict_field(field) || (cond != COND_EQ && cond != COND_NEQ)){
+        return;
+    }
+    char* str = vch_acquire(db->varchar_mgr_idx, value);
+    if(!str){
+        return;
+    }
+    /* Value which is not in dictionary gets DICT_NOT_FOUND and equals nothing */
+    int32_t code = dict_find(db->varchar_mgr_idx, field->dict, str);
+    vch_release(value, str);
+    if(code != DICT_FAIL){
+        pred->by_code = true;
+        pred->code = code;
+        pred->test = comp_dict_code;
+    }
+}
+
+/**
+ * @brief       Compare elements of two fields
+ * @param[in]   db: pointer to db
+ * @param[in]   field1: field of the first element
+ * @param[in]   el1: the first element
+ * @param[in]   field2: field of the second element
+ * @param[in]   el2: the second element
+ * @param[in]   cond: comparison condition
+ * @return      true, or false depends on comparison condition
+ */
+
+bool comp_compare_fields(db_t* db, const field_t* field1, void* el1, const field_t* field2, void* el2, condition_t cond){
+    if(!sch_is_dict_field(field1) && !sch_is_dict_field(field2)){
+        return comp_compare(db, field1->type, el1, el2, cond);
+    }
+    if(field1->dict == field2->dict && (cond == COND_EQ || cond == COND_NEQ)){
+        return (memcmp(el1, el2, sizeof(int32_t)) == 0) == (cond == COND_EQ);
+    }
+    vch_ticket_t ticket1;
+    vch_ticket_t ticket2;
+    vch_ticket_t* vch1 = sch_varchar_ticket(field1, el1, &ticket1);
+    vch_ticket_t* vch2 = sch_varchar_ticket(field2, el2, &ticket2);
+    return vch1 != NULL && vch2 != NULL && comp_compare(db, DT_VARCHAR, vch1, vch2, cond);
+}
+
+/**
+ * @brief       Mix bits of 64-bit value
+ * @param[in]   x: value
+ * @return      hash of the value
+ */
+
+uint64_t comp_mix(uint64_t x){
+    x ^= x >> 30;
+    x *= UINT64_C(0xbf58476d1ce4e5b9);
+    x ^= x >> 27;
+    x *= UINT64_C(0x94d049bb133111eb);
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief       Hash element of field, elements equal by comp_compare_fields get equal hashes
+ * @param[in]   field: field of the element
+ * @param[in]   el: the element
+ * @param[in]   by_code: hash code of dictionary encoded element instead of string,
+ *              allowed only when both compared fields share the dictionary
+ * @return      hash of the element
+ */
+
+uint64_t comp_hash_field(const field_t* field, void* el, bool by_code){
+    switch (field->type) {
+        case DT_INT: {
+            int64_t val;
+            memcpy(&val, el, sizeof(int64_t));
+            return comp_mix((uint64_t) val);
+        }
+        case DT_FLOAT: {
+            double val;
+            memcpy(&val, el, sizeof(double));
+            /* -0.0 equals 0.0 */
+            val = val == 0 ? 0 : val;
+            uint64_t bits;
+            memcpy(&bits, &val, sizeof(uint64_t));
+            return comp_mix(bits);
+        }
+        case DT_BOOL:
+            return comp_mix(*(bool*) el);
+        case DT_CHAR: {
+            uint64_t hash = 0;
+            for(const char* c = el; c < (const char*) el + field->size && *c; c++){
+                hash = hash * 31 + (uint8_t) *c;
+            }
+            return comp_mix(hash);
+        }
+        case DT_VARCHAR: {
+            if(by_code){
+                int32_t code;
+                memcpy(&code, el, sizeof(int32_t));
+                return comp_mix((uint64_t) code);
+            }
+            vch_ticket_t ticket;
+            vch_ticket_t* vch = sch_varchar_ticket(field, el, &ticket);
+            return vch ? comp_mix(vch_hash(vch)) : 0;
+        }
+        case DT_UNKNOWN:
+            return 0;
+    }
+    return 0;
+}
@@ -2,10 +2,49 @@
 #include "backend/data_type.h"
 #include "backend/db/db.h"
 #include "backend/journal/varchar_mgr.h"
+#include "backend/table/schema.h"
 #include "conditions.h"
 #include <stdbool.h>
 #include <string.h>
 
+/**
+ * Comparison of field elements with a value prepared once per scan. The
+ * predicate is compiled to a test specialized for type of the field, the
+ * condition and the value, so testing an element does not dispatch on
+ * them. Value of dictionary encoded field is translated to its code, so
+ * equality is decided by comparing codes without reading strings, varchar
+ * value of query is copied into the predicate.
+ */
+
+typedef struct comp_pred comp_pred_t;
+
+typedef bool (*comp_test_t)(const comp_pred_t* pred, const void* element);
+
+struct comp_pred{
+    db_t* db;
+    const field_t* field;
+    condition_t cond;
+    void* value;
+    bool by_code;
+    int32_t code;
+    comp_test_t test;
+    union {
+        int64_t int_val;
+        double float_val;
+        bool bool_val;
+        vch_ticket_t vch;
+    } constant;
+};
+
+/**
+ * @brief       Compare element of field with prepared value
+ * @param[in]   pred: prepared predicate
+ * @param[in]   element: element of the field
+ * @return      true, or false depends on comparison condition
+ */
+
+#define comp_pred_test(pred, element) ((pred)->test((pred), (element)))
+
 data_t comp_cmp(db_t* db, datatype_t type, void* val1, void* val2);
 bool comp_eq(db_t* db, datatype_t type, void* val1, void* val2);
 bool comp_compare(db_t* db, datatype_t type, void* val1, void* val2, condition_t cond);
@@ -14,3 +53,7 @@ bool comp_lt(db_t* db, datatype_t type, void* val1, void* val2);
 bool comp_le(db_t* db, datatype_t type, void* val1, void* val2);
 bool comp_gt(db_t* db, datatype_t type, void* val1, void* val2);
 bool comp_ge(db_t* db, datatype_t type, void* val1, void* val2);
+void comp_pred_init(comp_pred_t* pred, db_t* db, const field_t* field, condition_t cond, void* value);
+bool comp_compare_fields(db_t* db, const field_t* field1, void* el1, const field_t* field2, void* el2, condition_t cond);
+uint64_t comp_mix(uint64_t x);
+uint64_t comp_hash_field(const field_t* field, void* el, bool by_code);
@@ -1,3 +1,5 @@
+#pragma once
+
 typedef enum condition{
     COND_EQ = 0,
     COND_NEQ = 1,
@@ -0,0 +1,263 @@
+#define _DEFAULT_SOURCE
+#include "jit.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+
+#if defined(__x86_64__) && defined(__unix__)
+#define JIT_X86_64 1
+#include <sys/mman.h>
+#else
+#define JIT_X86_64 0
+#endif
+
+/* Longest code of a leaf with its branch, in bytes */
+#define JIT_LEAF_CODE 64
+/* Prologue and epilogue of the function */
+#define JIT_FRAME_CODE 32
+
+static bool jit_on = JIT_DEFAULT_ENABLED && JIT_X86_64;
+
+/**
+ * @brief       Check whether chains are compiled to native code
+ * @return      true if JIT is enabled
+ */
+
+bool jit_enabled(void){
+    return jit_on;
+}
+
+/**
+ * @brief       Enable or disable compilation of chains to native code
+ * @param[in]   enabled: requested state
+ * @return      state in effect, JIT stays disabled on machines it does not support
+ */
+
+bool jit_set_enabled(bool enabled){
+    jit_on = enabled && JIT_X86_64;
+    return jit_on;
+}
+
+#if JIT_X86_64
+
+typedef struct jit_buf{
+    uint8_t* code;
+    int64_t size;
+} jit_buf_t;
+
+/* Condition codes of setcc and jcc, the second byte of their opcodes */
+enum {CC_AE = 0x93, CC_E = 0x94, CC_NE = 0x95, CC_A = 0x97, CC_P = 0x9A, CC_NP = 0x9B,
+      CC_L = 0x9C, CC_GE = 0x9D, CC_LE = 0x9E, CC_G = 0x9F};
+
+static const uint8_t jit_signed_cc[] = {
+    [COND_EQ] = CC_E, [COND_NEQ] = CC_NE, [COND_LT] = CC_L,
+    [COND_LTE] = CC_LE, [COND_GT] = CC_G, [COND_GTE] = CC_GE
+};
+
+static void jit_emit(jit_buf_t* buf, const uint8_t* bytes, int64_t n){
+    memcpy(buf->code + buf->size, bytes, n);
+    buf->size += n;
+}
+
+#define jit_bytes(buf, ...) jit_emit((buf), (const uint8_t[]) {__VA_ARGS__}, sizeof((const uint8_t[]) {__VA_ARGS__}))
+
+static void jit_u32(jit_buf_t* buf, uint32_t value){
+    jit_emit(buf, (const uint8_t*) &value, sizeof(value));
+}
+
+static void jit_u64(jit_buf_t* buf, uint64_t value){
+    jit_emit(buf, (const uint8_t*) &value, sizeof(value));
+}
+
+/**
+ * @brief       Emit setcc al
+ * @param[in]   buf: code buffer
+ * @param[in]   cc: condition code
+ */
+
+static void jit_setcc(jit_buf_t* buf, uint8_t cc){
+    jit_bytes(buf, 0x0F, cc, 0xC0);
+}
+
+/**
+ * @brief       Emit call of function at absolute address, arguments are already in registers
+ * @param[in]   buf: code buffer
+ * @param[in]   fn: address of the function
+ */
+
+static void jit_call(jit_buf_t* buf, uint64_t fn){
+    jit_bytes(buf, 0x48, 0xB8); //mov rax, imm64
+    jit_u64(buf, fn);
+    jit_bytes(buf, 0xFF, 0xD0); //call rax
+}
+
+/**
+ * @brief       Emit test of element of leaf, result is left in al
+ * @param[in]   buf: code buffer
+ * @param[in]   leaf: leaf of the chain
+ * @note        row is kept in rbx
+ */
+
+static void jit_leaf(jit_buf_t* buf, const jit_leaf_t* leaf){
+    const comp_pred_t* pred = leaf->pred;
+    uint32_t disp = (uint32_t) leaf->offset;
+    condition_t cond = pred->cond;
+    switch (pred->field->type) {
+        case DT_INT:
+            jit_bytes(buf, 0x48, 0x8B, 0x83); //mov rax, [rbx + disp32]
+            jit_u32(buf, disp);
+            jit_bytes(buf, 0x48, 0xB9); //mov rcx, imm64
+            jit_u64(buf, (uint64_t) pred->constant.int_val);
+            jit_bytes(buf, 0x48, 0x39, 0xC8); //cmp rax, rcx
+            jit_setcc(buf, jit_signed_cc[cond]);
+            return;
+        case DT_BOOL:
+            jit_bytes(buf, 0x0F, 0xB6, 0x83); //movzx eax, byte [rbx + disp32]
+            jit_u32(buf, disp);
+            jit_bytes(buf, 0x3D); //cmp eax, imm32
+            jit_u32(buf, pred->constant.bool_val);
+            jit_setcc(buf, jit_signed_cc[cond]);
+            return;
+        case DT_FLOAT: {
+            uint64_t bits;
+            memcpy(&bits, &pred->constant.float_val, sizeof(bits));
+            jit_bytes(buf, 0xF2, 0x0F, 0x10, 0x83); //movsd xmm0, [rbx + disp32]
+            jit_u32(buf, disp);
+            jit_bytes(buf, 0x48, 0xB8); //mov rax, imm64
+            jit_u64(buf, bits);
+            jit_bytes(buf, 0x66, 0x48, 0x0F, 0x6E, 0xC8); //movq xmm1, rax
+            /* Unordered comparison sets CF, ZF and PF, so NaN fails all conditions but inequality as in C */
+            if(cond == COND_LT || cond == COND_LTE){
+                jit_bytes(buf, 0x66, 0x0F, 0x2E, 0xC8); //ucomisd xmm1, xmm0
+                jit_setcc(buf, cond == COND_LT ? CC_A : CC_AE);
+                return;
+            }
+            jit_bytes(buf, 0x66, 0x0F, 0x2E, 0xC1); //ucomisd xmm0, xmm1
+            if(cond == COND_GT || cond == COND_GTE){
+                jit_setcc(buf, cond == COND_GT ? CC_A : CC_AE);
+            } else if(cond == COND_EQ){
+                jit_setcc(buf, CC_E);
+                jit_bytes(buf, 0x0F, CC_NP, 0xC1); //setnp cl
+                jit_bytes(buf, 0x20, 0xC8); //and al, cl
+            } else {
+                jit_setcc(buf, CC_NE);
+                jit_bytes(buf, 0x0F, CC_P, 0xC1); //setp cl
+                jit_bytes(buf, 0x08, 0xC8); //or al, cl
+            }
+            return;
+        }
+        case DT_CHAR:
+            jit_bytes(buf, 0x48, 0x8D, 0xBB); //lea rdi, [rbx + disp32]
+            jit_u32(buf, disp);
+            jit_bytes(buf, 0x48, 0xBE); //mov rsi, imm64
+            jit_u64(buf, (uint64_t) (uintptr_t) pred->value);
+            jit_call(buf, (uint64_t) (uintptr_t) strcmp);
+            jit_bytes(buf, 0x85, 0xC0); //test eax, eax
+            jit_setcc(buf, jit_signed_cc[cond]);
+            return;
+        default: {
+            /* Varchar is compared by its predicate */
+            uint64_t test;
+            memcpy(&test, &pred->test, sizeof(test));
+            jit_bytes(buf, 0x48, 0xBF); //mov rdi, imm64
+            jit_u64(buf, (uint64_t) (uintptr_t) pred);
+            jit_bytes(buf, 0x48, 0x8D, 0xB3); //lea rsi, [rbx + disp32]
+            jit_u32(buf, disp);
+            jit_call(buf, test);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief       Compile chain of predicates to native code
+ * @param[in]   leaves: leaves of the chain in its order
+ * @param[in]   count: number of leaves
+ * @return      pointer to the code on success, NULL on failure or when JIT is disabled
+ * @note        chain is decided by the first leaf which is false before AND or true before OR,
+ *              and by the last leaf otherwise, empty chain matches every row
+ */
+
+jit_code_t* jit_compile(const jit_leaf_t* leaves, int64_t count){
+    if(!jit_on){
+        return NULL;
+    }
+    for(int64_t i = 0; i < count; i++){
+        if(leaves[i].offset < 0 || leaves[i].offset > INT32_MAX || leaves[i].pred->cond > COND_GTE){
+            return NULL;
+        }
+    }
+    jit_code_t* code = malloc(sizeof(jit_code_t));
+    int64_t* branches = malloc((count + 1) * sizeof(int64_t));
+    int64_t page = 4096;
+    int64_t size = (JIT_FRAME_CODE + count * JIT_LEAF_CODE + page - 1) / page * page;
+    void* memory = code && branches ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)
+                                    : MAP_FAILED;
+    if(memory == MAP_FAILED){
+        logger(LL_ERROR, __func__, "Unable to allocate code of %ld predicates", count);
+        free(code);
+        free(branches);
+        return NULL;
+    }
+
+    jit_buf_t buf = {.code = memory, .size = 0};
+    jit_bytes(&buf, 0x53); //push rbx, also aligns stack for calls
+    jit_bytes(&buf, 0x48, 0x89, 0xFB); //mov rbx, rdi
+    if(count == 0){
+        jit_bytes(&buf, 0xB0, 0x01); //mov al, 1
+    }
+    int64_t branch_count = 0;
+    for(int64_t i = 0; i < count; i++){
+        jit_leaf(&buf, &leaves[i]);
+        if(leaves[i].logic == JIT_LAST || i + 1 == count){
+            break;
+        }
+        jit_bytes(&buf, 0x84, 0xC0); //test al, al
+        jit_bytes(&buf, 0x0F, leaves[i].logic == JIT_AND ? 0x84 : 0x85); //jz or jnz rel32 to the epilogue
+        branches[branch_count++] = buf.size;
+        jit_u32(&buf, 0);
+    }
+    for(int64_t i = 0; i < branch_count; i++){
+        int32_t rel = (int32_t) (buf.size - (branches[i] + (int64_t) sizeof(int32_t)));
+        memcpy(buf.code + branches[i], &rel, sizeof(rel));
+    }
+    jit_bytes(&buf, 0x0F, 0xB6, 0xC0); //movzx eax, al
+    jit_bytes(&buf, 0x5B); //pop rbx
+    jit_bytes(&buf, 0xC3); //ret
+    free(branches);
+
+    if(mprotect(memory, size, PROT_READ | PROT_EXEC) != 0){
+        logger(LL_ERROR, __func__, "Unable to make code of %ld predicates executable", count);
+        munmap(memory, size);
+        free(code);
+        return NULL;
+    }
+    code->memory = memory;
+    code->size = size;
+    /* Code is reached through function pointer, conversion of object pointer is not portable C */
+    memcpy(&code->fn, &memory, sizeof(code->fn));
+    return code;
+}
+
+/**
+ * @brief       Free compiled chain
+ * @param[in]   code: compiled chain or NULL
+ */
+
+void jit_free(jit_code_t* code){
+    if(!code){
+        return;
+    }
+    munmap(code->memory, code->size);
+    free(code);
+}
+
+#else
+
+jit_code_t* jit_compile(const jit_leaf_t* leaves, int64_t count){
+    return NULL;
+}
+
+void jit_free(jit_code_t* code){
+}
+
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+#include "comparator.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Native code of chains of predicates on rows. Chain is compiled to machine
+ * code of x86-64 which reads elements at fixed offsets of the row and
+ * compares int, float and bool elements with constants inline, char
+ * elements through strcmp and others through test of their predicate. The
+ * code is not generated on other machines or while JIT is disabled, chain
+ * is then left to the interpreter.
+ */
+
+#ifndef JIT_DEFAULT_ENABLED
+#define JIT_DEFAULT_ENABLED false
+#endif
+
+typedef enum {JIT_LAST = 0, JIT_AND = 1, JIT_OR = 2} jit_logic_t;
+
+typedef struct jit_leaf{
+    int64_t offset; //offset of the element in row
+    const comp_pred_t* pred; //must outlive the code
+    jit_logic_t logic; //with the rest of the chain, JIT_LAST for the last leaf
+} jit_leaf_t;
+
+typedef bool (*jit_fn_t)(const void* row);
+
+typedef struct jit_code{
+    jit_fn_t fn;
+    void* memory;
+    int64_t size;
+} jit_code_t;
+
+/**
+ * @brief       Check row with compiled chain
+ * @param[in]   code: compiled chain
+ * @param[in]   row: row of the table
+ * @return      true if the row matches the chain
+ */
+
+#define jit_test(code, row) ((code)->fn(row))
+
+bool jit_enabled(void);
+bool jit_set_enabled(bool enabled);
+jit_code_t* jit_compile(const jit_leaf_t* leaves, int64_t count);
+void jit_free(jit_code_t* code);
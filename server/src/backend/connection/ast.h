@@ -11,7 +11,7 @@ typedef enum ntype {
     NT_FOR, NT_RETURN, NT_FILTER, NT_INSERT,
     NT_UPDATE, NT_REMOVE, NT_CREATE, NT_DROP,
     NT_PAIR, NT_FILTER_CONDITION, NT_FILTER_EXPR,
-    NT_ATTR_NAME, NT_LIST, NT_CREATE_PAIR, NT_MERGE, NT_MERGE_PROJECTIONS,
+    NT_ATTR_NAME, NT_LIST, NT_CREATE_PAIR, NT_MERGE, NT_MERGE_PROJECTIONS, NT_CREATE_INDEX,
 
     /* variable types */
     NT_INTEGER, NT_FLOAT, NT_STRING, NT_BOOLEAN,
@@ -160,6 +160,7 @@ struct create_pair_ast {
     ntype_t nodetype;
     char* name;
     ntype_t type;
+    int inline_size; //inline capacity of string column, 0 for the default one
 };
 
 struct create_ast {
@@ -173,6 +174,13 @@ struct drop_ast {
     char* name;
 };
 
+struct create_index_ast {
+    ntype_t nodetype;
+    char* tabname;
+    char* attr_name;
+    int hash; // hash index instead of B+tree
+};
+
 
 
 struct ast*
@@ -230,7 +238,7 @@ struct ast*
 newremove(char* tabname, struct ast* attr);
 
 struct ast*
-newcreate_pair(char* name, int type);
+newcreate_pair(char* name, int type, int inline_size);
 
 struct ast*
 newcreate(char* name, struct ast* difinitions);
@@ -238,6 +246,9 @@ newcreate(char* name, struct ast* difinitions);
 struct ast*
 newdrop(char* name);
 
+struct ast*
+newcreate_index(char* tabname, char* attr_name, int hash);
+
 
 
 void print_ast(FILE* stream, struct ast* ast, int level);
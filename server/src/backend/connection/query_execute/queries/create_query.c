@@ -14,9 +14,18 @@ int create_exec(default_query_args_t* args) {
         struct list_ast *list_ast = (struct list_ast *) temp;
         struct create_pair_ast *pair_ast = (struct create_pair_ast *) list_ast->value;
         char *name = pair_ast->name;
+        if (pair_ast->inline_size != 0 &&
+            (pair_ast->type != NT_STRING || pair_ast->inline_size < 0 || pair_ast->inline_size > VCH_MAX_INLINE_SIZE)) {
+            LOG_ERROR_AND_UPDATE_RESPONSE(args->resp, "Invalid inline size %d of %s", pair_ast->inline_size, name);
+            return -1;
+        }
         switch (pair_ast->type) {
             case NT_STRING:
-                sch_add_varchar_field(schema, name);
+                if (pair_ast->inline_size > 0) {
+                    sch_add_varchar_field_inline(schema, name, pair_ast->inline_size);
+                } else {
+                    sch_add_varchar_field(schema, name);
+                }
                 break;
             case NT_INTEGER:
                 sch_add_int_field(schema, name);
@@ -33,6 +42,10 @@ int create_exec(default_query_args_t* args) {
         }
         temp = (struct list_ast *) list_ast->next;
     }
+    if (SCH_OPTIMIZE_LAYOUT && sch_optimize_layout(schema) == SCHEMA_FAIL) {
+        LOG_ERROR_AND_UPDATE_RESPONSE(args->resp, "Failed to lay out schema");
+        return -1;
+    }
     table_t *table = tab_init(args->db, create_ast->name, schema);
     if (table == NULL) {
         LOG_ERROR_AND_UPDATE_RESPONSE(args->resp, "Failed to create schema");
@@ -41,4 +54,26 @@ int create_exec(default_query_args_t* args) {
     args->resp->status = 0;
     args->resp->message = strdupf("Table %s created successfully", create_ast->name);
     return 0;
+}
+
+int create_index_exec(default_query_args_t* args) {
+    struct create_index_ast *index_ast = (struct create_index_ast *) args->root;
+    int64_t tabix = mtab_find_table_by_name(args->db->meta_table_idx, index_ast->tabname);
+    if (tabix == TABLE_FAIL) {
+        LOG_ERROR_AND_UPDATE_RESPONSE(args->resp, "Failed to find table %s", index_ast->tabname);
+        return -1;
+    }
+    table_t *table = tab_load(tabix);
+    if (table == NULL) {
+        LOG_ERROR_AND_UPDATE_RESPONSE(args->resp, "Failed to load table %s", index_ast->tabname);
+        return -1;
+    }
+    if (tab_create_index(table, index_ast->attr_name, index_ast->hash ? IDX_HASH : IDX_BTREE) == TABLE_FAIL) {
+        LOG_ERROR_AND_UPDATE_RESPONSE(args->resp, "Failed to create index on %s.%s", index_ast->tabname,
+                                      index_ast->attr_name);
+        return -1;
+    }
+    args->resp->status = 0;
+    args->resp->message = strdupf("Index on %s.%s created successfully", index_ast->tabname, index_ast->attr_name);
+    return 0;
 }
\ No newline at end of file
@@ -35,6 +35,17 @@ static void process_update(default_query_args_t *args, row_likedlist_t *row_list
                 field_t field;
                 if (sch_get_field(rst_current->schema, pair->key, &field) != SCHEMA_NOT_FOUND &&
                     field.type == constant_val->type){
+                    if (field.type == DT_VARCHAR) {
+                        /* Inline capacity and dictionary depend on the column, build the slot for it */
+                        void *slot = malloc(field.size);
+                        if (slot != NULL &&
+                            sch_put_varchar(args->db->varchar_mgr_idx, &field, ((struct nstring *) pair->value)->value,
+                                            slot) == SCHEMA_SUCCESS) {
+                            tab_update_field(rst_current->table, rst_current->schema, &rst_current->rowix, &field, slot);
+                        }
+                        free(slot);
+                        continue;
+                    }
                     tab_update_field(rst_current->table, rst_current->schema, &rst_current->rowix, &field, value_ptr);
                 }
             }
@@ -142,6 +153,10 @@ static int process_terminal(db_t *db, schema_t *schema, struct ast *root, struct
                     LOG_ERROR_AND_UPDATE_RESPONSE(resp, "Failed to join");
                     break;
                 }
+                default: {
+                    LOG_ERROR_AND_UPDATE_RESPONSE(resp, "Invalid return type %d", return_value->nodetype);
+                    return -1;
+                }
             }
             break;
         }
@@ -192,10 +207,19 @@ int for_exec(default_query_args_t *args) {
         return -1;
     }
     schema_t *schema = sch_load(table->schidx);
-    hmap_t* hmap = ht_init();
     struct list_ast *temp = (struct list_ast *) for_ast_ptr->nonterm_list_head;
     reverseList(&temp);
-    row_likedlist_t *filtered_list = tab_table2rll(args->db, table);
+    int res = for_pipeline_exec(args->db, for_ast_ptr, temp, table, schema, args->resp);
+    if (res != PIPELINE_UNSUPPORTED) {
+        return res;
+    }
+    hmap_t* hmap = ht_init();
+    bool answered;
+    row_likedlist_t *filtered_list = filter_scan(args->db, temp ? temp->value : NULL, table, schema, &answered);
+    if (answered) {
+        /* The first FILTER is answered by the scan */
+        temp = (struct list_ast *) temp->next;
+    }
     row_likedlist_t *second_rll = NULL;
     while (temp != NULL) {
         struct list_ast *list_ast = (struct list_ast *) temp;
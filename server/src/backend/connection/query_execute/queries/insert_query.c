@@ -68,8 +68,12 @@ int insert_exec(default_query_args_t* args){
                     return -1;
                 }
                 struct nstring *string_val = (struct nstring *) pair_ast->value;
-                vch_ticket_t ticket = vch_add(args->db->varchar_mgr_idx, string_val->value);
-                memcpy(row + fieldi.offset, &ticket, fieldi.size);
+                if (sch_put_varchar(args->db->varchar_mgr_idx, &fieldi, string_val->value,
+                                    row + fieldi.offset) == SCHEMA_FAIL) {
+                    LOG_ERROR_AND_UPDATE_RESPONSE(args->resp, "Failed to store varchar %s", fieldi.name);
+                    free(row);
+                    return -1;
+                }
                 break;
             }
             default: {
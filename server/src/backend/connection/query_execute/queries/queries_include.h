@@ -14,5 +14,6 @@ int for_exec(default_query_args_t *args);
 int drop_exec(default_query_args_t* args);
 int insert_exec(default_query_args_t* args);
 int create_exec(default_query_args_t* args);
+int create_index_exec(default_query_args_t* args);
 
 #endif
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "subqueries_include.h"
 #include "backend/connection/query_execute/utils/constant_value.h"
+#include "backend/table/schema_desc.h"
 
 static row_likedlist_t *simple_condition(db_t *db,
                                          struct filter_expr_ast *root,
@@ -23,6 +24,16 @@ static row_likedlist_t *simple_condition(db_t *db,
             LOG_ERROR_AND_UPDATE_RESPONSE(resp, "Field not found %s", attr_ptr->attr_name);
             return NULL;
         }
+        /*
+         * Equality of two variables is joined with hash table, range with sort and merge,
+         * rows of the range join come in order of the left key instead of the list order
+         */
+        if (condition == COND_EQ) {
+            return rll_hash_join(db, rll, &sel_field, list_1, &sel_field_2);
+        }
+        if (condition != COND_NEQ) {
+            return rll_merge_join(db, rll, &sel_field, condition, list_1, &sel_field_2);
+        }
         row_likedlist_t *filtered_rll = rll_filter_var(db, rll, &sel_field, condition, list_1, &sel_field_2,sel_field_2.type);
         return filtered_rll;
     }
@@ -73,12 +84,404 @@ static row_likedlist_t *complex_condition(db_t *db,
     }
 }
 
+/**
+ * @brief       Check whether every condition of the chain compares field with constant
+ * @param[in]   root: root of conditions tree
+ * @return      true if no condition refers to other variable
+ */
+
+static bool constant_conditions(struct filter_condition_ast *root) {
+    for (struct filter_condition_ast *cond = root; cond != NULL; cond = (struct filter_condition_ast *) cond->r) {
+        if (((struct filter_expr_ast *) cond->l)->constant->nodetype == NT_ATTR_NAME) {
+            return false;
+        }
+        if (cond->logic == -1) {
+            break;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief       Mark rows of list matching condition with constant
+ * @param[in]   db: pointer to db
+ * @param[in]   root: the condition
+ * @param[in]   rll: list of rows
+ * @param[in]   schema: schema of rows
+ * @param[in]   resp: response to report errors to
+ * @return      bitmap of positions of matching rows on success, NULL on failure
+ */
+
+static uint64_t *bitmap_condition(db_t *db, struct filter_expr_ast *root, row_likedlist_t *rll, schema_t *schema,
+                                  struct response *resp) {
+    struct attr_name_ast *attr_ptr = (struct attr_name_ast *) root->attr_name;
+    field_t sel_field;
+    if (sch_get_field(schema, attr_ptr->attr_name, &sel_field) == SCHEMA_NOT_FOUND) {
+        LOG_ERROR_AND_UPDATE_RESPONSE(resp, "Field not found %s", attr_ptr->attr_name);
+        return NULL;
+    }
+    struct constant_val *constant_val = init_constant(db, root->constant);
+    if (constant_val == NULL) {
+        logger(LL_ERROR, __func__, "Failed to get constant");
+        return NULL;
+    }
+    if (sel_field.type != constant_val->type) {
+        LOG_ERROR_AND_UPDATE_RESPONSE(resp, "Invalid field type %d", constant_val->type);
+        free(constant_val);
+        return NULL;
+    }
+    uint64_t *bits = malloc(rll_bitmap_words(rll->size) * sizeof(uint64_t) + sizeof(uint64_t));
+    if (bits == NULL) {
+        logger(LL_ERROR, __func__, "Failed to allocate bitmap of %d rows", rll->size);
+    } else {
+        rll_filter_bits(db, rll, &sel_field, get_condition_type(root->cmp),
+                        GET_VALUE_PTR(constant_val, constant_val->type), bits);
+    }
+    free(constant_val);
+    return bits;
+}
+
+/**
+ * @brief       Mark rows of list matching chain of conditions with constants
+ * @param[in]   db: pointer to db
+ * @param[in]   root: root of conditions tree
+ * @param[in]   rll: list of rows
+ * @param[in]   schema: schema of rows
+ * @param[in]   resp: response to report errors to
+ * @return      bitmap of positions of matching rows on success, NULL on failure
+ * @note        joins bitmaps as complex_condition joins lists, each row is tested once per condition
+ */
+
+static uint64_t *bitmap_chain(db_t *db, struct filter_condition_ast *root, row_likedlist_t *rll, schema_t *schema,
+                              struct response *resp) {
+    uint64_t *bits = bitmap_condition(db, (struct filter_expr_ast *) root->l, rll, schema, resp);
+    if (bits == NULL || root->r == NULL || root->logic == -1) {
+        return bits;
+    }
+    uint64_t *rest = bitmap_chain(db, (struct filter_condition_ast *) root->r, rll, schema, resp);
+    if (rest == NULL || (root->logic != NT_AND && root->logic != NT_OR)) {
+        free(bits);
+        free(rest);
+        return NULL;
+    }
+    for (int64_t i = 0; i < rll_bitmap_words(rll->size); i++) {
+        bits[i] = root->logic == NT_AND ? bits[i] & rest[i] : bits[i] | rest[i];
+    }
+    free(rest);
+    return bits;
+}
+
+/**
+ * @brief       Find condition with constant on indexed field that every row of filter must match
+ * @param[in]   schema: schema of rows
+ * @param[in]   root: root of conditions tree
+ * @param[out]  field: indexed field
+ * @return      condition on success, NULL if there is no such condition
+ */
+
+static struct filter_expr_ast *indexed_condition(schema_t *schema, struct filter_condition_ast *root, field_t *field) {
+    sch_desc_t *desc = sch_desc_load(schema_index(schema));
+    if (desc == NULL) {
+        return NULL;
+    }
+    /* Left condition of OR is optional, right subtree of AND is required as a whole */
+    for (struct filter_condition_ast *cond = root; cond != NULL; cond = (struct filter_condition_ast *) cond->r) {
+        struct filter_expr_ast *expr = (struct filter_expr_ast *) cond->l;
+        if (cond->logic != NT_OR && expr->constant->nodetype != NT_ATTR_NAME) {
+            field_t *found = sch_desc_field(desc, ((struct attr_name_ast *) expr->attr_name)->attr_name);
+            if (found != NULL && sch_is_indexed_field(found) &&
+                idx_supports(found->index_kind, get_condition_type(expr->cmp))) {
+                *field = *found;
+                return expr;
+            }
+        }
+        if (cond->logic != NT_AND) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief       Evaluate compiled chain
+ * @param[in]   pred: compiled chain
+ * @param[in]   row: row of the table
+ * @return      true if the row matches the chain
+ * @note        chain leans right, so it is decided by the first leaf which is false before AND
+ *              or true before OR, and by the last leaf otherwise
+ */
+
+static bool scan_pred_eval(scan_pred_t *pred, char *row) {
+    for (scan_leaf_t *leaf = pred->leaves; leaf < pred->leaves + pred->count; leaf++) {
+        bool res = comp_pred_test(&leaf->pred, row + leaf->field.offset);
+        if (leaf->logic == NT_AND ? !res : leaf->logic != NT_OR || res) {
+            return res;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief       Check row against compiled chain, predicate of scan
+ * @param[in]   row: row of the table
+ * @param[in]   arg: compiled chain
+ * @return      true if the row matches the chain
+ */
+
+bool scan_pred_test(void *row, void *arg) {
+    scan_pred_t *pred = arg;
+    return pred->jit ? jit_test(pred->jit, row) : scan_pred_eval(pred, row);
+}
+
+/**
+ * @brief       Free compiled chain
+ * @param[in]   pred: compiled chain
+ */
+
+void scan_pred_free(scan_pred_t *pred) {
+    for (int64_t i = 0; i < pred->count; i++) {
+        free(pred->leaves[i].constant);
+    }
+    free(pred->leaves);
+    jit_free(pred->jit);
+    pred->leaves = NULL;
+    pred->jit = NULL;
+    pred->count = 0;
+}
+
+/**
+ * @brief       Check if compiled chain is conjunction of comparisons of int and float fields
+ * @param[in]   pred: compiled chain
+ * @return      true if the chain can be checked by comparing columns of batches
+ */
+
+bool scan_pred_vectorizable(scan_pred_t *pred) {
+    for (int64_t i = 0; i < pred->count; i++) {
+        scan_leaf_t *leaf = &pred->leaves[i];
+        if (leaf->logic == NT_OR || (leaf->field.type != DT_INT && leaf->field.type != DT_FLOAT)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief       Compile chain to native code when JIT is enabled
+ * @param[in]   pred: compiled chain
+ * @note        chain without native code is interpreted
+ */
+
+static void scan_pred_jit(scan_pred_t *pred) {
+    if (!jit_enabled() || pred->count == 0) {
+        return;
+    }
+    jit_leaf_t *leaves = malloc(pred->count * sizeof(jit_leaf_t));
+    if (leaves == NULL) {
+        return;
+    }
+    for (int64_t i = 0; i < pred->count; i++) {
+        leaves[i].offset = (int64_t) pred->leaves[i].field.offset;
+        leaves[i].pred = &pred->leaves[i].pred;
+        leaves[i].logic = pred->leaves[i].logic == NT_AND ? JIT_AND : pred->leaves[i].logic == NT_OR ? JIT_OR : JIT_LAST;
+    }
+    pred->jit = jit_compile(leaves, pred->count);
+    free(leaves);
+}
+
+/**
+ * @brief       Compile conditions of FILTER to predicates on rows of table
+ * @param[in]   db: pointer to db
+ * @param[in]   schema: schema of rows
+ * @param[in]   root: root of conditions tree
+ * @param[out]  pred: compiled chain, empty when no condition can be checked in the scan
+ * @return      true if the chain is the whole FILTER, false if it has only conditions every row must match
+ * @note        condition on other variable or with constant of other type is left to filter_exec
+ */
+
+bool scan_pred_compile(db_t *db, schema_t *schema, struct filter_condition_ast *root, scan_pred_t *pred) {
+    pred->count = 0;
+    pred->leaves = NULL;
+    pred->jit = NULL;
+    int64_t total = 0;
+    for (struct filter_condition_ast *cond = root; cond != NULL; cond = (struct filter_condition_ast *) cond->r) {
+        total++;
+        if (cond->r == NULL || cond->logic == -1) {
+            break;
+        }
+    }
+    pred->leaves = malloc(total * sizeof(scan_leaf_t));
+    sch_desc_t *desc = sch_desc_load(schema_index(schema));
+    if (pred->leaves == NULL || desc == NULL) {
+        free(pred->leaves);
+        pred->leaves = NULL;
+        return false;
+    }
+
+    bool complete = true;
+    bool required = true;
+    struct filter_condition_ast *cond = root;
+    for (int64_t i = 0; i < total; i++, cond = (struct filter_condition_ast *) cond->r) {
+        struct filter_expr_ast *expr = (struct filter_expr_ast *) cond->l;
+        int logic = i + 1 < total ? cond->logic : -1;
+        field_t *field = sch_desc_field(desc, ((struct attr_name_ast *) expr->attr_name)->attr_name);
+        struct constant_val *constant =
+                field != NULL && expr->constant->nodetype != NT_ATTR_NAME ? init_constant(db, expr->constant) : NULL;
+        if (constant != NULL && constant->type == field->type) {
+            scan_leaf_t *leaf = &pred->leaves[pred->count++];
+            leaf->field = *field;
+            leaf->constant = constant;
+            leaf->cond = get_condition_type(expr->cmp);
+            leaf->logic = logic;
+            /* Left condition of OR is optional, right subtree of AND is required as a whole */
+            leaf->required = required && logic != NT_OR;
+        } else {
+            free(constant);
+            complete = false;
+        }
+        required = required && logic == NT_AND;
+    }
+    if (!complete) {
+        /* Only conditions every row must match are left, they are joined with AND */
+        int64_t count = 0;
+        for (int64_t i = 0; i < pred->count; i++) {
+            if (pred->leaves[i].required) {
+                pred->leaves[count++] = pred->leaves[i];
+            } else {
+                free(pred->leaves[i].constant);
+            }
+        }
+        pred->count = count;
+        for (int64_t i = 0; i < count; i++) {
+            pred->leaves[i].logic = i + 1 < count ? NT_AND : -1;
+        }
+    }
+    /* Leaves do not move anymore, predicates may point into them */
+    for (int64_t i = 0; i < pred->count; i++) {
+        scan_leaf_t *leaf = &pred->leaves[i];
+        comp_pred_init(&leaf->pred, db, &leaf->field, leaf->cond, GET_VALUE_PTR(leaf->constant, leaf->constant->type));
+    }
+    scan_pred_jit(pred);
+    return complete;
+}
+
+/**
+ * @brief       Read rows of table the first statement of FOR starts from
+ * @param[in]   db: pointer to db
+ * @param[in]   first: first statement of FOR or NULL
+ * @param[in]   table: pointer to the table
+ * @param[in]   schema: pointer to the schema
+ * @param[out]  answered: true if the statement is FILTER answered completely by the scan
+ * @return      rows matching conditions of FILTER the scan can check, found through index when
+ *              one of them is on indexed field, all rows when the statement is not FILTER
+ * @note        FILTER which is not answered is still applied to the rows, the scan only narrows them
+ */
+
+row_likedlist_t *filter_scan(db_t *db, struct ast *first, table_t *table, schema_t *schema, bool *answered) {
+    *answered = false;
+    if (first == NULL || first->nodetype != NT_FILTER) {
+        return tab_table2rll(db, table);
+    }
+    struct filter_condition_ast *root =
+            (struct filter_condition_ast *) ((struct filter_ast *) first)->conditions_tree_root;
+    scan_pred_t pred;
+    bool complete = scan_pred_compile(db, schema, root, &pred);
+
+    row_likedlist_t *list = NULL;
+    field_t field;
+    struct filter_expr_ast *expr = indexed_condition(schema, root, &field);
+    struct constant_val *constant_val = expr != NULL ? init_constant(db, expr->constant) : NULL;
+    if (constant_val != NULL && constant_val->type == field.type) {
+        list = tab_index_filter(db, table, schema, &field, get_condition_type(expr->cmp),
+                                GET_VALUE_PTR(constant_val, constant_val->type));
+    }
+    free(constant_val);
+    if (list != NULL) {
+        for (row_node_t *node = list->head; node != NULL && pred.count > 0;) {
+            row_node_t *next = node->next;
+            if (!scan_pred_test(node->row, &pred)) {
+                row_likedlist_remove(list, node);
+            }
+            node = next;
+        }
+    } else {
+        list = tab_scan(db, table, pred.count > 0 ? scan_pred_test : NULL, &pred);
+    }
+    *answered = complete && list != NULL;
+    scan_pred_free(&pred);
+    return list;
+}
+
+/**
+ * @brief       Check if filter_scan reads rows of FILTER through index
+ * @param[in]   first: first statement of FOR or NULL
+ * @param[in]   schema: pointer to the schema
+ * @return      true if the statement is FILTER with condition index of its field can answer
+ */
+
+bool filter_uses_index(struct ast *first, schema_t *schema) {
+    if (first == NULL || first->nodetype != NT_FILTER) {
+        return false;
+    }
+    field_t field;
+    return indexed_condition(schema, (struct filter_condition_ast *) ((struct filter_ast *) first)->conditions_tree_root,
+                             &field) != NULL;
+}
+
+/**
+ * @brief       Answer the first FILTER of nested FOR with index nested-loop join, through index of
+ *              the column or its cached join index
+ * @param[in]   db: pointer to db
+ * @param[in]   first: first statement of FOR or NULL
+ * @param[in]   table: pointer to the table of nested FOR
+ * @param[in]   schema: pointer to the schema
+ * @param[in]   list_1: rows of the outer FOR or NULL
+ * @return      joined rows when the statement is FILTER of single equality of field with field
+ *              of the outer rows, NULL otherwise
+ * @note        the statement is answered completely and must not be executed again
+ */
+
+row_likedlist_t *filter_index_join(db_t *db, struct ast *first, table_t *table, schema_t *schema, row_likedlist_t *list_1) {
+    if (first == NULL || first->nodetype != NT_FILTER || list_1 == NULL) {
+        return NULL;
+    }
+    struct filter_condition_ast *cond =
+            (struct filter_condition_ast *) ((struct filter_ast *) first)->conditions_tree_root;
+    if (cond->r != NULL && cond->logic != -1) {
+        return NULL;
+    }
+    struct filter_expr_ast *expr = (struct filter_expr_ast *) cond->l;
+    if (expr->constant->nodetype != NT_ATTR_NAME || get_condition_type(expr->cmp) != COND_EQ) {
+        return NULL;
+    }
+    field_t field;
+    field_t outer_field;
+    if (sch_get_field(schema, ((struct attr_name_ast *) expr->attr_name)->attr_name, &field) != SCHEMA_SUCCESS ||
+        sch_get_field(list_1->schema, ((struct attr_name_ast *) expr->constant)->attr_name, &outer_field) != SCHEMA_SUCCESS ||
+        field.type != outer_field.type) {
+        return NULL;
+    }
+    if (sch_is_indexed_field(&field)) {
+        return tab_index_join(db, table, schema, &field, list_1, &outer_field);
+    }
+    return tab_cached_join(db, table, schema, &field, list_1, &outer_field);
+}
+
 row_likedlist_t *
 filter_exec(db_t *db, struct ast *root, row_likedlist_t *rll, schema_t *schema, struct response *resp, row_likedlist_t* list_1) {
     row_likedlist_t *result_list = rll;
     struct filter_ast *filter_ast_ptr = (struct filter_ast *) root;
     struct filter_condition_ast *condition_ast_ptr = (struct filter_condition_ast *) filter_ast_ptr->conditions_tree_root;
-    if (condition_ast_ptr->r != NULL && condition_ast_ptr->logic != -1) {
+    if (condition_ast_ptr->r != NULL && condition_ast_ptr->logic != -1 && constant_conditions(condition_ast_ptr) &&
+        rll_unique_rowix(rll)) {
+        /*
+         * Rows are copied once, after conditions are joined on their bitmaps, and keep the order of the list
+         * where complex_condition puts rows matching only the right side of OR last. Rows sharing the first
+         * source row are paired by rll_join_and and merged by rll_join_or, so they are left to complex_condition
+         */
+        uint64_t *bits = bitmap_chain(db, condition_ast_ptr, rll, schema, resp);
+        result_list = bits != NULL ? rll_select_bits(rll, bits) : NULL;
+        free(bits);
+    } else if (condition_ast_ptr->r != NULL && condition_ast_ptr->logic != -1) {
         result_list = complex_condition(db, condition_ast_ptr, rll, schema, resp, list_1);
     } else {
         result_list = simple_condition(db, (struct filter_expr_ast *) condition_ast_ptr->l, rll, schema, resp, list_1);
@@ -16,7 +16,17 @@ row_likedlist_t *for_stmt_exec(db_t *db, struct ast *root, struct response *resp
     schema_t *schema = sch_load(table->schidx);
     struct list_ast *temp = (struct list_ast *) for_ast_ptr->nonterm_list_head;
     reverseList(&temp);
-    row_likedlist_t *filtered_list = tab_table2rll(db, table);
+    bool answered = false;
+    row_likedlist_t *filtered_list = filter_index_join(db, temp ? temp->value : NULL, table, schema, list_1);
+    if (filtered_list != NULL) {
+        answered = true;
+    } else {
+        filtered_list = filter_scan(db, temp ? temp->value : NULL, table, schema, &answered);
+    }
+    if (answered) {
+        /* The first FILTER is answered by the join or the scan */
+        temp = (struct list_ast *) temp->next;
+    }
     char* variable = for_ast_ptr->var;
     while (temp != NULL) {
         struct list_ast *list_ast = (struct list_ast *) temp;
@@ -0,0 +1,368 @@
+#include "subqueries_include.h"
+
+/**
+ * Plan of FOR built from operators. Compiled FILTERs are arguments of scans
+ * and filters of the plan, so they live as long as the plan does.
+ */
+
+typedef struct for_plan {
+    int64_t count;
+    int64_t capacity;
+    scan_pred_t **preds;
+    operator_t *root;
+} for_plan_t;
+
+static bool pipeline_on = PIPELINE_DEFAULT_ENABLED;
+
+/**
+ * @brief       Check whether FOR is executed through operators when it can be
+ * @return      true if the pipeline is enabled
+ */
+
+bool pipeline_enabled(void) {
+    return pipeline_on;
+}
+
+/**
+ * @brief       Enable or disable execution of FOR through operators
+ * @param[in]   enabled: requested state
+ * @return      previous state
+ * @note        disabled pipeline leaves every FOR to row lists
+ */
+
+bool pipeline_set_enabled(bool enabled) {
+    bool previous = pipeline_on;
+    pipeline_on = enabled;
+    return previous;
+}
+
+/**
+ * @brief       Free plan with its operators and compiled FILTERs
+ * @param[in]   plan: pointer to the plan
+ */
+
+static void plan_free(for_plan_t *plan) {
+    op_free(plan->root);
+    for (int64_t i = 0; i < plan->count; i++) {
+        scan_pred_free(plan->preds[i]);
+        free(plan->preds[i]);
+    }
+    free(plan->preds);
+}
+
+/**
+ * @brief       Compile FILTER the plan checks
+ * @param[in]   db: pointer to db
+ * @param[in]   schema: schema of rows
+ * @param[in]   filter: FILTER statement
+ * @param[in]   plan: pointer to the plan
+ * @return      compiled FILTER on success, NULL if some of its conditions can not be compiled
+ */
+
+static scan_pred_t *plan_add_filter(db_t *db, schema_t *schema, struct ast *filter, for_plan_t *plan) {
+    if (plan->count == plan->capacity) {
+        int64_t capacity = plan->capacity ? 2 * plan->capacity : 4;
+        scan_pred_t **preds = realloc(plan->preds, capacity * sizeof(scan_pred_t *));
+        if (preds == NULL) {
+            return NULL;
+        }
+        plan->preds = preds;
+        plan->capacity = capacity;
+    }
+    scan_pred_t *pred = malloc(sizeof(scan_pred_t));
+    if (pred == NULL) {
+        return NULL;
+    }
+    struct filter_condition_ast *root =
+            (struct filter_condition_ast *) ((struct filter_ast *) filter)->conditions_tree_root;
+    if (!scan_pred_compile(db, schema, root, pred) || pred->count == 0) {
+        scan_pred_free(pred);
+        free(pred);
+        return NULL;
+    }
+    plan->preds[plan->count++] = pred;
+    return pred;
+}
+
+/**
+ * @brief       Add filter of compiled FILTER to plan
+ * @param[in]   db: pointer to db
+ * @param[in]   op: operator handing out rows, it is freed on failure
+ * @param[in]   pred: compiled FILTER
+ * @return      pointer to the operator on success, NULL on failure
+ * @note        conjunction of int and float comparisons becomes column comparisons, others are checked by rows
+ */
+
+static operator_t *plan_filter(db_t *db, operator_t *op, scan_pred_t *pred) {
+    if (!scan_pred_vectorizable(pred)) {
+        operator_t *filter = op_filter_init(op, scan_pred_test, pred);
+        if (filter == NULL) {
+            op_free(op);
+        }
+        return filter;
+    }
+    for (int64_t i = 0; i < pred->count && op != NULL; i++) {
+        scan_leaf_t *leaf = &pred->leaves[i];
+        operator_t *compare = op_compare_init(db, op, &leaf->field, leaf->cond, leaf->pred.value);
+        if (compare == NULL) {
+            op_free(op);
+        }
+        op = compare;
+    }
+    return op;
+}
+
+/**
+ * @brief       Build scan of table with FILTERs on its rows
+ * @param[in]   db: pointer to db
+ * @param[in]   table: pointer to the table
+ * @param[in]   schema: pointer to the schema
+ * @param[in]   filters: FILTER statements in order of execution
+ * @param[in]   count: number of FILTERs
+ * @param[in]   plan: pointer to the plan
+ * @return      pointer to the operator on success, NULL if FILTERs can not be compiled
+ * @note        the first FILTER which can not be compared by columns is checked by the scan
+ */
+
+static operator_t *plan_scan(db_t *db, table_t *table, schema_t *schema, struct ast **filters, int64_t count,
+                             for_plan_t *plan) {
+    int64_t first = plan->count;
+    for (int64_t i = 0; i < count; i++) {
+        if (plan_add_filter(db, schema, filters[i], plan) == NULL) {
+            return NULL;
+        }
+    }
+    scan_pred_t **preds = &plan->preds[first];
+    bool pushed = count > 0 && !scan_pred_vectorizable(preds[0]);
+    operator_t *op = op_scan_init(table, pushed ? scan_pred_test : NULL, pushed ? preds[0] : NULL);
+    for (int64_t i = pushed ? 1 : 0; i < count && op != NULL; i++) {
+        op = plan_filter(db, op, preds[i]);
+    }
+    return op;
+}
+
+/**
+ * @brief       Get statements of list in order of execution
+ * @param[in]   head: head of the list in order of parsing
+ * @param[out]  count: number of statements
+ * @return      array of statements on success, NULL on failure or when the list is empty
+ * @note        the list is not reversed in place, FOR falling back to row lists reverses it itself
+ */
+
+static struct ast **plan_statements(struct list_ast *head, int64_t *count) {
+    *count = 0;
+    for (struct list_ast *node = head; node != NULL; node = (struct list_ast *) node->next) {
+        (*count)++;
+    }
+    struct ast **statements = *count > 0 ? malloc(*count * sizeof(struct ast *)) : NULL;
+    int64_t i = *count;
+    for (struct list_ast *node = head; node != NULL && statements != NULL; node = (struct list_ast *) node->next) {
+        statements[--i] = node->value;
+    }
+    return statements;
+}
+
+/**
+ * @brief       Check if FILTER is single equality of field with field of the outer variable
+ * @param[in]   filter: FILTER statement
+ * @param[in]   variable: the outer variable
+ * @return      the equality on success, NULL otherwise
+ */
+
+static struct filter_expr_ast *plan_join_condition(struct ast *filter, const char *variable) {
+    struct filter_condition_ast *cond =
+            (struct filter_condition_ast *) ((struct filter_ast *) filter)->conditions_tree_root;
+    if (cond->r != NULL && cond->logic != -1) {
+        return NULL;
+    }
+    struct filter_expr_ast *expr = (struct filter_expr_ast *) cond->l;
+    if (expr->constant->nodetype != NT_ATTR_NAME || get_condition_type(expr->cmp) != COND_EQ ||
+        strcmp(((struct attr_name_ast *) expr->constant)->variable, variable) != 0) {
+        return NULL;
+    }
+    return expr;
+}
+
+/**
+ * @brief       Build hash join of rows of the outer FOR with rows of nested FOR
+ * @param[in]   db: pointer to db
+ * @param[in]   outer: operator handing out the outer rows
+ * @param[in]   variable: the outer variable
+ * @param[in]   nested: nested FOR
+ * @param[in]   plan: pointer to the plan
+ * @return      pointer to the operator on success, NULL if nested FOR is not FILTERs with one join equality
+ * @note        FILTERs with constants are checked on the nested rows before they are joined
+ */
+
+static operator_t *plan_join(db_t *db, operator_t *outer, const char *variable, struct for_ast *nested,
+                             for_plan_t *plan) {
+    int64_t tabix = mtab_find_table_by_name(db->meta_table_idx, nested->tabname);
+    table_t *table = tabix != TABLE_FAIL ? tab_load(tabix) : NULL;
+    if (table == NULL) {
+        return NULL;
+    }
+    schema_t *schema = sch_load(table->schidx);
+    int64_t count;
+    struct ast **statements = plan_statements((struct list_ast *) nested->nonterm_list_head, &count);
+    if (statements == NULL) {
+        return NULL;
+    }
+    struct filter_expr_ast *join = NULL;
+    int64_t filters = 0;
+    for (int64_t i = 0; i < count; i++) {
+        if (statements[i]->nodetype != NT_FILTER) {
+            free(statements);
+            return NULL;
+        }
+        struct filter_expr_ast *expr = plan_join_condition(statements[i], variable);
+        if (expr != NULL && join == NULL) {
+            join = expr;
+        } else {
+            statements[filters++] = statements[i];
+        }
+    }
+    field_t field;
+    field_t outer_field;
+    if (join == NULL ||
+        sch_get_field(schema, ((struct attr_name_ast *) join->attr_name)->attr_name, &field) != SCHEMA_SUCCESS ||
+        sch_get_field(outer->schema, ((struct attr_name_ast *) join->constant)->attr_name, &outer_field) != SCHEMA_SUCCESS ||
+        field.type != outer_field.type) {
+        free(statements);
+        return NULL;
+    }
+    operator_t *inner = plan_scan(db, table, schema, statements, filters, plan);
+    free(statements);
+    if (inner == NULL) {
+        return NULL;
+    }
+    operator_t *op = op_hash_join_init(db, outer, &outer_field, inner, &field);
+    if (op == NULL) {
+        op_free(inner);
+    }
+    return op;
+}
+
+/**
+ * @brief       Build projection of joined rows on fields of MERGE
+ * @param[in]   op: operator handing out joined rows
+ * @param[in]   merge: MERGE of fields
+ * @param[in]   resp: pointer to the response
+ * @return      pointer to the operator on success, NULL on failure
+ */
+
+static operator_t *plan_project(operator_t *op, struct merge_projections_ast *merge, struct response *resp) {
+    int64_t count;
+    struct ast **attrs = plan_statements((struct list_ast *) merge->list, &count);
+    field_t *fields = malloc(count * sizeof(field_t));
+    if (attrs == NULL || fields == NULL) {
+        free(attrs);
+        free(fields);
+        LOG_ERROR_AND_UPDATE_RESPONSE(resp, "Failed to project");
+        return NULL;
+    }
+    for (int64_t i = 0; i < count; i++) {
+        char *field_name = ((struct attr_name_ast *) attrs[i])->attr_name;
+        if (sch_get_field(op->schema, field_name, &fields[i]) == SCHEMA_NOT_FOUND) {
+            LOG_ERROR_AND_UPDATE_RESPONSE(resp, "Field not found %s", field_name);
+            free(attrs);
+            free(fields);
+            return NULL;
+        }
+    }
+    operator_t *project = op_project_init(op, fields, count);
+    free(attrs);
+    free(fields);
+    if (project == NULL) {
+        LOG_ERROR_AND_UPDATE_RESPONSE(resp, "Failed to project");
+    }
+    return project;
+}
+
+/**
+ * @brief       Execute FOR reading rows through operators instead of row lists
+ * @param[in]   db: pointer to db
+ * @param[in]   for_ast_ptr: FOR
+ * @param[in]   statements: statements of FOR in order of execution
+ * @param[in]   table: pointer to the table of FOR
+ * @param[in]   schema: pointer to the schema
+ * @param[in]   resp: pointer to the response
+ * @return      0 on success, -1 on failure, PIPELINE_UNSUPPORTED when FOR must be executed with row lists
+ *              or the pipeline is disabled
+ * @note        FOR of FILTERs with constants optionally followed by nested FOR joined on equality and
+ *              returning rows is supported, REMOVE and UPDATE need rows of tables behind the result
+ */
+
+int for_pipeline_exec(db_t *db, struct for_ast *for_ast_ptr, struct list_ast *statements, table_t *table,
+                      schema_t *schema, struct response *resp) {
+    if (!pipeline_on) {
+        return PIPELINE_UNSUPPORTED;
+    }
+    int64_t count = 0;
+    struct ast *nested = NULL;
+    for (struct list_ast *node = statements; node != NULL; node = (struct list_ast *) node->next) {
+        if (nested != NULL || (node->value->nodetype != NT_FILTER && node->value->nodetype != NT_FOR)) {
+            return PIPELINE_UNSUPPORTED;
+        }
+        if (node->value->nodetype == NT_FOR) {
+            nested = node->value;
+        } else {
+            count++;
+        }
+    }
+    struct ast *terminal = for_ast_ptr->terminal;
+    if (terminal->nodetype != NT_RETURN) {
+        return PIPELINE_UNSUPPORTED;
+    }
+    struct ast *value = ((struct return_ast *) terminal)->value;
+    bool returns_outer = value->nodetype == NT_ATTR_NAME &&
+                         strcmp(((struct attr_name_ast *) value)->variable, for_ast_ptr->var) == 0;
+    if ((nested == NULL) != returns_outer) {
+        return PIPELINE_UNSUPPORTED;
+    }
+    /* Index reads fewer rows than the scan does */
+    if (filter_uses_index(statements != NULL ? statements->value : NULL, schema)) {
+        return PIPELINE_UNSUPPORTED;
+    }
+
+    struct ast **filters = malloc((count + 1) * sizeof(struct ast *));
+    if (filters == NULL) {
+        return PIPELINE_UNSUPPORTED;
+    }
+    count = 0;
+    for (struct list_ast *node = statements; node != NULL && node->value != nested; node = (struct list_ast *) node->next) {
+        filters[count++] = node->value;
+    }
+    for_plan_t plan = {0};
+    plan.root = plan_scan(db, table, schema, filters, count, &plan);
+    free(filters);
+    if (plan.root != NULL && nested != NULL) {
+        operator_t *join = plan_join(db, plan.root, for_ast_ptr->var, (struct for_ast *) nested, &plan);
+        if (join == NULL) {
+            op_free(plan.root);
+        }
+        plan.root = join;
+    }
+    if (plan.root == NULL) {
+        plan_free(&plan);
+        return PIPELINE_UNSUPPORTED;
+    }
+    if (value->nodetype == NT_MERGE_PROJECTIONS) {
+        operator_t *project = plan_project(plan.root, (struct merge_projections_ast *) value, resp);
+        if (project == NULL) {
+            plan_free(&plan);
+            return -1;
+        }
+        plan.root = project;
+    }
+
+    table_t *result = tab_op2table(db, plan.root, "TEMP");
+    plan_free(&plan);
+    if (result == NULL) {
+        LOG_ERROR_AND_UPDATE_RESPONSE(resp, "Failed to select");
+        return -1;
+    }
+    tab_print(db, result, sch_load(result->schidx));
+    set_response(resp, 0, "Selected successfully");
+    resp->table = result;
+    return 0;
+}
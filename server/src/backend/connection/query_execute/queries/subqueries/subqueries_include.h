@@ -3,7 +3,49 @@
 
 #include "backend/connection/query_execute/utils/exe_utils.h"
 #include "utils/hashtable.h"
+#include "backend/table/operator.h"
+#include "backend/comparator/jit.h"
+
+/**
+ * Conditions of FILTER compiled for the scan of table: predicates on fields
+ * of rows in the order of the chain, each joined to the rest of the chain
+ * with its logic as complex_condition does it. Chain is also compiled to
+ * native code when JIT is enabled.
+ */
+
+typedef struct scan_leaf {
+    field_t field;
+    comp_pred_t pred;
+    struct constant_val *constant;
+    condition_t cond;
+    int logic; //NT_AND or NT_OR with the rest of the chain, -1 for the last leaf
+    bool required; //every row matching the chain matches the leaf
+} scan_leaf_t;
+
+typedef struct scan_pred {
+    int64_t count;
+    scan_leaf_t *leaves;
+    jit_code_t *jit; //native code of the chain or NULL
+} scan_pred_t;
+
+/* Returned by for_pipeline_exec when the query needs row lists */
+#define PIPELINE_UNSUPPORTED 1
+
+#ifndef PIPELINE_DEFAULT_ENABLED
+#define PIPELINE_DEFAULT_ENABLED true
+#endif
 
 row_likedlist_t *filter_exec(db_t *db, struct ast *root, row_likedlist_t *rll, schema_t *schema, struct response *resp,  row_likedlist_t* list_1);
+row_likedlist_t *filter_scan(db_t *db, struct ast *first, table_t *table, schema_t *schema, bool *answered);
+row_likedlist_t *filter_index_join(db_t *db, struct ast *first, table_t *table, schema_t *schema, row_likedlist_t *list_1);
+bool filter_uses_index(struct ast *first, schema_t *schema);
+bool scan_pred_compile(db_t *db, schema_t *schema, struct filter_condition_ast *root, scan_pred_t *pred);
+bool scan_pred_test(void *row, void *arg);
+bool scan_pred_vectorizable(scan_pred_t *pred);
+void scan_pred_free(scan_pred_t *pred);
 row_likedlist_t *for_stmt_exec(db_t *db, struct ast *root, struct response *resp, hmap_t* hmap, row_likedlist_t* list_1);
+bool pipeline_enabled(void);
+bool pipeline_set_enabled(bool enabled);
+int for_pipeline_exec(db_t *db, struct for_ast *for_ast_ptr, struct list_ast *statements, table_t *table,
+                      schema_t *schema, struct response *resp);
 #endif
\ No newline at end of file
@@ -19,13 +19,20 @@ int reqexe(db_t *db, struct ast *root, struct response *resp) {
             break;
         }
         case NT_FOR: {
+            /* Intermediate schemas and results go to temp space */
+            int space = pg_use_space(PG_TEMP);
             for_exec(&args);
+            pg_use_space(space);
             break;
         }
         case NT_DROP: {
             drop_exec(&args);
             break;
         }
+        case NT_CREATE_INDEX: {
+            create_index_exec(&args);
+            break;
+        }
         default: {
             LOG_ERROR_AND_UPDATE_RESPONSE(resp, "Invalid root type %d", root->nodetype);
             return -1;
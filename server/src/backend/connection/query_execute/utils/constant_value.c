@@ -26,7 +26,8 @@ struct constant_val *init_constant(db_t *db, struct ast *constant) {
             constant_val->bool_val = ((struct nint *) constant)->value;
             break;
         case DT_VARCHAR:
-            constant_val->varchar_val = vch_add(db->varchar_mgr_idx, ((struct nstring *) constant)->value);
+            /* Constants live while the query runs, they are not stored in varchar pool */
+            constant_val->varchar_val = vch_transient(((struct nstring *) constant)->value);
             break;
         default:
             logger(LL_ERROR, __func__, "Invalid constant type %d", constant->nodetype);
@@ -1,4 +1,6 @@
 #include "xml.h"
+#include "backend/journal/lob_store.h"
+#include "backend/table/schema_desc.h"
 
 #include <libxml/parser.h>
 #include <libxml/tree.h>
@@ -91,12 +93,20 @@ struct ast *xml2ast(xmlNode *node) {
     } else if (!xmlStrcmp(node->name, BAD_CAST "drop")) {
         char *tabname = (char *) xmlGetProp(node, BAD_CAST "tabname");
         ast_node = newdrop(tabname);
+    } else if (!xmlStrcmp(node->name, BAD_CAST "create_index")) {
+        char *tabname = (char *) xmlGetProp(node, BAD_CAST "tabname");
+        char *attribute = (char *) xmlGetProp(node, BAD_CAST "attribute");
+        xmlChar *method = xmlGetProp(node, BAD_CAST "method");
+        ast_node = newcreate_index(tabname, attribute, method != NULL && !xmlStrcmp(method, BAD_CAST "hash"));
+        xmlFree(method);
     } else if (!xmlStrcmp(node->name, BAD_CAST "list")) {
         ast_node = get_list(node);
     } else if (!xmlStrcmp(node->name, BAD_CAST "definition")) {
         char *name = (char *) xmlGetProp(node, BAD_CAST "name");
         char *type = (char *) xmlGetProp(node, BAD_CAST "type");
-        ast_node = newcreate_pair(name, str_to_ntype(type));
+        xmlChar *inline_size = xmlGetProp(node, BAD_CAST "inline");
+        ast_node = newcreate_pair(name, str_to_ntype(type), inline_size != NULL ? atoi((char *) inline_size) : 0);
+        xmlFree(inline_size);
     } else if (!xmlStrcmp(node->name, BAD_CAST "pair")) {
         char *key = (char *) xmlGetProp(node, BAD_CAST "key");
         struct ast *ast_value = xml2ast(get_child(node));
@@ -189,6 +199,32 @@ struct ast *parse_xml_to_ast(const char *xml_content) {
     return ast_root;
 }
 
+/**
+ * @brief       Create element with content of large object, streaming it page by page
+ * @param[in]   parent: parent node
+ * @param[in]   vch: ticket of varchar stored in large object store
+ * @return      created node
+ */
+
+static xmlNodePtr xml_new_lob_child(xmlNodePtr parent, vch_ticket_t *vch) {
+    xmlNodePtr element_node = xmlNewChild(parent, NULL, BAD_CAST "element", NULL);
+    lob_stream_t stream;
+    if (lob_stream_open(vch->lob, &stream) == LOB_FAIL) {
+        logger(LL_ERROR, __func__, "Unable to open large object %ld", vch->lob);
+        return element_node;
+    }
+    /* Ticket size counts terminating zero, it is not a part of content */
+    int64_t left = vch->size - 1;
+    const char *chunk;
+    int64_t len;
+    while (left > 0 && (len = lob_stream_next(&stream, &chunk)) > 0) {
+        len = len < left ? len : left;
+        xmlNodeAddContentLen(element_node, BAD_CAST chunk, (int) len);
+        left -= len;
+    }
+    return element_node;
+}
+
 char *response2xml(db_t *db, struct response *resp) {
     xmlDocPtr doc = xmlNewDoc(BAD_CAST "1.0");
     xmlNodePtr root_node = xmlNewNode(NULL, BAD_CAST "response");
@@ -197,21 +233,23 @@ char *response2xml(db_t *db, struct response *resp) {
     if (resp->message != NULL) {
         xmlNodePtr message_node = xmlNewChild(root_node, NULL, BAD_CAST "message", BAD_CAST resp->message);
     }
-    if (resp->table != NULL) {
+    sch_desc_t *desc = resp->table != NULL ? sch_desc_load(resp->table->schidx) : NULL;
+    if (desc != NULL) {
         xmlNodePtr table_node = xmlNewChild(root_node, NULL, BAD_CAST "table", NULL);
         xmlNewProp(table_node, BAD_CAST "name", BAD_CAST resp->table->name);
         table_t *table = resp->table;
         schema_t *schema = sch_load(table->schidx);
         xmlNodePtr schema_node = xmlNewChild(table_node, NULL, BAD_CAST "schema", NULL);
-        sch_for_each(schema, chunk3, field3, chblix3, schema_index(schema)) {
+        sch_desc_for_each(desc, field3) {
             xmlNodePtr field_node = xmlNewChild(schema_node, NULL, BAD_CAST "field", NULL);
-            xmlNewProp(field_node, BAD_CAST "name", BAD_CAST field3.name);
+            xmlNewProp(field_node, BAD_CAST "name", BAD_CAST field3->name);
         }
         void *row = malloc(schema->slot_size);
         xmlNodePtr rows_node = xmlNewChild(table_node, NULL, BAD_CAST "rows", NULL);
         tab_for_each_row(table, chunk, chblix, row, schema) {
             xmlNodePtr row_node = xmlNewChild(rows_node, NULL, BAD_CAST "row", NULL);
-            sch_for_each(schema, chunk2, field, chblix2, schema_index(schema)) {
+            sch_desc_for_each(desc, fieldp) {
+                field_t field = *fieldp;
                 switch (field.type) {
                     case DT_INT: {
                         int64_t val = *(int64_t *) ((char *) row + field.offset);
@@ -232,12 +270,20 @@ char *response2xml(db_t *db, struct response *resp) {
                         break;
                     }
                     case DT_VARCHAR: {
-                        vch_ticket_t *vch = (vch_ticket_t *) ((char *) row + field.offset);
-                        char *str = malloc(vch->size);
-                        vch_get(db->varchar_mgr_idx, vch, str);
+                        vch_ticket_t ticket;
+                        vch_ticket_t *vch = sch_varchar_ticket(&field, (char *) row + field.offset, &ticket);
+                        if (vch == NULL) {
+                            break;
+                        }
+                        if (vch_is_lob(vch)) {
+                            xmlNodePtr element_node = xml_new_lob_child(row_node, vch);
+                            xmlNewProp(element_node, BAD_CAST "name", BAD_CAST field.name);
+                            break;
+                        }
+                        char *str = vch_acquire(db->varchar_mgr_idx, vch);
                         xmlNodePtr element_node = xmlNewChild(row_node, NULL, BAD_CAST "element", BAD_CAST str);
                         xmlNewProp(element_node, BAD_CAST "name", BAD_CAST field.name);
-                        free(str);
+                        vch_release(vch, str);
                         break;
                     }
                     case DT_BOOL: {
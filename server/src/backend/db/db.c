@@ -1,11 +1,15 @@
 #include "db.h"
+#include "backend/table/join_cache.h"
+#include "backend/table/schema_desc.h"
+#include <stddef.h>
 
 static void* db_create(void){
     pg_alloc();
-    db_t* db = pg_load_page(1);
+    db_t* db = pg_load_page(DB_PAGE);
     if(!db){
         return NULL;
     }
+    sch_desc_attach(db->schema_version);
     table_t* meta_tab = mtab_init();
     if(meta_tab == NULL){
         return NULL;
@@ -24,16 +28,20 @@ static void* db_create(void){
  * @return      pointer to database on success, NULL on failure
  */
 void* db_init(const char* filename){
+    sch_desc_clear();
+    jc_clear();
+    mtab_index_clear();
     if(pg_init(filename) != PAGER_SUCCESS){
         return NULL;
     }
     if(pg_max_page_index() == 0){
         return db_create();
     }
-    db_t* db = pg_load_page(1);
+    db_t* db = pg_load_page(DB_PAGE);
     if(!db){
         return NULL;
     }
+    sch_desc_attach(db->schema_version);
     return db;
 }
 
@@ -42,6 +50,11 @@ void* db_init(const char* filename){
  * @return      DB_SUCCESS on success, DB_FAIL on failure
  */
 int db_close(void){
+    int64_t version = sch_desc_last_version();
+    pg_write(DB_PAGE, &version, sizeof(int64_t), offsetof(db_t, schema_version));
+    sch_desc_clear();
+    jc_clear();
+    mtab_index_clear();
     int res =  pg_close() == PAGER_SUCCESS ? DB_SUCCESS : DB_FAIL;
     return res;
 }
@@ -50,6 +63,9 @@ int db_close(void){
  * @return      DB_SUCCESS on success, DB_FAIL on failure
  */
 int db_drop(void){
+    sch_desc_clear();
+    jc_clear();
+    mtab_index_clear();
     int res = pg_delete() == PAGER_SUCCESS ? DB_SUCCESS : DB_FAIL;
     return res;
 }
@@ -3,9 +3,13 @@
 #include "backend/journal/metatab.h"
 #include "core/io/pager.h"
 
+/* Page of the db header */
+#define DB_PAGE 1
+
 typedef struct db{
     int64_t meta_table_idx;
     int64_t varchar_mgr_idx;
+    int64_t schema_version; //the last version given to a schema
 } db_t;
 
 void* db_init(const char* filename);
@@ -0,0 +1,490 @@
+#include "btree.h"
+#include "core/io/pager.h"
+#include "utils/logger.h"
+#include <string.h>
+
+/* Keys are padded to BT_ENTRY_ALIGN, so keys, chblix and children are aligned in the node */
+#define bt_key_stride(key_size) (((int64_t) (key_size) + BT_ENTRY_ALIGN - 1) / BT_ENTRY_ALIGN * BT_ENTRY_ALIGN)
+#define bt_leaf_entry(bt) (bt_key_stride((bt)->key_size) + (int64_t) sizeof(chblix_t))
+#define bt_inner_entry(bt) (bt_leaf_entry(bt) + (int64_t) sizeof(int64_t))
+#define bt_entry_size(bt, node) ((node)->leaf ? bt_leaf_entry(bt) : bt_inner_entry(bt))
+#define bt_entries(node) ((char*)(node) + sizeof(bt_node_t))
+#define bt_node_load(page) ((bt_node_t*)lp_load(page))
+
+/**
+ * @brief       Get number of entries fitting in a node
+ * @param[in]   entry_size: size of entry
+ * @return      capacity of node
+ */
+
+static int64_t bt_capacity(int64_t entry_size){
+    return ((int64_t) PAGE_SIZE - (int64_t) sizeof(bt_node_t)) / entry_size;
+}
+
+/**
+ * @brief       Compare two keys
+ * @param[in]   bt: copy of index header
+ * @param[in]   key1: the first key
+ * @param[in]   key2: the second key
+ * @return      negative, zero or positive as key1 is less, equal or greater than key2
+ */
+
+static int bt_key_cmp(const btree_t* bt, void* key1, void* key2){
+    switch (bt->type) {
+        case DT_INT: {
+            int64_t a;
+            int64_t b;
+            memcpy(&a, key1, sizeof(int64_t));
+            memcpy(&b, key2, sizeof(int64_t));
+            return (a > b) - (a < b);
+        }
+        case DT_FLOAT: {
+            double a;
+            double b;
+            memcpy(&a, key1, sizeof(double));
+            memcpy(&b, key2, sizeof(double));
+            return (a > b) - (a < b);
+        }
+        case DT_BOOL:
+            return *(bool*) key1 - *(bool*) key2;
+        case DT_CHAR:
+            return strncmp(key1, key2, bt->key_size);
+        case DT_VARCHAR:
+            return vch_cmp(bt->vchmgr_idx, key1, key2);
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief       Compare searched entry with entry of node
+ * @param[in]   bt: copy of index header
+ * @param[in]   key: searched key
+ * @param[in]   rowix: searched row or NULL when any row of the key is searched
+ * @param[in]   tie: result for equal keys when rowix is NULL
+ * @param[in]   entry: entry of node
+ * @return      negative, zero or positive as searched entry is less, equal or greater
+ */
+
+static int bt_entry_cmp(const btree_t* bt, void* key, chblix_t* rowix, int tie, char* entry){
+    int res = bt_key_cmp(bt, key, entry);
+    if(res != 0){
+        return res;
+    }
+    if(rowix == NULL){
+        return tie;
+    }
+    chblix_t other;
+    memcpy(&other, entry + bt_key_stride(bt->key_size), sizeof(chblix_t));
+    if(rowix->chunk_idx != other.chunk_idx){
+        return rowix->chunk_idx < other.chunk_idx ? -1 : 1;
+    }
+    return (rowix->block_idx > other.block_idx) - (rowix->block_idx < other.block_idx);
+}
+
+/**
+ * @brief       Count entries of node not greater than searched entry
+ * @param[in]   bt: copy of index header
+ * @param[in]   node: pointer to node
+ * @param[in]   key: searched key
+ * @param[in]   rowix: searched row or NULL
+ * @param[in]   tie: result for equal keys when rowix is NULL
+ * @return      position to insert searched entry at
+ */
+
+static int64_t bt_search(const btree_t* bt, bt_node_t* node, void* key, chblix_t* rowix, int tie){
+    int64_t entry_size = bt_entry_size(bt, node);
+    int64_t lo = 0;
+    int64_t hi = node->count;
+    while(lo < hi){
+        int64_t mid = lo + (hi - lo) / 2;
+        if(bt_entry_cmp(bt, key, rowix, tie, bt_entries(node) + mid * entry_size) >= 0){
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief       Get child of internal node left of position
+ * @param[in]   bt: copy of index header
+ * @param[in]   node: pointer to internal node
+ * @param[in]   pos: number of separators not greater than searched entry
+ * @return      page index of the child
+ */
+
+static int64_t bt_child(const btree_t* bt, bt_node_t* node, int64_t pos){
+    if(pos == 0){
+        return node->first;
+    }
+    int64_t child;
+    memcpy(&child, bt_entries(node) + (pos - 1) * bt_inner_entry(bt) + bt_leaf_entry(bt), sizeof(int64_t));
+    return child;
+}
+
+/**
+ * @brief       Allocate empty node
+ * @param[in]   btidx: index of the index, node goes to its space
+ * @param[in]   leaf: true for leaf
+ * @return      page index of the node on success, BT_FAIL on failure
+ */
+
+static int64_t bt_node_init(int64_t btidx, bool leaf){
+    int64_t page = lp_init_near(btidx, sizeof(bt_node_t));
+    if(page == LP_FAIL){
+        logger(LL_ERROR, __func__, "Unable to allocate node");
+        return BT_FAIL;
+    }
+    bt_node_t* node = bt_node_load(page);
+    node->leaf = leaf;
+    node->count = 0;
+    node->first = BT_NONE;
+    node->next = BT_NONE;
+    return page;
+}
+
+/**
+ * @brief       Initialize an index
+ * @param[in]   type: type of keys
+ * @param[in]   key_size: size of key
+ * @param[in]   vchmgr_idx: varchar manager of varchar keys
+ * @return      index of the index on success, BT_FAIL on failure
+ */
+
+int64_t bt_init(datatype_t type, int64_t key_size, int64_t vchmgr_idx){
+    if(bt_capacity(bt_key_stride(key_size) + (int64_t) sizeof(chblix_t) + (int64_t) sizeof(int64_t)) < 3){
+        logger(LL_ERROR, __func__, "Key of %ld bytes is too large for index", key_size);
+        return BT_FAIL;
+    }
+    int64_t btidx = lp_init_m(sizeof(btree_t));
+    if(btidx == LP_FAIL){
+        logger(LL_ERROR, __func__, "Unable to allocate index");
+        return BT_FAIL;
+    }
+    int64_t root = bt_node_init(btidx, true);
+    if(root == BT_FAIL){
+        return BT_FAIL;
+    }
+    /* Node allocation may evict the header, reload it */
+    btree_t* bt = bt_load(btidx);
+    bt->root = root;
+    bt->type = type;
+    bt->key_size = key_size;
+    bt->vchmgr_idx = vchmgr_idx;
+    bt->size = 0;
+    return btidx;
+}
+
+/**
+ * @brief       Insert entry into full node moving upper half to a new node
+ * @param[in]   btidx: index of the index
+ * @param[in]   bt: copy of index header
+ * @param[in]   page: page index of the node
+ * @param[in]   pos: position of the entry
+ * @param[in,out] entry: entry to insert, replaced with separator of the new node
+ * @return      page index of the new node on success, BT_FAIL on failure
+ */
+
+static int64_t bt_split(int64_t btidx, const btree_t* bt, int64_t page, int64_t pos, char* entry){
+    bt_node_t* node = bt_node_load(page);
+    bool leaf = node->leaf;
+    int64_t entry_size = bt_entry_size(bt, node);
+    int64_t count = node->count + 1;
+    char* buf = malloc(count * entry_size);
+    if(buf == NULL){
+        logger(LL_ERROR, __func__, "Unable to allocate %ld entries", count);
+        return BT_FAIL;
+    }
+    memcpy(buf, bt_entries(node), pos * entry_size);
+    memcpy(buf + pos * entry_size, entry, entry_size);
+    memcpy(buf + (pos + 1) * entry_size, bt_entries(node) + pos * entry_size, (node->count - pos) * entry_size);
+
+    int64_t right_page = bt_node_init(btidx, leaf);
+    if(right_page == BT_FAIL){
+        free(buf);
+        return BT_FAIL;
+    }
+    node = bt_node_load(page);
+    bt_node_t* right = bt_node_load(right_page);
+    int64_t mid = count / 2;
+    char* separator = buf + mid * entry_size;
+    memcpy(bt_entries(node), buf, mid * entry_size);
+    node->count = mid;
+    if(leaf){
+        /* Leaf keeps separator as its first entry */
+        memcpy(bt_entries(right), separator, (count - mid) * entry_size);
+        right->count = count - mid;
+        right->next = node->next;
+        node->next = right_page;
+    } else {
+        /* Child of separator becomes leftmost child of the new node */
+        memcpy(&right->first, separator + bt_leaf_entry(bt), sizeof(int64_t));
+        memcpy(bt_entries(right), separator + entry_size, (count - mid - 1) * entry_size);
+        right->count = count - mid - 1;
+    }
+    memcpy(entry, separator, bt_leaf_entry(bt));
+    memcpy(entry + bt_leaf_entry(bt), &right_page, sizeof(int64_t));
+    free(buf);
+    return right_page;
+}
+
+/**
+ * @brief       Insert an entry
+ * @param[in]   btidx: index of the index
+ * @param[in]   key: key of the row
+ * @param[in]   rowix: chblix of the row
+ * @return      BT_SUCCESS on success, BT_FAIL on failure
+ */
+
+int bt_insert(int64_t btidx, void* key, chblix_t* rowix){
+    btree_t* header = bt_load(btidx);
+    if(header == NULL){
+        logger(LL_ERROR, __func__, "Unable to load index %ld", btidx);
+        return BT_FAIL;
+    }
+    btree_t bt = *header;
+    int64_t path[BT_MAX_HEIGHT];
+    int64_t positions[BT_MAX_HEIGHT];
+    int depth = 0;
+    for(int64_t page = bt.root;; depth++){
+        if(depth == BT_MAX_HEIGHT){
+            logger(LL_ERROR, __func__, "Index %ld is too high", btidx);
+            return BT_FAIL;
+        }
+        bt_node_t* node = bt_node_load(page);
+        path[depth] = page;
+        positions[depth] = bt_search(&bt, node, key, rowix, 0);
+        if(node->leaf){
+            break;
+        }
+        page = bt_child(&bt, node, positions[depth]);
+    }
+
+    char* entry = calloc(1, bt_inner_entry(&bt));
+    if(entry == NULL){
+        logger(LL_ERROR, __func__, "Unable to allocate entry");
+        return BT_FAIL;
+    }
+    memcpy(entry, key, bt.key_size);
+    memcpy(entry + bt_key_stride(bt.key_size), rowix, sizeof(chblix_t));
+    int level = depth;
+    for(; level >= 0; level--){
+        bt_node_t* node = bt_node_load(path[level]);
+        int64_t entry_size = bt_entry_size(&bt, node);
+        int64_t pos = positions[level];
+        if(node->count < bt_capacity(entry_size)){
+            char* at = bt_entries(node) + pos * entry_size;
+            memmove(at + entry_size, at, (node->count - pos) * entry_size);
+            memcpy(at, entry, entry_size);
+            node->count++;
+            break;
+        }
+        if(bt_split(btidx, &bt, path[level], pos, entry) == BT_FAIL){
+            free(entry);
+            return BT_FAIL;
+        }
+    }
+    if(level < 0){
+        /* Root was split, tree grows by one level */
+        int64_t root = bt_node_init(btidx, false);
+        if(root == BT_FAIL){
+            free(entry);
+            return BT_FAIL;
+        }
+        bt_node_t* node = bt_node_load(root);
+        node->first = bt.root;
+        memcpy(bt_entries(node), entry, bt_inner_entry(&bt));
+        node->count = 1;
+        bt_load(btidx)->root = root;
+    }
+    free(entry);
+    bt_load(btidx)->size++;
+    return BT_SUCCESS;
+}
+
+/**
+ * @brief       Delete an entry
+ * @param[in]   btidx: index of the index
+ * @param[in]   key: key of the row
+ * @param[in]   rowix: chblix of the row
+ * @return      BT_SUCCESS on success, BT_FAIL if there is no such entry
+ */
+
+int bt_delete(int64_t btidx, void* key, chblix_t* rowix){
+    btree_t* header = bt_load(btidx);
+    if(header == NULL){
+        logger(LL_ERROR, __func__, "Unable to load index %ld", btidx);
+        return BT_FAIL;
+    }
+    btree_t bt = *header;
+    bt_node_t* node = bt_node_load(bt.root);
+    while(!node->leaf){
+        node = bt_node_load(bt_child(&bt, node, bt_search(&bt, node, key, rowix, 0)));
+    }
+    int64_t pos = bt_search(&bt, node, key, rowix, 0) - 1;
+    int64_t entry_size = bt_leaf_entry(&bt);
+    char* at = bt_entries(node) + pos * entry_size;
+    if(pos < 0 || bt_entry_cmp(&bt, key, rowix, 0, at) != 0){
+        logger(LL_ERROR, __func__, "Row %ld:%ld is not in index %ld", rowix->chunk_idx, rowix->block_idx, btidx);
+        return BT_FAIL;
+    }
+    memmove(at, at + entry_size, (node->count - pos - 1) * entry_size);
+    node->count--;
+    bt_load(btidx)->size--;
+    return BT_SUCCESS;
+}
+
+/**
+ * @brief       Position cursor on the first entry matching condition
+ * @param[in]   btidx: index of the index
+ * @param[in]   cond: condition of keys relative to the given key, NEQ is not supported
+ * @param[in]   key: key to compare with
+ * @param[out]  cursor: cursor to open, must be closed with bt_cursor_close
+ * @return      BT_SUCCESS on success, BT_FAIL on failure
+ */
+
+int bt_seek(int64_t btidx, condition_t cond, void* key, bt_cursor_t* cursor){
+    cursor->leaf = BT_NONE;
+    cursor->key = NULL;
+    if(cond == COND_NEQ){
+        logger(LL_ERROR, __func__, "Index %ld can not seek on inequality", btidx);
+        return BT_FAIL;
+    }
+    btree_t* header = bt_load(btidx);
+    if(header == NULL){
+        logger(LL_ERROR, __func__, "Unable to load index %ld", btidx);
+        return BT_FAIL;
+    }
+    btree_t bt = *header;
+    cursor->key = malloc(bt.key_size);
+    if(cursor->key == NULL){
+        logger(LL_ERROR, __func__, "Unable to allocate key");
+        return BT_FAIL;
+    }
+    memcpy(cursor->key, key, bt.key_size);
+    cursor->btidx = btidx;
+    cursor->cond = cond;
+
+    /* Lower bound sorts before equal keys for EQ and GTE and after them for GT */
+    bool from_start = cond == COND_LT || cond == COND_LTE;
+    int tie = cond == COND_GT ? 1 : -1;
+    int64_t page = bt.root;
+    bt_node_t* node = bt_node_load(page);
+    while(!node->leaf){
+        page = from_start ? node->first : bt_child(&bt, node, bt_search(&bt, node, key, NULL, tie));
+        node = bt_node_load(page);
+    }
+    cursor->leaf = page;
+    cursor->pos = from_start ? 0 : bt_search(&bt, node, key, NULL, tie);
+    return BT_SUCCESS;
+}
+
+/**
+ * @brief       Get row of the next entry matching condition of cursor
+ * @param[in]   cursor: open cursor
+ * @param[out]  rowix: chblix of the row
+ * @return      BT_SUCCESS on success, BT_END when there are no more entries, BT_FAIL on failure
+ */
+
+int bt_next(bt_cursor_t* cursor, chblix_t* rowix){
+    if(cursor->leaf == BT_NONE){
+        return BT_END;
+    }
+    btree_t* header = bt_load(cursor->btidx);
+    if(header == NULL){
+        logger(LL_ERROR, __func__, "Unable to load index %ld", cursor->btidx);
+        return BT_FAIL;
+    }
+    btree_t bt = *header;
+    while(cursor->leaf != BT_NONE){
+        bt_node_t* node = bt_node_load(cursor->leaf);
+        if(cursor->pos >= node->count){
+            cursor->leaf = node->next;
+            cursor->pos = 0;
+            continue;
+        }
+        char* entry = bt_entries(node) + cursor->pos * bt_leaf_entry(&bt);
+        if(cursor->cond != COND_GT && cursor->cond != COND_GTE){
+            int res = bt_key_cmp(&bt, entry, cursor->key);
+            if(res > 0 || (res == 0 && cursor->cond == COND_LT)){
+                cursor->leaf = BT_NONE;
+                break;
+            }
+        }
+        memcpy(rowix, entry + bt_key_stride(bt.key_size), sizeof(chblix_t));
+        cursor->pos++;
+        return BT_SUCCESS;
+    }
+    return BT_END;
+}
+
+/**
+ * @brief       Close cursor
+ * @param[in]   cursor: cursor opened by bt_seek
+ */
+
+void bt_cursor_close(bt_cursor_t* cursor){
+    free(cursor->key);
+    cursor->key = NULL;
+    cursor->leaf = BT_NONE;
+}
+
+/**
+ * @brief       Get number of entries
+ * @param[in]   btidx: index of the index
+ * @return      number of entries on success, BT_FAIL on failure
+ */
+
+int64_t bt_size(int64_t btidx){
+    btree_t* bt = bt_load(btidx);
+    if(bt == NULL){
+        logger(LL_ERROR, __func__, "Unable to load index %ld", btidx);
+        return BT_FAIL;
+    }
+    return bt->size;
+}
+
+/**
+ * @brief       Free node and its subtree
+ * @param[in]   bt: copy of index header
+ * @param[in]   page: page index of the node
+ * @return      BT_SUCCESS on success, BT_FAIL on failure
+ */
+
+static int bt_destroy_node(const btree_t* bt, int64_t page){
+    bt_node_t* node = bt_node_load(page);
+    if(node == NULL){
+        return BT_FAIL;
+    }
+    if(!node->leaf){
+        int64_t count = node->count;
+        for(int64_t pos = 0; pos <= count; pos++){
+            if(bt_destroy_node(bt, bt_child(bt, bt_node_load(page), pos)) == BT_FAIL){
+                return BT_FAIL;
+            }
+        }
+    }
+    return lp_delete(page) == LP_FAIL ? BT_FAIL : BT_SUCCESS;
+}
+
+/**
+ * @brief       Destroy an index
+ * @param[in]   btidx: index of the index
+ * @return      BT_SUCCESS on success, BT_FAIL on failure
+ */
+
+int bt_destroy(int64_t btidx){
+    btree_t* header = bt_load(btidx);
+    if(header == NULL){
+        logger(LL_ERROR, __func__, "Unable to load index %ld", btidx);
+        return BT_FAIL;
+    }
+    btree_t bt = *header;
+    if(bt_destroy_node(&bt, bt.root) == BT_FAIL){
+        logger(LL_ERROR, __func__, "Unable to free nodes of index %ld", btidx);
+        return BT_FAIL;
+    }
+    return lp_delete(btidx) == LP_FAIL ? BT_FAIL : BT_SUCCESS;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "backend/comparator/conditions.h"
+#include "backend/data_type.h"
+#include "core/page_pool/page_pool.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Persistent B+tree secondary index, one node per page. Entries are pairs of
+ * column key and chblix of the row, ordered by key and then by chblix, so
+ * duplicate keys are allowed and every entry is unique. Internal node keeps
+ * its leftmost child in the header and separator entries with the child of
+ * everything not less than the separator. Leaves are chained left to right.
+ * Deleted entries leave leaves as they are, nodes are never merged.
+ *
+ * Varchar key is a ticket, strings are compared through the varchar manager
+ * of the index. Keys are padded to BT_ENTRY_ALIGN in entries, so tickets and
+ * chblix are read in place at aligned addresses.
+ */
+
+#ifndef BT_MAX_HEIGHT
+#define BT_MAX_HEIGHT 32
+#endif
+
+#define BT_ENTRY_ALIGN 8
+
+#define BT_NONE (-1)
+
+typedef struct bt_node{
+    linked_page_t lp_header;
+    int64_t leaf;
+    int64_t count;
+    int64_t first; //leftmost child of internal node
+    int64_t next; //right sibling of leaf or BT_NONE
+} bt_node_t;
+
+typedef struct btree{
+    linked_page_t lp_header;
+    int64_t root;
+    int64_t type;
+    int64_t key_size;
+    int64_t vchmgr_idx;
+    int64_t size;
+} btree_t;
+
+typedef struct bt_cursor{
+    int64_t btidx;
+    int64_t leaf;
+    int64_t pos;
+    condition_t cond;
+    void* key;
+} bt_cursor_t;
+
+typedef enum {BT_SUCCESS = 0, BT_FAIL = -1, BT_END = 1} bt_status_t;
+
+/**
+ * @brief       Load an index
+ * @param[in]   btidx: index of the index header page
+ * @return      pointer to the index on success, NULL on failure
+ */
+
+#define bt_load(btidx) ((btree_t*)lp_load(btidx))
+
+int64_t bt_init(datatype_t type, int64_t key_size, int64_t vchmgr_idx);
+int bt_insert(int64_t btidx, void* key, chblix_t* rowix);
+int bt_delete(int64_t btidx, void* key, chblix_t* rowix);
+int bt_seek(int64_t btidx, condition_t cond, void* key, bt_cursor_t* cursor);
+int bt_next(bt_cursor_t* cursor, chblix_t* rowix);
+void bt_cursor_close(bt_cursor_t* cursor);
+int64_t bt_size(int64_t btidx);
+int bt_destroy(int64_t btidx);
@@ -0,0 +1,528 @@
+#include "hash_index.h"
+#include "backend/comparator/comparator.h"
+#include "backend/journal/varchar_mgr.h"
+#include "core/io/pager.h"
+#include "utils/logger.h"
+#include <string.h>
+
+/* Keys are padded to HX_ENTRY_ALIGN, so keys and chblix are aligned in the bucket */
+#define hx_key_stride(key_size) (((int64_t) (key_size) + HX_ENTRY_ALIGN - 1) / HX_ENTRY_ALIGN * HX_ENTRY_ALIGN)
+#define hx_entry_size(hx) ((int64_t) sizeof(uint64_t) + hx_key_stride((hx)->key_size) + (int64_t) sizeof(chblix_t))
+#define hx_entries(bucket) ((char*)(bucket) + sizeof(hx_bucket_t))
+#define hx_entry_key(entry) ((entry) + sizeof(uint64_t))
+#define hx_entry_rowix(hx, entry) (hx_entry_key(entry) + hx_key_stride((hx)->key_size))
+#define hx_bucket_load(page) ((hx_bucket_t*)lp_load(page))
+#define hx_dir_load(page) ((hx_dir_t*)lp_load(page))
+
+/**
+ * @brief       Get number of entries fitting in a bucket page
+ * @param[in]   hx: copy of index header
+ * @return      capacity of bucket page
+ */
+
+static int64_t hx_capacity(const hash_index_t* hx){
+    return ((int64_t) PAGE_SIZE - (int64_t) sizeof(hx_bucket_t)) / hx_entry_size(hx);
+}
+
+/**
+ * @brief       Hash a key
+ * @param[in]   hx: copy of index header
+ * @param[in]   key: the key
+ * @return      hash of the key
+ */
+
+static uint64_t hx_hash(const hash_index_t* hx, void* key){
+    /* Varchar keys are tickets, never dictionary codes */
+    field_t field = {.type = hx->type, .size = (uint64_t) hx->key_size, .dict = DICT_NONE};
+    return comp_hash_field(&field, key, false);
+}
+
+/**
+ * @brief       Check equality of two keys
+ * @param[in]   hx: copy of index header
+ * @param[in]   key1: the first key
+ * @param[in]   key2: the second key
+ * @return      true if keys are equal
+ */
+
+static bool hx_key_eq(const hash_index_t* hx, void* key1, void* key2){
+    switch (hx->type) {
+        case DT_INT:
+        case DT_BOOL:
+            return memcmp(key1, key2, hx->key_size) == 0;
+        case DT_FLOAT: {
+            double a;
+            double b;
+            memcpy(&a, key1, sizeof(double));
+            memcpy(&b, key2, sizeof(double));
+            return a == b;
+        }
+        case DT_CHAR:
+            return strncmp(key1, key2, hx->key_size) == 0;
+        case DT_VARCHAR:
+            return vch_eq(hx->vchmgr_idx, key1, key2);
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief       Get bucket of directory slot
+ * @param[in]   hxidx: index of the index
+ * @param[in]   slot: slot of directory
+ * @return      page index of the bucket
+ */
+
+static int64_t hx_dir_get(int64_t hxidx, int64_t slot){
+    int64_t page = hx_load(hxidx)->dir[slot >> HX_DIR_BITS];
+    return hx_dir_load(page)->buckets[slot & (HX_DIR_SIZE - 1)];
+}
+
+/**
+ * @brief       Point directory slot to bucket
+ * @param[in]   hxidx: index of the index
+ * @param[in]   slot: slot of directory
+ * @param[in]   bucket: page index of the bucket
+ */
+
+static void hx_dir_set(int64_t hxidx, int64_t slot, int64_t bucket){
+    int64_t page = hx_load(hxidx)->dir[slot >> HX_DIR_BITS];
+    hx_dir_load(page)->buckets[slot & (HX_DIR_SIZE - 1)] = bucket;
+}
+
+/**
+ * @brief       Allocate empty bucket page
+ * @param[in]   hxidx: index of the index, bucket goes to its space
+ * @param[in]   depth: local depth of the bucket
+ * @return      page index of the bucket on success, HX_FAIL on failure
+ */
+
+static int64_t hx_bucket_init(int64_t hxidx, int64_t depth){
+    int64_t page = lp_init_near(hxidx, sizeof(hx_bucket_t));
+    if(page == LP_FAIL){
+        logger(LL_ERROR, __func__, "Unable to allocate bucket");
+        return HX_FAIL;
+    }
+    hx_bucket_t* bucket = hx_bucket_load(page);
+    bucket->depth = depth;
+    bucket->count = 0;
+    bucket->next = HX_NONE;
+    return page;
+}
+
+/**
+ * @brief       Initialize an index
+ * @param[in]   type: type of keys
+ * @param[in]   key_size: size of key
+ * @param[in]   vchmgr_idx: varchar manager of varchar keys
+ * @return      index of the index on success, HX_FAIL on failure
+ */
+
+int64_t hx_init(datatype_t type, int64_t key_size, int64_t vchmgr_idx){
+    if(((int64_t) PAGE_SIZE - (int64_t) sizeof(hx_bucket_t)) /
+       ((int64_t) sizeof(uint64_t) + hx_key_stride(key_size) + (int64_t) sizeof(chblix_t)) < 2){
+        logger(LL_ERROR, __func__, "Key of %ld bytes is too large for index", key_size);
+        return HX_FAIL;
+    }
+    int64_t hxidx = lp_init_m(sizeof(hash_index_t));
+    if(hxidx == LP_FAIL){
+        logger(LL_ERROR, __func__, "Unable to allocate index");
+        return HX_FAIL;
+    }
+    int64_t dir = lp_init_near(hxidx, sizeof(hx_dir_t));
+    int64_t bucket = dir == LP_FAIL ? HX_FAIL : hx_bucket_init(hxidx, 0);
+    if(bucket == HX_FAIL){
+        logger(LL_ERROR, __func__, "Unable to allocate directory");
+        return HX_FAIL;
+    }
+    /* Page allocation may evict the header, reload it */
+    hash_index_t* hx = hx_load(hxidx);
+    hx->type = type;
+    hx->key_size = key_size;
+    hx->vchmgr_idx = vchmgr_idx;
+    hx->size = 0;
+    hx->depth = 0;
+    for(int64_t i = 0; i < HX_DIR_PAGES; i++){
+        hx->dir[i] = HX_NONE;
+    }
+    hx->dir[0] = dir;
+    hx_dir_set(hxidx, 0, bucket);
+    return hxidx;
+}
+
+/**
+ * @brief       Double directory, new slots point to the same buckets as their lower halves
+ * @param[in]   hxidx: index of the index
+ * @return      HX_SUCCESS on success, HX_FAIL on failure
+ */
+
+static int hx_dir_grow(int64_t hxidx){
+    int64_t depth = hx_load(hxidx)->depth;
+    int64_t slots = INT64_C(1) << depth;
+    for(int64_t page = (slots + HX_DIR_SIZE - 1) / HX_DIR_SIZE; page < (2 * slots + HX_DIR_SIZE - 1) / HX_DIR_SIZE; page++){
+        int64_t dir = lp_init_near(hxidx, sizeof(hx_dir_t));
+        if(dir == LP_FAIL){
+            logger(LL_ERROR, __func__, "Unable to allocate directory page");
+            return HX_FAIL;
+        }
+        hx_load(hxidx)->dir[page] = dir;
+    }
+    for(int64_t slot = 0; slot < slots; slot++){
+        hx_dir_set(hxidx, slot + slots, hx_dir_get(hxidx, slot));
+    }
+    hx_load(hxidx)->depth = depth + 1;
+    return HX_SUCCESS;
+}
+
+/**
+ * @brief       Append entry to chain of bucket, growing the chain when it is full
+ * @param[in]   hxidx: index of the index
+ * @param[in]   hx: copy of index header
+ * @param[in]   page: page index of the first page of chain
+ * @param[in]   entry: entry to append
+ * @return      HX_SUCCESS on success, HX_FAIL on failure
+ */
+
+static int hx_bucket_append(int64_t hxidx, const hash_index_t* hx, int64_t page, char* entry){
+    int64_t entry_size = hx_entry_size(hx);
+    int64_t capacity = hx_capacity(hx);
+    hx_bucket_t* bucket = hx_bucket_load(page);
+    while(bucket->count == capacity && bucket->next != HX_NONE){
+        page = bucket->next;
+        bucket = hx_bucket_load(page);
+    }
+    if(bucket->count == capacity){
+        int64_t overflow = hx_bucket_init(hxidx, HX_NONE);
+        if(overflow == HX_FAIL){
+            return HX_FAIL;
+        }
+        hx_bucket_load(page)->next = overflow;
+        bucket = hx_bucket_load(overflow);
+    }
+    memcpy(hx_entries(bucket) + bucket->count * entry_size, entry, entry_size);
+    bucket->count++;
+    return HX_SUCCESS;
+}
+
+/**
+ * @brief       Check if splitting bucket can separate its entries
+ * @param[in]   hx: copy of index header
+ * @param[in]   page: page index of the first page of chain
+ * @param[in]   hash: hash of the entry being inserted
+ * @return      true if some entry of the chain has other hash
+ */
+
+static bool hx_bucket_splittable(const hash_index_t* hx, int64_t page, uint64_t hash){
+    int64_t entry_size = hx_entry_size(hx);
+    while(page != HX_NONE){
+        hx_bucket_t* bucket = hx_bucket_load(page);
+        for(int64_t i = 0; i < bucket->count; i++){
+            uint64_t other;
+            memcpy(&other, hx_entries(bucket) + i * entry_size, sizeof(uint64_t));
+            if(other != hash){
+                return true;
+            }
+        }
+        page = bucket->next;
+    }
+    return false;
+}
+
+/**
+ * @brief       Split bucket by the next bit of hash
+ * @param[in]   hxidx: index of the index
+ * @param[in]   hx: copy of index header
+ * @param[in]   page: page index of the first page of chain
+ * @param[in]   hash: hash of any entry of the bucket
+ * @return      HX_SUCCESS on success, HX_FAIL on failure
+ */
+
+static int hx_bucket_split(int64_t hxidx, const hash_index_t* hx, int64_t page, uint64_t hash){
+    int64_t depth = hx_bucket_load(page)->depth;
+    if(depth == hx_load(hxidx)->depth && hx_dir_grow(hxidx) == HX_FAIL){
+        return HX_FAIL;
+    }
+    int64_t sibling = hx_bucket_init(hxidx, depth + 1);
+    if(sibling == HX_FAIL){
+        return HX_FAIL;
+    }
+
+    /* Take all entries out of the chain, overflow pages are freed */
+    int64_t entry_size = hx_entry_size(hx);
+    int64_t count = 0;
+    for(int64_t p = page; p != HX_NONE; p = hx_bucket_load(p)->next){
+        count += hx_bucket_load(p)->count;
+    }
+    char* buf = malloc(count * entry_size);
+    if(buf == NULL){
+        logger(LL_ERROR, __func__, "Unable to allocate %ld entries", count);
+        return HX_FAIL;
+    }
+    int64_t taken = 0;
+    for(int64_t p = page; p != HX_NONE;){
+        hx_bucket_t* bucket = hx_bucket_load(p);
+        memcpy(buf + taken * entry_size, hx_entries(bucket), bucket->count * entry_size);
+        taken += bucket->count;
+        int64_t next = bucket->next;
+        if(p != page && lp_delete(p) == LP_FAIL){
+            free(buf);
+            return HX_FAIL;
+        }
+        p = next;
+    }
+    hx_bucket_t* bucket = hx_bucket_load(page);
+    bucket->depth = depth + 1;
+    bucket->count = 0;
+    bucket->next = HX_NONE;
+
+    for(int64_t i = 0; i < count; i++){
+        char* entry = buf + i * entry_size;
+        uint64_t entry_hash;
+        memcpy(&entry_hash, entry, sizeof(uint64_t));
+        if(hx_bucket_append(hxidx, hx, (entry_hash >> depth) & 1 ? sibling : page, entry) == HX_FAIL){
+            free(buf);
+            return HX_FAIL;
+        }
+    }
+    free(buf);
+
+    /* Slots of the old bucket with the new bit set go to the sibling */
+    int64_t slots = INT64_C(1) << hx_load(hxidx)->depth;
+    int64_t low = (int64_t) (hash & ((UINT64_C(1) << depth) - 1));
+    for(int64_t slot = low | (INT64_C(1) << depth); slot < slots; slot += INT64_C(1) << (depth + 1)){
+        hx_dir_set(hxidx, slot, sibling);
+    }
+    return HX_SUCCESS;
+}
+
+/**
+ * @brief       Get first page of the bucket of hash
+ * @param[in]   hxidx: index of the index
+ * @param[in]   hash: hash of a key
+ * @return      page index of the bucket
+ */
+
+static int64_t hx_bucket_of(int64_t hxidx, uint64_t hash){
+    int64_t depth = hx_load(hxidx)->depth;
+    return hx_dir_get(hxidx, (int64_t) (hash & ((UINT64_C(1) << depth) - 1)));
+}
+
+/**
+ * @brief       Insert an entry
+ * @param[in]   hxidx: index of the index
+ * @param[in]   key: key of the row
+ * @param[in]   rowix: chblix of the row
+ * @return      HX_SUCCESS on success, HX_FAIL on failure
+ */
+
+int hx_insert(int64_t hxidx, void* key, chblix_t* rowix){
+    hash_index_t* header = hx_load(hxidx);
+    if(header == NULL){
+        logger(LL_ERROR, __func__, "Unable to load index %ld", hxidx);
+        return HX_FAIL;
+    }
+    hash_index_t hx = *header;
+    uint64_t hash = hx_hash(&hx, key);
+    char* entry = calloc(1, hx_entry_size(&hx));
+    if(entry == NULL){
+        logger(LL_ERROR, __func__, "Unable to allocate entry");
+        return HX_FAIL;
+    }
+    memcpy(entry, &hash, sizeof(uint64_t));
+    memcpy(hx_entry_key(entry), key, hx.key_size);
+    memcpy(hx_entry_rowix(&hx, entry), rowix, sizeof(chblix_t));
+
+    int64_t page = hx_bucket_of(hxidx, hash);
+    hx_bucket_t* bucket = hx_bucket_load(page);
+    /* Split full bucket while it helps, then fall back to overflow pages */
+    while(bucket->count == hx_capacity(&hx) && bucket->depth < HX_MAX_DEPTH &&
+          hx_bucket_splittable(&hx, page, hash)){
+        if(hx_bucket_split(hxidx, &hx, page, hash) == HX_FAIL){
+            free(entry);
+            return HX_FAIL;
+        }
+        page = hx_bucket_of(hxidx, hash);
+        bucket = hx_bucket_load(page);
+    }
+    int res = hx_bucket_append(hxidx, &hx, page, entry);
+    free(entry);
+    if(res == HX_SUCCESS){
+        hx_load(hxidx)->size++;
+    }
+    return res;
+}
+
+/**
+ * @brief       Delete an entry
+ * @param[in]   hxidx: index of the index
+ * @param[in]   key: key of the row
+ * @param[in]   rowix: chblix of the row
+ * @return      HX_SUCCESS on success, HX_FAIL if there is no such entry
+ */
+
+int hx_delete(int64_t hxidx, void* key, chblix_t* rowix){
+    hash_index_t* header = hx_load(hxidx);
+    if(header == NULL){
+        logger(LL_ERROR, __func__, "Unable to load index %ld", hxidx);
+        return HX_FAIL;
+    }
+    hash_index_t hx = *header;
+    uint64_t hash = hx_hash(&hx, key);
+    int64_t entry_size = hx_entry_size(&hx);
+    int64_t prev = HX_NONE;
+    for(int64_t page = hx_bucket_of(hxidx, hash); page != HX_NONE;){
+        hx_bucket_t* bucket = hx_bucket_load(page);
+        for(int64_t i = 0; i < bucket->count; i++){
+            char* entry = hx_entries(bucket) + i * entry_size;
+            if(memcmp(entry, &hash, sizeof(uint64_t)) != 0 ||
+               memcmp(hx_entry_rowix(&hx, entry), rowix, sizeof(chblix_t)) != 0 ||
+               !hx_key_eq(&hx, hx_entry_key(entry), key)){
+                continue;
+            }
+            /* Order of entries does not matter, the last one fills the gap */
+            bucket = hx_bucket_load(page);
+            entry = hx_entries(bucket) + i * entry_size;
+            bucket->count--;
+            memmove(entry, hx_entries(bucket) + bucket->count * entry_size, entry_size);
+            if(bucket->count == 0 && prev != HX_NONE){
+                /* Empty overflow page leaves the chain */
+                hx_bucket_load(prev)->next = bucket->next;
+                lp_delete(page);
+            }
+            hx_load(hxidx)->size--;
+            return HX_SUCCESS;
+        }
+        prev = page;
+        page = bucket->next;
+    }
+    logger(LL_ERROR, __func__, "Row %ld:%ld is not in index %ld", rowix->chunk_idx, rowix->block_idx, hxidx);
+    return HX_FAIL;
+}
+
+/**
+ * @brief       Position cursor before entries of the key
+ * @param[in]   hxidx: index of the index
+ * @param[in]   key: searched key
+ * @param[out]  cursor: cursor to open, must be closed with hx_cursor_close
+ * @return      HX_SUCCESS on success, HX_FAIL on failure
+ */
+
+int hx_seek(int64_t hxidx, void* key, hx_cursor_t* cursor){
+    cursor->page = HX_NONE;
+    cursor->key = NULL;
+    hash_index_t* header = hx_load(hxidx);
+    if(header == NULL){
+        logger(LL_ERROR, __func__, "Unable to load index %ld", hxidx);
+        return HX_FAIL;
+    }
+    hash_index_t hx = *header;
+    cursor->key = malloc(hx.key_size);
+    if(cursor->key == NULL){
+        logger(LL_ERROR, __func__, "Unable to allocate key");
+        return HX_FAIL;
+    }
+    memcpy(cursor->key, key, hx.key_size);
+    cursor->hxidx = hxidx;
+    cursor->hash = hx_hash(&hx, key);
+    cursor->page = hx_bucket_of(hxidx, cursor->hash);
+    cursor->pos = 0;
+    return HX_SUCCESS;
+}
+
+/**
+ * @brief       Get row of the next entry of the key of cursor
+ * @param[in]   cursor: open cursor
+ * @param[out]  rowix: chblix of the row
+ * @return      HX_SUCCESS on success, HX_END when there are no more entries, HX_FAIL on failure
+ */
+
+int hx_next(hx_cursor_t* cursor, chblix_t* rowix){
+    if(cursor->page == HX_NONE){
+        return HX_END;
+    }
+    hash_index_t* header = hx_load(cursor->hxidx);
+    if(header == NULL){
+        logger(LL_ERROR, __func__, "Unable to load index %ld", cursor->hxidx);
+        return HX_FAIL;
+    }
+    hash_index_t hx = *header;
+    int64_t entry_size = hx_entry_size(&hx);
+    while(cursor->page != HX_NONE){
+        hx_bucket_t* bucket = hx_bucket_load(cursor->page);
+        if(cursor->pos >= bucket->count){
+            cursor->page = bucket->next;
+            cursor->pos = 0;
+            continue;
+        }
+        char* entry = hx_entries(bucket) + cursor->pos * entry_size;
+        cursor->pos++;
+        if(memcmp(entry, &cursor->hash, sizeof(uint64_t)) == 0 && hx_key_eq(&hx, hx_entry_key(entry), cursor->key)){
+            memcpy(rowix, hx_entry_rowix(&hx, entry), sizeof(chblix_t));
+            return HX_SUCCESS;
+        }
+    }
+    return HX_END;
+}
+
+/**
+ * @brief       Close cursor
+ * @param[in]   cursor: cursor opened by hx_seek
+ */
+
+void hx_cursor_close(hx_cursor_t* cursor){
+    free(cursor->key);
+    cursor->key = NULL;
+    cursor->page = HX_NONE;
+}
+
+/**
+ * @brief       Get number of entries
+ * @param[in]   hxidx: index of the index
+ * @return      number of entries on success, HX_FAIL on failure
+ */
+
+int64_t hx_size(int64_t hxidx){
+    hash_index_t* hx = hx_load(hxidx);
+    if(hx == NULL){
+        logger(LL_ERROR, __func__, "Unable to load index %ld", hxidx);
+        return HX_FAIL;
+    }
+    return hx->size;
+}
+
+/**
+ * @brief       Destroy an index
+ * @param[in]   hxidx: index of the index
+ * @return      HX_SUCCESS on success, HX_FAIL on failure
+ */
+
+int hx_destroy(int64_t hxidx){
+    hash_index_t* header = hx_load(hxidx);
+    if(header == NULL){
+        logger(LL_ERROR, __func__, "Unable to load index %ld", hxidx);
+        return HX_FAIL;
+    }
+    hash_index_t hx = *header;
+    int64_t slots = INT64_C(1) << hx.depth;
+    for(int64_t slot = slots - 1; slot >= 0; slot--){
+        int64_t page = hx_dir_get(hxidx, slot);
+        /* Bucket is shared by slots equal in its lower depth bits, the lowest one comes last and frees it */
+        if(slot >> hx_bucket_load(page)->depth != 0){
+            continue;
+        }
+        while(page != HX_NONE){
+            int64_t next = hx_bucket_load(page)->next;
+            if(lp_delete(page) == LP_FAIL){
+                logger(LL_ERROR, __func__, "Unable to free bucket of index %ld", hxidx);
+                return HX_FAIL;
+            }
+            page = next;
+        }
+    }
+    for(int64_t i = 0; i < HX_DIR_PAGES && hx.dir[i] != HX_NONE; i++){
+        if(lp_delete(hx.dir[i]) == LP_FAIL){
+            return HX_FAIL;
+        }
+    }
+    return lp_delete(hxidx) == LP_FAIL ? HX_FAIL : HX_SUCCESS;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "backend/data_type.h"
+#include "core/page_pool/page_pool.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Persistent extendible hash index for equality lookups. Entries are hash,
+ * column key and chblix of the row. Directory of 2^depth bucket pointers is
+ * split into directory pages, header keeps the pages. Full bucket is split
+ * by the next bit of hash while its local depth is below HX_MAX_DEPTH,
+ * otherwise or when all its entries have the same hash it grows a chain of
+ * overflow pages, so duplicate keys are allowed.
+ *
+ * Hash of a key matches comp_hash_field, varchar key is a ticket and is
+ * hashed by its string. Keys are padded to HX_ENTRY_ALIGN in entries, so
+ * tickets and chblix are read in place at aligned addresses.
+ */
+
+#ifndef HX_DIR_BITS
+#define HX_DIR_BITS 8
+#endif
+
+#ifndef HX_MAX_DEPTH
+#define HX_MAX_DEPTH 16
+#endif
+
+#define HX_NONE (-1)
+#define HX_ENTRY_ALIGN 8
+#define HX_DIR_SIZE (1 << HX_DIR_BITS)
+#define HX_DIR_PAGES (1 << (HX_MAX_DEPTH - HX_DIR_BITS))
+
+typedef struct hx_bucket{
+    linked_page_t lp_header;
+    int64_t depth; //local depth, meaningful in the first page of chain
+    int64_t count;
+    int64_t next; //overflow page or HX_NONE
+} hx_bucket_t;
+
+typedef struct hx_dir{
+    linked_page_t lp_header;
+    int64_t buckets[HX_DIR_SIZE];
+} hx_dir_t;
+
+typedef struct hash_index{
+    linked_page_t lp_header;
+    int64_t type;
+    int64_t key_size;
+    int64_t vchmgr_idx;
+    int64_t size;
+    int64_t depth; //global depth
+    int64_t dir[HX_DIR_PAGES];
+} hash_index_t;
+
+typedef struct hx_cursor{
+    int64_t hxidx;
+    int64_t page;
+    int64_t pos;
+    uint64_t hash;
+    void* key;
+} hx_cursor_t;
+
+typedef enum {HX_SUCCESS = 0, HX_FAIL = -1, HX_END = 1} hx_status_t;
+
+/**
+ * @brief       Load an index
+ * @param[in]   hxidx: index of the index header page
+ * @return      pointer to the index on success, NULL on failure
+ */
+
+#define hx_load(hxidx) ((hash_index_t*)lp_load(hxidx))
+
+int64_t hx_init(datatype_t type, int64_t key_size, int64_t vchmgr_idx);
+int hx_insert(int64_t hxidx, void* key, chblix_t* rowix);
+int hx_delete(int64_t hxidx, void* key, chblix_t* rowix);
+int hx_seek(int64_t hxidx, void* key, hx_cursor_t* cursor);
+int hx_next(hx_cursor_t* cursor, chblix_t* rowix);
+void hx_cursor_close(hx_cursor_t* cursor);
+int64_t hx_size(int64_t hxidx);
+int hx_destroy(int64_t hxidx);
@@ -0,0 +1,117 @@
+#include "index.h"
+#include "utils/logger.h"
+
+/**
+ * @brief       Initialize an index
+ * @param[in]   kind: kind of the index
+ * @param[in]   type: type of keys
+ * @param[in]   key_size: size of key
+ * @param[in]   vchmgr_idx: varchar manager of varchar keys
+ * @return      index of the index on success, IDX_FAIL on failure
+ */
+
+int64_t idx_init(index_kind_t kind, datatype_t type, int64_t key_size, int64_t vchmgr_idx){
+    int64_t idx = kind == IDX_HASH ? hx_init(type, key_size, vchmgr_idx) : bt_init(type, key_size, vchmgr_idx);
+    return idx < 0 ? IDX_FAIL : idx;
+}
+
+/**
+ * @brief       Insert an entry
+ * @param[in]   kind: kind of the index
+ * @param[in]   idx: index of the index
+ * @param[in]   key: key of the row
+ * @param[in]   rowix: chblix of the row
+ * @return      IDX_SUCCESS on success, IDX_FAIL on failure
+ */
+
+int idx_insert(index_kind_t kind, int64_t idx, void* key, chblix_t* rowix){
+    int res = kind == IDX_HASH ? hx_insert(idx, key, rowix) : bt_insert(idx, key, rowix);
+    return res == 0 ? IDX_SUCCESS : IDX_FAIL;
+}
+
+/**
+ * @brief       Delete an entry
+ * @param[in]   kind: kind of the index
+ * @param[in]   idx: index of the index
+ * @param[in]   key: key of the row
+ * @param[in]   rowix: chblix of the row
+ * @return      IDX_SUCCESS on success, IDX_FAIL if there is no such entry
+ */
+
+int idx_delete(index_kind_t kind, int64_t idx, void* key, chblix_t* rowix){
+    int res = kind == IDX_HASH ? hx_delete(idx, key, rowix) : bt_delete(idx, key, rowix);
+    return res == 0 ? IDX_SUCCESS : IDX_FAIL;
+}
+
+/**
+ * @brief       Position cursor on the first entry matching condition
+ * @param[in]   kind: kind of the index
+ * @param[in]   idx: index of the index
+ * @param[in]   cond: condition of keys relative to the given key, see idx_supports
+ * @param[in]   key: key to compare with
+ * @param[out]  cursor: cursor to open, must be closed with idx_cursor_close
+ * @return      IDX_SUCCESS on success, IDX_FAIL on failure
+ */
+
+int idx_seek(index_kind_t kind, int64_t idx, condition_t cond, void* key, idx_cursor_t* cursor){
+    cursor->kind = kind;
+    if(kind == IDX_HASH){
+        cursor->hx.key = NULL;
+        cursor->hx.page = HX_NONE;
+        if(!idx_supports(kind, cond)){
+            logger(LL_ERROR, __func__, "Hash index %ld can only seek on equality", idx);
+            return IDX_FAIL;
+        }
+        return hx_seek(idx, key, &cursor->hx) == HX_SUCCESS ? IDX_SUCCESS : IDX_FAIL;
+    }
+    return bt_seek(idx, cond, key, &cursor->bt) == BT_SUCCESS ? IDX_SUCCESS : IDX_FAIL;
+}
+
+/**
+ * @brief       Get row of the next entry matching condition of cursor
+ * @param[in]   cursor: open cursor
+ * @param[out]  rowix: chblix of the row
+ * @return      IDX_SUCCESS on success, IDX_END when there are no more entries, IDX_FAIL on failure
+ */
+
+int idx_next(idx_cursor_t* cursor, chblix_t* rowix){
+    int res = cursor->kind == IDX_HASH ? hx_next(&cursor->hx, rowix) : bt_next(&cursor->bt, rowix);
+    return res == 0 ? IDX_SUCCESS : res > 0 ? IDX_END : IDX_FAIL;
+}
+
+/**
+ * @brief       Close cursor
+ * @param[in]   cursor: cursor opened by idx_seek
+ */
+
+void idx_cursor_close(idx_cursor_t* cursor){
+    if(cursor->kind == IDX_HASH){
+        hx_cursor_close(&cursor->hx);
+    } else {
+        bt_cursor_close(&cursor->bt);
+    }
+}
+
+/**
+ * @brief       Get number of entries
+ * @param[in]   kind: kind of the index
+ * @param[in]   idx: index of the index
+ * @return      number of entries on success, IDX_FAIL on failure
+ */
+
+int64_t idx_size(index_kind_t kind, int64_t idx){
+    int64_t size = kind == IDX_HASH ? hx_size(idx) : bt_size(idx);
+    return size < 0 ? IDX_FAIL : size;
+}
+
+/**
+ * @brief       Destroy an index
+ * @param[in]   kind: kind of the index
+ * @param[in]   idx: index of the index
+ * @return      IDX_SUCCESS on success, IDX_FAIL on failure
+ */
+
+int idx_destroy(index_kind_t kind, int64_t idx){
+    int res = kind == IDX_HASH ? hx_destroy(idx) : bt_destroy(idx);
+    return res == 0 ? IDX_SUCCESS : IDX_FAIL;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "btree.h"
+#include "hash_index.h"
+
+/**
+ * Column index of either kind behind one interface. B+tree answers equality
+ * and ranges, hash index answers only equality but in one bucket read.
+ */
+
+#define IDX_NONE (-1)
+
+typedef enum {IDX_BTREE = 0, IDX_HASH = 1} index_kind_t;
+
+typedef enum {IDX_SUCCESS = 0, IDX_FAIL = -1, IDX_END = 1} idx_status_t;
+
+typedef struct idx_cursor{
+    index_kind_t kind;
+    union {
+        bt_cursor_t bt;
+        hx_cursor_t hx;
+    };
+} idx_cursor_t;
+
+/**
+ * @brief       Check if index of the kind can answer condition
+ * @param[in]   kind: kind of the index
+ * @param[in]   cond: condition
+ * @return      true if the condition can be answered
+ */
+
+#define idx_supports(kind, cond) ((cond) == COND_EQ || ((kind) == IDX_BTREE && (cond) != COND_NEQ))
+
+int64_t idx_init(index_kind_t kind, datatype_t type, int64_t key_size, int64_t vchmgr_idx);
+int idx_insert(index_kind_t kind, int64_t idx, void* key, chblix_t* rowix);
+int idx_delete(index_kind_t kind, int64_t idx, void* key, chblix_t* rowix);
+int idx_seek(index_kind_t kind, int64_t idx, condition_t cond, void* key, idx_cursor_t* cursor);
+int idx_next(idx_cursor_t* cursor, chblix_t* rowix);
+void idx_cursor_close(idx_cursor_t* cursor);
+int64_t idx_size(index_kind_t kind, int64_t idx);
+int idx_destroy(index_kind_t kind, int64_t idx);
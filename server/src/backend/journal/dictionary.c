@@ -0,0 +1,274 @@
+#include "dictionary.h"
+#include "core/io/pager.h"
+#include "utils/hashtable.h"
+#include "utils/logger.h"
+#include <string.h>
+
+/**
+ * @brief       Read slot of hash table
+ * @param[in]   slots: index of slots parray
+ * @param[in]   pos: position of the slot
+ * @param[out]  slot: destination
+ * @return      PA_SUCCESS on success, PA_FAIL on failure
+ * @note        never written slots are empty
+ */
+
+static int dict_slot_read(int64_t slots, int64_t pos, dict_slot_t* slot){
+    int res = pa_read(pa_load(slots), pos, slot, sizeof(dict_slot_t), 0);
+    if(res == PA_EMPTY){
+        memset(slot, 0, sizeof(dict_slot_t));
+        return PA_SUCCESS;
+    }
+    return res;
+}
+
+/**
+ * @brief       Find slot of string or the empty slot where it should go
+ * @param[in]   vchmgr_idx: varchar manager index
+ * @param[in]   dict: copy of dictionary header
+ * @param[in]   str: string to find
+ * @param[in]   hash: hash of the string
+ * @param[out]  code: code of the string or DICT_NOT_FOUND
+ * @return      position of the slot on success, DICT_FAIL on failure
+ */
+
+static int64_t dict_probe(int64_t vchmgr_idx, dict_t* dict, const char* str, uint32_t hash, int32_t* code){
+    int64_t mask = dict->capacity - 1;
+    for(int64_t pos = hash & mask;; pos = (pos + 1) & mask){
+        dict_slot_t slot;
+        if(dict_slot_read(dict->slots, pos, &slot) == PA_FAIL){
+            logger(LL_ERROR, __func__, "Unable to read slot %ld", pos);
+            return DICT_FAIL;
+        }
+        if(slot.ref == 0){
+            *code = DICT_NOT_FOUND;
+            return pos;
+        }
+        if(slot.hash != hash){
+            continue;
+        }
+        vch_ticket_t ticket;
+        if(pa_at(dict->strings, slot.ref - 1, &ticket) == PA_FAIL){
+            logger(LL_ERROR, __func__, "Unable to read string %d", slot.ref - 1);
+            return DICT_FAIL;
+        }
+        char* candidate = vch_acquire(vchmgr_idx, &ticket);
+        if(!candidate){
+            return DICT_FAIL;
+        }
+        bool equal = strcmp(candidate, str) == 0;
+        vch_release(&ticket, candidate);
+        if(equal){
+            *code = slot.ref - 1;
+            return pos;
+        }
+    }
+}
+
+/**
+ * @brief       Double capacity of hash table
+ * @param[in]   dictidx: index of the dictionary
+ * @return      PA_SUCCESS on success, PA_FAIL on failure
+ */
+
+static int dict_grow(int64_t dictidx){
+    dict_t dict = *dict_load(dictidx);
+    /* Dictionary may grow while queries allocate in temp space */
+    int space = pg_use_space(pg_space_of(dictidx));
+    int64_t slots = pa_init(sizeof(dict_slot_t));
+    pg_use_space(space);
+    if(slots == PA_FAIL){
+        logger(LL_ERROR, __func__, "Unable to allocate slots");
+        return PA_FAIL;
+    }
+    int64_t capacity = dict.capacity * 2;
+    for(int64_t i = 0; i < dict.capacity; i++){
+        dict_slot_t slot;
+        if(dict_slot_read(dict.slots, i, &slot) == PA_FAIL){
+            return PA_FAIL;
+        }
+        if(slot.ref == 0){
+            continue;
+        }
+        /* Strings are unique, first empty slot is the right one */
+        int64_t pos = slot.hash & (capacity - 1);
+        dict_slot_t other;
+        while(dict_slot_read(slots, pos, &other) == PA_SUCCESS && other.ref != 0){
+            pos = (pos + 1) & (capacity - 1);
+        }
+        if(pa_write(pa_load(slots), pos, &slot, sizeof(dict_slot_t), 0) == PA_FAIL){
+            logger(LL_ERROR, __func__, "Unable to write slot %ld", pos);
+            return PA_FAIL;
+        }
+    }
+    if(pa_destroy(dict.slots) == PA_FAIL){
+        logger(LL_ERROR, __func__, "Unable to destroy old slots");
+        return PA_FAIL;
+    }
+    dict_t* header = dict_load(dictidx);
+    header->slots = slots;
+    header->capacity = capacity;
+    return PA_SUCCESS;
+}
+
+/**
+ * @brief       Initialize a dictionary
+ * @return      index of the dictionary on success, DICT_FAIL on failure
+ */
+
+int64_t dict_init(void){
+    int64_t dictidx = lp_init_m(sizeof(dict_t));
+    if(dictidx == LP_FAIL){
+        logger(LL_ERROR, __func__, "Unable to allocate dictionary");
+        return DICT_FAIL;
+    }
+    int64_t strings = pa_init(sizeof(vch_ticket_t));
+    int64_t slots = pa_init(sizeof(dict_slot_t));
+    if(strings == PA_FAIL || slots == PA_FAIL){
+        logger(LL_ERROR, __func__, "Unable to initialize dictionary arrays");
+        return DICT_FAIL;
+    }
+    /* Parray initialization allocates pages, reload header after it */
+    dict_t* dict = dict_load(dictidx);
+    dict->strings = strings;
+    dict->slots = slots;
+    dict->capacity = DICT_INITIAL_CAPACITY;
+    return dictidx;
+}
+
+/**
+ * @brief       Get code of string, adding the string if it is new
+ * @param[in]   vchmgr_idx: varchar manager index
+ * @param[in]   dictidx: index of the dictionary
+ * @param[in]   str: string to intern
+ * @return      code of the string on success, DICT_FAIL on failure
+ */
+
+int32_t dict_intern(int64_t vchmgr_idx, int64_t dictidx, const char* str){
+    dict_t* header = dict_load(dictidx);
+    if(!header){
+        logger(LL_ERROR, __func__, "Unable to load dictionary %ld", dictidx);
+        return DICT_FAIL;
+    }
+    dict_t dict = *header;
+    uint32_t hash = (uint32_t) ht_str_hash(str);
+    int32_t code;
+    int64_t pos = dict_probe(vchmgr_idx, &dict, str, hash, &code);
+    if(pos == DICT_FAIL){
+        return DICT_FAIL;
+    }
+    if(code != DICT_NOT_FOUND){
+        return code;
+    }
+
+    int64_t size = pa_size(dict.strings);
+    if(size >= INT32_MAX){
+        logger(LL_ERROR, __func__, "Dictionary %ld is full", dictidx);
+        return DICT_FAIL;
+    }
+    code = (int32_t) size;
+    vch_ticket_t ticket;
+    if(vch_put(vchmgr_idx, str, &ticket, sizeof(vch_ticket_t)) == LB_FAIL ||
+       pa_append(dict.strings, &ticket, sizeof(vch_ticket_t)) == PA_FAIL){
+        logger(LL_ERROR, __func__, "Unable to store string");
+        return DICT_FAIL;
+    }
+    dict_slot_t slot = {.hash = hash, .ref = code + 1};
+    if(pa_write(pa_load(dict.slots), pos, &slot, sizeof(dict_slot_t), 0) == PA_FAIL){
+        logger(LL_ERROR, __func__, "Unable to write slot %ld", pos);
+        return DICT_FAIL;
+    }
+    if((int64_t)(code + 1) * 2 > dict.capacity && dict_grow(dictidx) == PA_FAIL){
+        logger(LL_ERROR, __func__, "Unable to grow dictionary %ld", dictidx);
+        return DICT_FAIL;
+    }
+    return code;
+}
+
+/**
+ * @brief       Get code of string without adding it
+ * @param[in]   vchmgr_idx: varchar manager index
+ * @param[in]   dictidx: index of the dictionary
+ * @param[in]   str: string to find
+ * @return      code of the string, DICT_NOT_FOUND if there is no such string, DICT_FAIL on failure
+ */
+
+int32_t dict_find(int64_t vchmgr_idx, int64_t dictidx, const char* str){
+    dict_t* header = dict_load(dictidx);
+    if(!header){
+        logger(LL_ERROR, __func__, "Unable to load dictionary %ld", dictidx);
+        return DICT_FAIL;
+    }
+    dict_t dict = *header;
+    int32_t code;
+    if(dict_probe(vchmgr_idx, &dict, str, (uint32_t) ht_str_hash(str), &code) == DICT_FAIL){
+        return DICT_FAIL;
+    }
+    return code;
+}
+
+/**
+ * @brief       Get ticket of string by code
+ * @param[in]   dictidx: index of the dictionary
+ * @param[in]   code: code of the string
+ * @param[out]  ticket: ticket of the string
+ * @return      PA_SUCCESS on success, PA_FAIL on failure
+ */
+
+int dict_ticket(int64_t dictidx, int32_t code, vch_ticket_t* ticket){
+    dict_t* dict = dict_load(dictidx);
+    if(!dict){
+        logger(LL_ERROR, __func__, "Unable to load dictionary %ld", dictidx);
+        return PA_FAIL;
+    }
+    return pa_at(dict->strings, code, ticket);
+}
+
+/**
+ * @brief       Get number of strings in dictionary
+ * @param[in]   dictidx: index of the dictionary
+ * @return      number of strings on success, DICT_FAIL on failure
+ */
+
+int64_t dict_size(int64_t dictidx){
+    dict_t* dict = dict_load(dictidx);
+    if(!dict){
+        logger(LL_ERROR, __func__, "Unable to load dictionary %ld", dictidx);
+        return DICT_FAIL;
+    }
+    return pa_size(dict->strings);
+}
+
+/**
+ * @brief       Destroy dictionary and its strings
+ * @param[in]   vchmgr_idx: varchar manager index
+ * @param[in]   dictidx: index of the dictionary
+ * @return      PA_SUCCESS on success, PA_FAIL on failure
+ */
+
+int dict_destroy(int64_t vchmgr_idx, int64_t dictidx){
+    dict_t* header = dict_load(dictidx);
+    if(!header){
+        logger(LL_ERROR, __func__, "Unable to load dictionary %ld", dictidx);
+        return PA_FAIL;
+    }
+    dict_t dict = *header;
+    int64_t size = pa_size(dict.strings);
+    for(int64_t code = 0; code < size; code++){
+        vch_ticket_t ticket;
+        if(pa_at(dict.strings, code, &ticket) == PA_FAIL ||
+           vch_delete(vchmgr_idx, &ticket) == LB_FAIL){
+            logger(LL_ERROR, __func__, "Unable to delete string %ld", code);
+            return PA_FAIL;
+        }
+    }
+    if(pa_destroy(dict.strings) == PA_FAIL || pa_destroy(dict.slots) == PA_FAIL){
+        logger(LL_ERROR, __func__, "Unable to destroy dictionary arrays");
+        return PA_FAIL;
+    }
+    if(lp_delete(dictidx) == LP_FAIL){
+        logger(LL_ERROR, __func__, "Unable to deallocate dictionary");
+        return PA_FAIL;
+    }
+    return PA_SUCCESS;
+}
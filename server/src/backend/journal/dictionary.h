@@ -0,0 +1,47 @@
+#pragma once
+
+#include "backend/journal/varchar_mgr.h"
+#include "backend/utils/parray.h"
+#include <stdint.h>
+
+/**
+ * Dictionary of a low-cardinality varchar column. Every distinct string is
+ * stored once in the strings parray and is identified by its position there,
+ * rows keep only the 4-byte code. Open addressing hash table of slots maps
+ * strings to codes, it grows twice when it gets half full.
+ */
+
+#ifndef DICT_INITIAL_CAPACITY
+#define DICT_INITIAL_CAPACITY 64
+#endif
+
+#define DICT_NONE (-1)
+#define DICT_NOT_FOUND (-1)
+#define DICT_FAIL (-2)
+
+typedef struct dict_slot{
+    uint32_t hash;
+    int32_t ref;
+} dict_slot_t;
+
+typedef struct dict{
+    linked_page_t lp_header;
+    int64_t strings;
+    int64_t slots;
+    int64_t capacity;
+} dict_t;
+
+/**
+ * @brief       Load a dictionary
+ * @param[in]   dictidx: index of the dictionary
+ * @return      pointer to the dictionary on success, NULL on failure
+ */
+
+#define dict_load(dictidx) ((dict_t*)lp_load(dictidx))
+
+int64_t dict_init(void);
+int32_t dict_intern(int64_t vchmgr_idx, int64_t dictidx, const char* str);
+int32_t dict_find(int64_t vchmgr_idx, int64_t dictidx, const char* str);
+int dict_ticket(int64_t dictidx, int32_t code, vch_ticket_t* ticket);
+int64_t dict_size(int64_t dictidx);
+int dict_destroy(int64_t vchmgr_idx, int64_t dictidx);
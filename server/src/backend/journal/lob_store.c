@@ -0,0 +1,189 @@
+#include "lob_store.h"
+#include "core/io/pager.h"
+#include "utils/logger.h"
+#include <string.h>
+
+#define lob_header_size(extent_count) ((int64_t)sizeof(lob_header_t) + (extent_count) * (int64_t)sizeof(lob_extent_t))
+#define lob_pages(bytes) (((bytes) + PAGE_SIZE - 1) / PAGE_SIZE)
+
+/**
+ * @brief       Loads header of large object
+ * @param[in]   lob: index of large object
+ * @return      pointer to header or NULL
+ */
+
+static lob_header_t* lob_load(int64_t lob){
+    lob_header_t* header = (lob_header_t*) pg_load_page(lob);
+    if(!header){
+        logger(LL_ERROR, __func__, "Unable to load large object %ld", lob);
+    }
+    return header;
+}
+
+/**
+ * @brief       Writes large object
+ * @param[in]   data: source
+ * @param[in]   size: size of source
+ * @return      index of large object or LOB_FAIL
+ */
+
+int64_t lob_write(const void* data, int64_t size){
+    /* Header size depends on number of extents, which depends on total size */
+    int64_t extent_count = 1;
+    int64_t pages = lob_pages(lob_header_size(extent_count) + size);
+    while((pages + LOB_MAX_RUN - 1) / LOB_MAX_RUN > extent_count){
+        extent_count = (pages + LOB_MAX_RUN - 1) / LOB_MAX_RUN;
+        pages = lob_pages(lob_header_size(extent_count) + size);
+    }
+    if(lob_header_size(extent_count) > PAGE_SIZE){
+        logger(LL_ERROR, __func__, "Large object of %ld bytes is too big", size);
+        return LOB_FAIL;
+    }
+
+    lob_extent_t extents[extent_count];
+    for(int64_t i = 0; i < extent_count; i++){
+        extents[i].page_count = pages - i * LOB_MAX_RUN < LOB_MAX_RUN ? pages - i * LOB_MAX_RUN : LOB_MAX_RUN;
+        extents[i].first_page = pg_alloc_run(extents[i].page_count);
+        if(extents[i].first_page == PAGER_FAIL){
+            logger(LL_ERROR, __func__, "Unable to allocate run of %ld pages", extents[i].page_count);
+            return LOB_FAIL;
+        }
+    }
+
+    int64_t lob = extents[0].first_page;
+    lob_header_t* header = lob_load(lob);
+    if(!header){
+        return LOB_FAIL;
+    }
+    header->size = size;
+    header->extent_count = extent_count;
+    memcpy(header->extents, extents, extent_count * sizeof(lob_extent_t));
+
+    const char* src = data;
+    int64_t offset = lob_header_size(extent_count);
+    for(int64_t i = 0; i < extent_count && size > 0; i++){
+        for(int64_t page = 0; page < extents[i].page_count && size > 0; page++){
+            int64_t chunk = PAGE_SIZE - offset < size ? PAGE_SIZE - offset : size;
+            if(pg_write(extents[i].first_page + page, (void*) src, chunk, offset) == PAGER_FAIL){
+                logger(LL_ERROR, __func__, "Unable to write page %ld", extents[i].first_page + page);
+                return LOB_FAIL;
+            }
+            src += chunk;
+            size -= chunk;
+            offset = 0;
+        }
+    }
+    return lob;
+}
+
+/**
+ * @brief       Get size of large object
+ * @param[in]   lob: index of large object
+ * @return      size or LOB_FAIL
+ */
+
+int64_t lob_size(int64_t lob){
+    lob_header_t* header = lob_load(lob);
+    return header ? header->size : LOB_FAIL;
+}
+
+/**
+ * @brief       Opens stream over large object
+ * @param[in]   lob: index of large object
+ * @param[out]  stream: stream to initialize
+ * @return      LOB_SUCCESS or LOB_FAIL
+ */
+
+int lob_stream_open(int64_t lob, lob_stream_t* stream){
+    if(!lob_load(lob)){
+        return LOB_FAIL;
+    }
+    stream->lob = lob;
+    stream->pos = 0;
+    stream->extent = 0;
+    stream->page = 0;
+    return LOB_SUCCESS;
+}
+
+/**
+ * @brief       Get next chunk of large object without copying
+ * @param[in]   stream: opened stream
+ * @param[out]  chunk: pointer to data in page, valid until page is deallocated
+ * @return      size of chunk, 0 at the end of object, LOB_FAIL on failure
+ */
+
+int64_t lob_stream_next(lob_stream_t* stream, const char** chunk){
+    lob_header_t* header = lob_load(stream->lob);
+    if(!header){
+        return LOB_FAIL;
+    }
+    if(stream->pos >= header->size){
+        return 0;
+    }
+    lob_extent_t* extent = &header->extents[stream->extent];
+    int64_t offset = stream->pos == 0 ? lob_header_size(header->extent_count) : 0;
+    char* page = pg_load_page(extent->first_page + stream->page);
+    if(!page){
+        logger(LL_ERROR, __func__, "Unable to load page %ld", extent->first_page + stream->page);
+        return LOB_FAIL;
+    }
+    int64_t left = header->size - stream->pos;
+    int64_t size = PAGE_SIZE - offset < left ? PAGE_SIZE - offset : left;
+    *chunk = page + offset;
+    stream->pos += size;
+    if(++stream->page == extent->page_count){
+        stream->page = 0;
+        stream->extent++;
+    }
+    return size;
+}
+
+/**
+ * @brief       Read whole large object
+ * @param[in]   lob: index of large object
+ * @param[out]  dest: destination
+ * @param[in]   size: size of destination
+ * @return      LOB_SUCCESS or LOB_FAIL
+ */
+
+int lob_read(int64_t lob, void* dest, int64_t size){
+    lob_stream_t stream;
+    if(lob_stream_open(lob, &stream) == LOB_FAIL){
+        return LOB_FAIL;
+    }
+    char* out = dest;
+    const char* chunk;
+    int64_t len = 0;
+    while(size > 0 && (len = lob_stream_next(&stream, &chunk)) > 0){
+        len = len < size ? len : size;
+        memcpy(out, chunk, len);
+        out += len;
+        size -= len;
+    }
+    return len == LOB_FAIL ? LOB_FAIL : LOB_SUCCESS;
+}
+
+/**
+ * @brief       Delete large object
+ * @param[in]   lob: index of large object
+ * @return      LOB_SUCCESS or LOB_FAIL
+ */
+
+int lob_delete(int64_t lob){
+    lob_header_t* header = lob_load(lob);
+    if(!header){
+        return LOB_FAIL;
+    }
+    int64_t extent_count = header->extent_count;
+    lob_extent_t extents[extent_count];
+    memcpy(extents, header->extents, extent_count * sizeof(lob_extent_t));
+    for(int64_t i = 0; i < extent_count; i++){
+        for(int64_t page = 0; page < extents[i].page_count; page++){
+            if(pg_dealloc(extents[i].first_page + page) == PAGER_FAIL){
+                logger(LL_ERROR, __func__, "Unable to deallocate page %ld", extents[i].first_page + page);
+                return LOB_FAIL;
+            }
+        }
+    }
+    return LOB_SUCCESS;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Large objects are stored in runs of contiguous pages. The first page of
+ * the first run starts with lob_header_t holding the size of the object and
+ * the list of its extents; data follows the header and continues through
+ * the extents in order. Object is identified by its header page index.
+ */
+
+#ifndef LOB_MAX_RUN
+#define LOB_MAX_RUN 256
+#endif
+
+typedef struct lob_extent{
+    int64_t first_page;
+    int64_t page_count;
+} lob_extent_t;
+
+typedef struct lob_header{
+    int64_t size;
+    int64_t extent_count;
+    lob_extent_t extents[];
+} lob_header_t;
+
+typedef struct lob_stream{
+    int64_t lob;
+    int64_t pos;
+    int64_t extent;
+    int64_t page;
+} lob_stream_t;
+
+typedef enum {LOB_SUCCESS = 0, LOB_FAIL = -1} lob_status_t;
+
+int64_t lob_write(const void* data, int64_t size);
+int64_t lob_size(int64_t lob);
+int lob_read(int64_t lob, void* dest, int64_t size);
+int lob_stream_open(int64_t lob, lob_stream_t* stream);
+int64_t lob_stream_next(lob_stream_t* stream, const char** chunk);
+int lob_delete(int64_t lob);
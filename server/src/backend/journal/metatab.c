@@ -1,7 +1,248 @@
 #include "metatab.h"
 #include "backend/table/schema.h"
+#include "utils/hashtable.h"
 #include "utils/logger.h"
 
+typedef struct mtab_entry{
+    int64_t index;
+    chblix_t rowix;
+    struct mtab_name* name;
+    struct mtab_entry* prev_same;
+    struct mtab_entry* next_same;
+    struct mtab_entry* next;
+} mtab_entry_t;
+
+typedef struct mtab_name{
+    char name[MAX_NAME_LENGTH + 1];
+    uint32_t hash;
+    mtab_entry_t* first;
+    mtab_entry_t* last;
+    struct mtab_name* next;
+} mtab_name_t;
+
+typedef struct mtab_index{
+    int64_t metatab_idx;
+    int64_t bucket_count;
+    int64_t entry_count;
+    mtab_name_t** names;
+    mtab_entry_t** entries;
+} mtab_index_t;
+
+static mtab_index_t mtab_index = {.metatab_idx = TABLE_FAIL};
+
+#define mtab_index_bucket(hash) ((int64_t)((uint64_t)(hash) & (uint64_t)(mtab_index.bucket_count - 1)))
+
+/**
+ * @brief       Make null terminated key of table name as it is stored in the metatable
+ * @param[in]   name: name of the table
+ * @param[out]  key: destination of MAX_NAME_LENGTH + 1 bytes
+ * @return      hash of the key
+ */
+
+static uint32_t mtab_key(const char* name, char* key){
+    strncpy(key, name, MAX_NAME_LENGTH);
+    key[MAX_NAME_LENGTH] = '\0';
+    return (uint32_t) ht_str_hash(key);
+}
+
+/**
+ * @brief       Find name in the index
+ * @param[in]   key: key made by mtab_key
+ * @param[in]   hash: hash of the key
+ * @return      pointer to name or NULL if there is no table with such name
+ */
+
+static mtab_name_t* mtab_index_name(const char* key, uint32_t hash){
+    mtab_name_t* name = mtab_index.names[mtab_index_bucket(hash)];
+    while(name && (name->hash != hash || strcmp(name->name, key) != 0)){
+        name = name->next;
+    }
+    return name;
+}
+
+/**
+ * @brief       Double number of buckets of the index
+ * @return      TABLE_SUCCESS on success, TABLE_FAIL on failure
+ */
+
+static int mtab_index_grow(void){
+    int64_t bucket_count = mtab_index.bucket_count * 2;
+    mtab_name_t** names = calloc(bucket_count, sizeof(mtab_name_t*));
+    mtab_entry_t** entries = calloc(bucket_count, sizeof(mtab_entry_t*));
+    if(!names || !entries){
+        logger(LL_ERROR, __func__, "Unable to allocate %ld buckets", bucket_count);
+        free(names);
+        free(entries);
+        return TABLE_FAIL;
+    }
+    for(int64_t i = 0; i < mtab_index.bucket_count; i++){
+        for(mtab_name_t* name = mtab_index.names[i], *next; name; name = next){
+            next = name->next;
+            int64_t bucket = (int64_t)(name->hash & (uint64_t)(bucket_count - 1));
+            name->next = names[bucket];
+            names[bucket] = name;
+        }
+        for(mtab_entry_t* entry = mtab_index.entries[i], *next; entry; entry = next){
+            next = entry->next;
+            int64_t bucket = (int64_t)((uint64_t) entry->index & (uint64_t)(bucket_count - 1));
+            entry->next = entries[bucket];
+            entries[bucket] = entry;
+        }
+    }
+    free(mtab_index.names);
+    free(mtab_index.entries);
+    mtab_index.names = names;
+    mtab_index.entries = entries;
+    mtab_index.bucket_count = bucket_count;
+    return TABLE_SUCCESS;
+}
+
+/**
+ * @brief       Add table to the index
+ * @param[in]   name: name of the table
+ * @param[in]   index: index of the table
+ * @param[in]   rowix: row of the table in the metatable
+ * @return      TABLE_SUCCESS on success, TABLE_FAIL on failure
+ */
+
+static int mtab_index_put(const char* name, int64_t index, chblix_t rowix){
+    if(mtab_index.entry_count >= mtab_index.bucket_count && mtab_index_grow() == TABLE_FAIL){
+        return TABLE_FAIL;
+    }
+    char key[MAX_NAME_LENGTH + 1];
+    uint32_t hash = mtab_key(name, key);
+    mtab_name_t* tab_name = mtab_index_name(key, hash);
+    if(!tab_name){
+        tab_name = calloc(1, sizeof(mtab_name_t));
+        if(!tab_name){
+            logger(LL_ERROR, __func__, "Unable to allocate name %s", key);
+            return TABLE_FAIL;
+        }
+        memcpy(tab_name->name, key, sizeof(key));
+        tab_name->hash = hash;
+        int64_t bucket = mtab_index_bucket(hash);
+        tab_name->next = mtab_index.names[bucket];
+        mtab_index.names[bucket] = tab_name;
+    }
+    mtab_entry_t* entry = calloc(1, sizeof(mtab_entry_t));
+    if(!entry){
+        logger(LL_ERROR, __func__, "Unable to allocate entry of table %ld", index);
+        return TABLE_FAIL;
+    }
+    entry->index = index;
+    entry->rowix = rowix;
+    entry->name = tab_name;
+    entry->prev_same = tab_name->last;
+    if(tab_name->last){
+        tab_name->last->next_same = entry;
+    } else {
+        tab_name->first = entry;
+    }
+    tab_name->last = entry;
+    int64_t bucket = mtab_index_bucket(index);
+    entry->next = mtab_index.entries[bucket];
+    mtab_index.entries[bucket] = entry;
+    mtab_index.entry_count++;
+    return TABLE_SUCCESS;
+}
+
+/**
+ * @brief       Remove table from the index
+ * @param[in]   index: index of the table
+ * @return      removed entry to be freed by caller or NULL if there is no such table
+ */
+
+static mtab_entry_t* mtab_index_take(int64_t index){
+    mtab_entry_t** link = &mtab_index.entries[mtab_index_bucket(index)];
+    while(*link && (*link)->index != index){
+        link = &(*link)->next;
+    }
+    mtab_entry_t* entry = *link;
+    if(!entry){
+        return NULL;
+    }
+    *link = entry->next;
+    mtab_index.entry_count--;
+
+    mtab_name_t* tab_name = entry->name;
+    if(entry->prev_same){
+        entry->prev_same->next_same = entry->next_same;
+    } else {
+        tab_name->first = entry->next_same;
+    }
+    if(entry->next_same){
+        entry->next_same->prev_same = entry->prev_same;
+    } else {
+        tab_name->last = entry->prev_same;
+    }
+    if(!tab_name->first){
+        mtab_name_t** name_link = &mtab_index.names[mtab_index_bucket(tab_name->hash)];
+        while(*name_link != tab_name){
+            name_link = &(*name_link)->next;
+        }
+        *name_link = tab_name->next;
+        free(tab_name);
+    }
+    return entry;
+}
+
+/**
+ * @brief       Drop the index of the metatable
+ * @note        called when database file is opened or closed
+ */
+
+void mtab_index_clear(void){
+    for(int64_t i = 0; i < mtab_index.bucket_count; i++){
+        for(mtab_name_t* name = mtab_index.names[i], *next; name; name = next){
+            next = name->next;
+            free(name);
+        }
+        for(mtab_entry_t* entry = mtab_index.entries[i], *next; entry; entry = next){
+            next = entry->next;
+            free(entry);
+        }
+    }
+    free(mtab_index.names);
+    free(mtab_index.entries);
+    memset(&mtab_index, 0, sizeof(mtab_index_t));
+    mtab_index.metatab_idx = TABLE_FAIL;
+}
+
+/**
+ * @brief       Build the index of the metatable unless it is built
+ * @param[in]   meta_table: pointer to the metatable
+ * @return      TABLE_SUCCESS on success, TABLE_FAIL on failure
+ */
+
+static int mtab_index_build(table_t* meta_table){
+    int64_t metatab_idx = table_index(meta_table);
+    if(mtab_index.metatab_idx == metatab_idx){
+        return TABLE_SUCCESS;
+    }
+    mtab_index_clear();
+    mtab_index.bucket_count = MTAB_INITIAL_BUCKETS;
+    mtab_index.names = calloc(MTAB_INITIAL_BUCKETS, sizeof(mtab_name_t*));
+    mtab_index.entries = calloc(MTAB_INITIAL_BUCKETS, sizeof(mtab_entry_t*));
+    if(!mtab_index.names || !mtab_index.entries){
+        logger(LL_ERROR, __func__, "Unable to allocate index of metatable");
+        mtab_index_clear();
+        return TABLE_FAIL;
+    }
+    tab_row(
+            char NAME[MAX_NAME_LENGTH];
+            int64_t INDEX;
+            );
+    schema_t* schema = sch_load(meta_table->schidx);
+    tab_for_each_row(meta_table, chunk, rowix, &row, schema){
+        if(mtab_index_put(row.NAME, row.INDEX, rowix) == TABLE_FAIL){
+            mtab_index_clear();
+            return TABLE_FAIL;
+        }
+    }
+    mtab_index.metatab_idx = metatab_idx;
+    return TABLE_SUCCESS;
+}
+
 /**
  * @brief       Initialize the metatable
  * @param[out]  table: pointer to table;
@@ -40,17 +281,13 @@ int64_t mtab_find_table_by_name(int64_t metatab_idx, const char* name){
         logger(LL_ERROR, __func__, "Invalid argument: meta_table is NULL");
         return TABLE_FAIL;
     }
-    tab_row(
-            char NAME[MAX_NAME_LENGTH];
-            int64_t INDEX;
-            );
-    schema_t* schema = sch_load(meta_table->schidx);
-    tab_for_each_row(meta_table, chunk, chblix, &row, schema){
-        if(strcmp(name,row.NAME) == 0){
-            return row.INDEX;
-        }
+    if(mtab_index_build(meta_table) == TABLE_FAIL){
+        return TABLE_FAIL;
     }
-    return TABLE_FAIL;
+    char key[MAX_NAME_LENGTH + 1];
+    uint32_t hash = mtab_key(name, key);
+    mtab_name_t* tab_name = mtab_index_name(key, hash);
+    return tab_name ? tab_name->first->index : TABLE_FAIL;
 }
 
 /**
@@ -80,6 +317,10 @@ int mtab_add(int64_t metatab_idx, const char* name, int64_t index){
         logger(LL_ERROR, __func__, "Failed to insert row ");
         return TABLE_FAIL;
     }
+    /* Index that is not built yet will find the row by the scan */
+    if(mtab_index.metatab_idx == metatab_idx && mtab_index_put(name, index, res) == TABLE_FAIL){
+        mtab_index_clear();
+    }
     return TABLE_SUCCESS;
 }
 
@@ -96,19 +337,19 @@ int mtab_delete(int64_t metatab_idx, int64_t index){
         logger(LL_ERROR, __func__, "Invalid argument: meta_table is NULL");
         return TABLE_FAIL;
     }
-    tab_row(
-            char NAME[MAX_NAME_LENGTH];
-            int64_t INDEX;
-    );
-    schema_t* schema = sch_load(meta_table->schidx);
-    tab_for_each_row(meta_table, chunk, rowix, &row, schema) {
-        if(row.INDEX == index){
-            if (tab_delete_nova(meta_table,chunk, &rowix) == TABLE_FAIL) {
-                logger(LL_ERROR, __func__, "Failed to delete row ");
-                return TABLE_FAIL;
-            }
-            return TABLE_SUCCESS;
-        }
+    if(mtab_index_build(meta_table) == TABLE_FAIL){
+        return TABLE_FAIL;
+    }
+    mtab_entry_t* entry = mtab_index_take(index);
+    if(entry == NULL){
+        return TABLE_SUCCESS;
+    }
+    int res = tab_delete_row(meta_table, &entry->rowix);
+    free(entry);
+    if(res == TABLE_FAIL){
+        logger(LL_ERROR, __func__, "Failed to delete row ");
+        mtab_index_clear();
+        return TABLE_FAIL;
     }
     return TABLE_SUCCESS;
 }
@@ -2,7 +2,19 @@
 
 #include "backend/table/table_base.h"
 
+/**
+ * Names of tables are resolved through an in-memory index of the metatable,
+ * it is built by a single scan on the first access after the database is
+ * opened and is kept up to date by mtab_add and mtab_delete. Tables with
+ * the same name are kept in order of addition, lookup returns the first one.
+ */
+
+#ifndef MTAB_INITIAL_BUCKETS
+#define MTAB_INITIAL_BUCKETS 64
+#endif
+
 table_t* mtab_init(void);
 int64_t mtab_find_table_by_name(int64_t metatab_idx, const char* name);
 int mtab_add(int64_t metatab_idx, const char* name, int64_t index);
 int mtab_delete(int64_t metatab_idx, int64_t index);
+void mtab_index_clear(void);
@@ -1,4 +1,23 @@
 #include "varchar_mgr.h"
+#include "backend/journal/lob_store.h"
+#include "core/io/pager.h"
+#include "utils/hashtable.h"
+
+static const int64_t vch_class_sizes[VCH_CLASS_COUNT] = VCH_CLASS_SIZES;
+
+/**
+ * @brief       Get size class of string
+ * @param[in]   size: size of string with '\0'
+ * @return      index of size class or VCH_CLASS_COUNT if string goes to large object store
+ */
+
+static int vch_class(int64_t size){
+    int cls = 0;
+    while(cls < VCH_CLASS_COUNT && vch_class_sizes[cls] < size){
+        cls++;
+    }
+    return cls;
+}
 
 /**
  * @brief       Initialize the varchar manager
@@ -6,29 +25,103 @@
  */
 
 int64_t vch_init(void){
-    int64_t vch_vachar_mgr_idx =  lb_ppl_init(VCH_BLOCK_SIZE);
+    int64_t vch_vachar_mgr_idx = lp_init_m(sizeof(vch_mgr_t));
+    if(vch_vachar_mgr_idx == LP_FAIL){
+        logger(LL_ERROR, __func__, "Unable to allocate varchar manager");
+        return LP_FAIL;
+    }
+    for(int cls = 0; cls < VCH_CLASS_COUNT; cls++){
+        int64_t pool = ppl_init(vch_class_sizes[cls]);
+        if(pool == PPL_FAIL){
+            logger(LL_ERROR, __func__, "Unable to initialize pool of class %ld", vch_class_sizes[cls]);
+            return LP_FAIL;
+        }
+        /* Pool initialization allocates pages, reload header after it */
+        vch_mgr_t* mgr = (vch_mgr_t*) lp_load(vch_vachar_mgr_idx);
+        mgr->pools[cls] = pool;
+    }
     return vch_vachar_mgr_idx;
 }
 
+/**
+ * @brief       Put a varchar into a row slot
+ * @param[in]   vachar_mgr_idx: varchar manager index
+ * @param[in]   varchar: string to add
+ * @param[out]  slot: slot of slot_size bytes to write ticket to
+ * @param[in]   slot_size: size of the slot, defines inline capacity
+ * @return      LB_SUCCESS on success, LB_FAIL on failure
+ */
+
+int vch_put(int64_t vachar_mgr_idx, const char* varchar, vch_ticket_t* slot, int64_t slot_size){
+    int64_t size = (int64_t)strlen(varchar) + 1;
+    memset(slot, 0, slot_size);
+    slot->size = (int32_t) size;
+    slot->hash = (uint32_t) ht_str_hash(varchar);
+    if(size <= vch_inline_capacity(slot_size)){
+        slot->flags = VCH_INLINE;
+        memcpy(vch_inline_str(slot), varchar, size);
+        return LB_SUCCESS;
+    }
+    memcpy(slot->prefix, varchar, size < VCH_PREFIX_SIZE ? size : VCH_PREFIX_SIZE);
+
+    int cls = vch_class(size);
+    if(cls == VCH_CLASS_COUNT){
+        slot->flags = VCH_LOB;
+        /* Large objects belong to the space of the manager, not of the query */
+        int space = pg_use_space(pg_space_of(vachar_mgr_idx));
+        slot->lob = lob_write(varchar, size);
+        pg_use_space(space);
+        return slot->lob == LOB_FAIL ? LB_FAIL : LB_SUCCESS;
+    }
+
+    slot->flags = VCH_POOLED;
+    vch_mgr_t* mgr = (vch_mgr_t*) lp_load(vachar_mgr_idx);
+    if(!mgr){
+        logger(LL_ERROR, __func__, "Unable to load varchar manager");
+        return LB_FAIL;
+    }
+    int64_t pool = mgr->pools[cls];
+    slot->block = ppl_alloc(pool);
+    if(chblix_cmp(&slot->block, &CHBLIX_FAIL) == 0){
+        logger(LL_ERROR, __func__, "Unable to allocate varchar block");
+        return LB_FAIL;
+    }
+    if(ppl_write_block(pool, &slot->block, (void*) varchar, size, 0) == PPL_FAIL){
+        logger(LL_ERROR, __func__, "Unable to write varchar block");
+        return LB_FAIL;
+    }
+    return LB_SUCCESS;
+}
+
 /**
  * @brief       Add a varchar
  * @param[in]   vachar_mgr_idx: varchar manager index
  * @param[in]   varchar: string to add
- * @return      vch_ticket_t of varchar on success, CHBLIX_FAIL on failure
+ * @return      vch_ticket_t of varchar, spilled ticket has CHBLIX_FAIL block on failure
  */
 
 vch_ticket_t vch_add(int64_t vachar_mgr_idx, char* varchar){
     vch_ticket_t ticket;
-    page_pool_t* vch = lb_ppl_load(vachar_mgr_idx);
-    ticket.block = lb_alloc(vch);
-    ticket.size = (int64_t)strlen(varchar)+1;
-    lb_write(
-            vch,
-            &ticket.block,
-            varchar,
-            ticket.size,
-            0
-    );
+    vch_put(vachar_mgr_idx, varchar, &ticket, sizeof(vch_ticket_t));
+    return ticket;
+}
+
+/**
+ * @brief       Make ticket of string in memory without storing it
+ * @param[in]   varchar: string, must outlive the ticket
+ * @return      transient vch_ticket_t of varchar
+ * @note        transient ticket may be compared with stored ones, but must not be put into a row
+ */
+
+vch_ticket_t vch_transient(const char* varchar){
+    vch_ticket_t ticket;
+    int64_t size = (int64_t)strlen(varchar) + 1;
+    memset(&ticket, 0, sizeof(vch_ticket_t));
+    ticket.size = (int32_t) size;
+    ticket.flags = VCH_TRANSIENT;
+    ticket.hash = (uint32_t) ht_str_hash(varchar);
+    memcpy(ticket.prefix, varchar, size < VCH_PREFIX_SIZE ? size : VCH_PREFIX_SIZE);
+    ticket.str = varchar;
     return ticket;
 }
 
@@ -41,14 +134,109 @@ vch_ticket_t vch_add(int64_t vachar_mgr_idx, char* varchar){
  */
 
 int vch_get(int64_t vachar_mgr_idx, vch_ticket_t* ticket, char* varchar){
+    switch (ticket->flags) {
+        case VCH_INLINE:
+            memcpy(varchar, vch_inline_str(ticket), ticket->size);
+            return LB_SUCCESS;
+        case VCH_LOB:
+            return lob_read(ticket->lob, varchar, ticket->size) == LOB_FAIL ? LB_FAIL : LB_SUCCESS;
+        case VCH_TRANSIENT:
+            memcpy(varchar, ticket->str, ticket->size);
+            return LB_SUCCESS;
+        default:
+            break;
+    }
     logger(LL_DEBUG, __func__, "ticket->block: %ld", ticket->block);
-    return lb_read(
-            vachar_mgr_idx,
-            &ticket->block,
-            varchar,
-            ticket->size,
-            0
-            );
+    vch_mgr_t* mgr = (vch_mgr_t*) lp_load(vachar_mgr_idx);
+    if(!mgr){
+        logger(LL_ERROR, __func__, "Unable to load varchar manager");
+        return LB_FAIL;
+    }
+    if(ppl_read_block(mgr->pools[vch_class(ticket->size)], &ticket->block, varchar, ticket->size, 0) == PPL_FAIL){
+        logger(LL_ERROR, __func__, "Unable to read varchar block");
+        return LB_FAIL;
+    }
+    return LB_SUCCESS;
+}
+
+/**
+ * @brief       Get pointer to a varchar without copying inline strings
+ * @param[in]   vachar_mgr_idx: varchar manager index
+ * @param[in]   ticket: ticket of varchar
+ * @return      pointer to string on success, NULL on failure
+ * @note        result must be passed to vch_release
+ */
+
+char* vch_acquire(int64_t vachar_mgr_idx, vch_ticket_t* ticket){
+    if(vch_is_inline(ticket)){
+        return vch_inline_str(ticket);
+    }
+    if(vch_is_transient(ticket)){
+        return (char*) ticket->str;
+    }
+    char* varchar = malloc(ticket->size);
+    if(!varchar){
+        logger(LL_ERROR, __func__, "Unable to allocate memory");
+        return NULL;
+    }
+    if(vch_get(vachar_mgr_idx, ticket, varchar) == LB_FAIL){
+        logger(LL_ERROR, __func__, "Unable to read varchar");
+        free(varchar);
+        return NULL;
+    }
+    return varchar;
+}
+
+/**
+ * @brief       Release string returned by vch_acquire
+ * @param[in]   ticket: ticket of varchar
+ * @param[in]   varchar: string returned by vch_acquire
+ */
+
+void vch_release(vch_ticket_t* ticket, char* varchar){
+    if(!vch_is_inline(ticket) && !vch_is_transient(ticket)){
+        free(varchar);
+    }
+}
+
+/**
+ * @brief       Compare two varchars
+ * @param[in]   vachar_mgr_idx: varchar manager index
+ * @param[in]   ticket1: ticket of the first varchar
+ * @param[in]   ticket2: ticket of the second varchar
+ * @return      result of strcmp of the strings
+ */
+
+int vch_cmp(int64_t vachar_mgr_idx, vch_ticket_t* ticket1, vch_ticket_t* ticket2){
+    /* Prefixes are zero padded, so memcmp orders them as strcmp does */
+    int res = memcmp(ticket1->prefix, ticket2->prefix, VCH_PREFIX_SIZE);
+    if(res != 0 || ticket1->size <= VCH_PREFIX_SIZE){
+        return res;
+    }
+    if(vch_is_inline(ticket1) && vch_is_inline(ticket2)){
+        return strcmp(vch_inline_str(ticket1), vch_inline_str(ticket2));
+    }
+    char* str1 = vch_acquire(vachar_mgr_idx, ticket1);
+    char* str2 = vch_acquire(vachar_mgr_idx, ticket2);
+    res = (str1 && str2) ? strcmp(str1, str2) : 0;
+    vch_release(ticket1, str1);
+    vch_release(ticket2, str2);
+    return res;
+}
+
+/**
+ * @brief       Check two varchars on equality
+ * @param[in]   vachar_mgr_idx: varchar manager index
+ * @param[in]   ticket1: ticket of the first varchar
+ * @param[in]   ticket2: ticket of the second varchar
+ * @return      true if strings are equal
+ */
+
+bool vch_eq(int64_t vachar_mgr_idx, vch_ticket_t* ticket1, vch_ticket_t* ticket2){
+    if(ticket1->size != ticket2->size || ticket1->hash != ticket2->hash){
+        return false;
+    }
+    return vch_cmp(vachar_mgr_idx, ticket1, ticket2) == 0;
 }
 
 /**
@@ -59,7 +247,23 @@ int vch_get(int64_t vachar_mgr_idx, vch_ticket_t* ticket, char* varchar){
  */
 
 int vch_delete(int64_t vachar_mgr_idx, vch_ticket_t* ticket){
-    return lb_dealloc(vachar_mgr_idx, &ticket->block);
+    switch (ticket->flags) {
+        case VCH_INLINE:
+        case VCH_TRANSIENT:
+            return LB_SUCCESS;
+        case VCH_LOB:
+            return lob_delete(ticket->lob) == LOB_FAIL ? LB_FAIL : LB_SUCCESS;
+        default:
+            break;
+    }
+    vch_mgr_t* mgr = (vch_mgr_t*) lp_load(vachar_mgr_idx);
+    if(!mgr){
+        logger(LL_ERROR, __func__, "Unable to load varchar manager");
+        return LB_FAIL;
+    }
+    if(ppl_dealloc(mgr->pools[vch_class(ticket->size)], &ticket->block) == PPL_FAIL){
+        logger(LL_ERROR, __func__, "Unable to deallocate varchar block");
+        return LB_FAIL;
+    }
+    return LB_SUCCESS;
 }
-
-
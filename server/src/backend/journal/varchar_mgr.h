@@ -2,16 +2,83 @@
 
 #include "core/page_pool/linked_blocks.h"
 #include "utils/logger.h"
+#include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
-#define VCH_BLOCK_SIZE 30
+/**
+ * Size classes of varchar pools, every spilled string takes one block of the
+ * smallest class that fits it. The largest class keeps two blocks per chunk
+ * of 4 KiB page. Strings longer than the largest class go to the large
+ * object store.
+ */
+
+#define VCH_CLASS_SIZES {32, 128, 512, 2000}
+#define VCH_CLASS_COUNT 4
+
+typedef enum {VCH_POOLED = 0, VCH_INLINE = 1, VCH_LOB = 2, VCH_TRANSIENT = 3} vch_flag_t;
+
+#define VCH_PREFIX_SIZE 12
+
+/**
+ * Varchar ticket stored in a row slot. Every ticket carries hash of the
+ * string and its first VCH_PREFIX_SIZE bytes padded with zeros, so most
+ * comparisons are decided without reading the string. Short strings are
+ * kept inline starting at the prefix and may occupy the whole slot: a column
+ * of slot size S stores strings up to vch_inline_capacity(S) bytes (with
+ * '\0') inline. Longer strings spill to the varchar manager and the ticket
+ * keeps the block of size class pool or the large object. Transient tickets
+ * of query constants point to a string in memory and are never stored.
+ */
 
 typedef struct vch_ticket{
-    chblix_t block;
-    int64_t size;
+    int32_t size;
+    int32_t flags;
+    uint32_t hash;
+    char prefix[VCH_PREFIX_SIZE];
+    union {
+        chblix_t block;
+        int64_t lob;
+        const char* str;
+    };
 }vch_ticket_t;
 
+_Static_assert(offsetof(vch_ticket_t, block) == offsetof(vch_ticket_t, prefix) + VCH_PREFIX_SIZE,
+               "Inline string must continue from prefix to the end of ticket");
+
+typedef struct vch_mgr{
+    linked_page_t lp_header;
+    int64_t pools[VCH_CLASS_COUNT];
+} vch_mgr_t;
+
+#define VCH_TICKET_HEADER ((int64_t)offsetof(vch_ticket_t, prefix))
+
+#ifndef VCH_DEFAULT_INLINE_SIZE
+#define VCH_DEFAULT_INLINE_SIZE ((int64_t)sizeof(vch_ticket_t) - VCH_TICKET_HEADER)
+#endif
+
+/* Longest inline capacity a column may be created with */
+#ifndef VCH_MAX_INLINE_SIZE
+#define VCH_MAX_INLINE_SIZE 512
+#endif
+
+#define vch_slot_size(inline_size) \
+    (VCH_TICKET_HEADER + (inline_size) > (int64_t)sizeof(vch_ticket_t) ? \
+     VCH_TICKET_HEADER + (inline_size) : (int64_t)sizeof(vch_ticket_t))
+#define vch_inline_capacity(slot_size) ((int64_t)(slot_size) - VCH_TICKET_HEADER)
+#define vch_is_inline(ticket) ((ticket)->flags == VCH_INLINE)
+#define vch_is_lob(ticket) ((ticket)->flags == VCH_LOB)
+#define vch_is_transient(ticket) ((ticket)->flags == VCH_TRANSIENT)
+#define vch_inline_str(ticket) ((char*)(ticket) + VCH_TICKET_HEADER)
+#define vch_hash(ticket) ((ticket)->hash)
+
 int64_t vch_init(void);
+int vch_put(int64_t vachar_mgr_idx, const char* varchar, vch_ticket_t* slot, int64_t slot_size);
 vch_ticket_t vch_add(int64_t vachar_mgr_idx, char* varchar);
+vch_ticket_t vch_transient(const char* varchar);
 int vch_get(int64_t vachar_mgr_idx, vch_ticket_t* ticket, char* varchar);
+char* vch_acquire(int64_t vachar_mgr_idx, vch_ticket_t* ticket);
+void vch_release(vch_ticket_t* ticket, char* varchar);
+int vch_cmp(int64_t vachar_mgr_idx, vch_ticket_t* ticket1, vch_ticket_t* ticket2);
+bool vch_eq(int64_t vachar_mgr_idx, vch_ticket_t* ticket1, vch_ticket_t* ticket2);
 int vch_delete(int64_t vachar_mgr_idx, vch_ticket_t* ticket);
@@ -0,0 +1,288 @@
+#include "join_cache.h"
+#include "backend/comparator/comparator.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+
+#define JC_MIN_BUCKETS 16
+
+static join_cache_t* jc_cache[JC_BUCKETS];
+static int64_t jc_budget = JC_MEMORY_BUDGET;
+static int64_t jc_total_memory = 0;
+static int64_t jc_tick = 0;
+
+/**
+ * @brief       Free join index
+ * @param[in]   jc: pointer to the join index
+ */
+
+static void jc_free(join_cache_t* jc){
+    jc_total_memory -= jc->memory;
+    free(jc->buckets);
+    free(jc->entries);
+    free(jc);
+}
+
+/**
+ * @brief       Unlink join index from its bucket and free it
+ * @param[in]   link: pointer to the link to the join index
+ */
+
+static void jc_remove(join_cache_t** link){
+    join_cache_t* jc = *link;
+    *link = jc->next;
+    jc_free(jc);
+}
+
+/**
+ * @brief       Drop least recently used join index
+ * @return      true if an index was dropped
+ */
+
+static bool jc_evict(void){
+    join_cache_t** oldest = NULL;
+    for(int64_t i = 0; i < JC_BUCKETS; i++){
+        for(join_cache_t** link = &jc_cache[i]; *link; link = &(*link)->next){
+            if(!oldest || (*link)->last_used < (*oldest)->last_used){
+                oldest = link;
+            }
+        }
+    }
+    if(!oldest){
+        return false;
+    }
+    jc_remove(oldest);
+    return true;
+}
+
+/**
+ * @brief       Link entries of join index into buckets, their number is at least twice the entries
+ * @param[in]   jc: pointer to the join index, freed on failure
+ * @return      true on success, false on failure or when the index exceeds the budget
+ */
+
+static bool jc_link(join_cache_t* jc){
+    int64_t bucket_count = JC_MIN_BUCKETS;
+    while(bucket_count < 2 * jc->count){
+        bucket_count *= 2;
+    }
+    if(!jc->buckets || bucket_count != jc->bucket_count){
+        int64_t memory = (int64_t) sizeof(join_cache_t) + bucket_count * (int64_t) sizeof(int64_t) +
+                         jc->capacity * (int64_t) sizeof(jc_entry_t);
+        int64_t* buckets = memory <= jc_budget ? realloc(jc->buckets, bucket_count * sizeof(int64_t)) : NULL;
+        if(!buckets){
+            jc_free(jc);
+            return false;
+        }
+        jc->buckets = buckets;
+        jc->bucket_count = bucket_count;
+        jc_total_memory += memory - jc->memory;
+        jc->memory = memory;
+    }
+    for(int64_t i = 0; i < jc->bucket_count; i++){
+        jc->buckets[i] = -1;
+    }
+    /* Chains are filled from the end to keep order of rows */
+    for(int64_t i = jc->count - 1; i >= 0; i--){
+        int64_t bucket = (int64_t) (jc->entries[i].hash & (uint64_t) (jc->bucket_count - 1));
+        jc->entries[i].next = jc->buckets[bucket];
+        jc->buckets[bucket] = i;
+    }
+    return true;
+}
+
+/**
+ * @brief       Build join index of column
+ * @param[in]   table: pointer to the table
+ * @param[in]   field: the column
+ * @param[in]   version: version of the schema
+ * @return      pointer to the join index on success, NULL on failure or when it exceeds the budget
+ */
+
+static join_cache_t* jc_build(table_t* table, field_t* field, int64_t version){
+    join_cache_t* jc = calloc(1, sizeof(join_cache_t));
+    void* element = malloc(field->size);
+    if(!jc || !element){
+        logger(LL_ERROR, __func__, "Unable to allocate join index of %s", field->name);
+        free(jc);
+        free(element);
+        return NULL;
+    }
+    jc->tablix = table_index(table);
+    jc->version = version;
+    jc->field = *field;
+    int64_t capacity = 0;
+    tab_for_each_element(table, chunk, chblix, element, field){
+        if(jc->count == capacity){
+            capacity = capacity ? 2 * capacity : JC_MIN_BUCKETS;
+            jc_entry_t* entries = (int64_t) sizeof(join_cache_t) + capacity * (int64_t) sizeof(jc_entry_t) <= jc_budget
+                                  ? realloc(jc->entries, capacity * sizeof(jc_entry_t)) : NULL;
+            if(!entries){
+                free(element);
+                jc_free(jc);
+                return NULL;
+            }
+            jc->entries = entries;
+        }
+        jc->entries[jc->count].hash = comp_hash_field(field, element, false);
+        jc->entries[jc->count].rowix = chblix;
+        jc->count++;
+    }
+    free(element);
+    jc->capacity = capacity;
+    return jc_link(jc) ? jc : NULL;
+}
+
+/**
+ * @brief       Get join index of column, building it if needed
+ * @param[in]   table: pointer to the table
+ * @param[in]   field: the column
+ * @return      pointer to the join index on success, NULL on failure or when it does not fit the budget
+ * @warning     join index is valid until the next write to the table or the next jc_load
+ */
+
+join_cache_t* jc_load(table_t* table, field_t* field){
+    schema_t* schema = sch_load(table->schidx);
+    if(!schema){
+        logger(LL_ERROR, __func__, "Unable to load schema of table %s", table->name);
+        return NULL;
+    }
+    int64_t tablix = table_index(table);
+    join_cache_t** link = &jc_cache[tablix % JC_BUCKETS];
+    while(*link && ((*link)->tablix != tablix || (*link)->field.offset != field->offset ||
+                    strcmp((*link)->field.name, field->name) != 0)){
+        link = &(*link)->next;
+    }
+    if(*link && (*link)->version == schema->version){
+        (*link)->last_used = ++jc_tick;
+        return *link;
+    }
+    if(*link){
+        jc_remove(link);
+    }
+
+    join_cache_t* jc = jc_build(table, field, schema->version);
+    if(!jc){
+        return NULL;
+    }
+    while(jc_total_memory > jc_budget && jc_evict());
+    jc->last_used = ++jc_tick;
+    jc->next = jc_cache[tablix % JC_BUCKETS];
+    jc_cache[tablix % JC_BUCKETS] = jc;
+    return jc;
+}
+
+/**
+ * @brief       Add entry of inserted row to join index
+ * @param[in]   jc: pointer to the join index, freed on failure
+ * @param[in]   rowix: chblix of the row
+ * @param[in]   row: the row
+ * @return      true on success, false on failure or when the index outgrows the budget
+ */
+
+static bool jc_add(join_cache_t* jc, chblix_t* rowix, void* row){
+    if(jc->count == jc->capacity){
+        int64_t capacity = jc->capacity ? 2 * jc->capacity : JC_MIN_BUCKETS;
+        int64_t memory = jc->memory + (capacity - jc->capacity) * (int64_t) sizeof(jc_entry_t);
+        jc_entry_t* entries = memory <= jc_budget ? realloc(jc->entries, capacity * sizeof(jc_entry_t)) : NULL;
+        if(!entries){
+            jc_free(jc);
+            return false;
+        }
+        jc->entries = entries;
+        jc->capacity = capacity;
+        jc_total_memory += memory - jc->memory;
+        jc->memory = memory;
+    }
+    jc_entry_t* entry = &jc->entries[jc->count++];
+    entry->hash = comp_hash_field(&jc->field, (char*) row + jc->field.offset, false);
+    entry->rowix = *rowix;
+    entry->next = -1;
+    if(jc->bucket_count < 2 * jc->count){
+        return jc_link(jc);
+    }
+    /* Appended to the end of its chain like rows after it in jc_build */
+    int64_t* link = &jc->buckets[entry->hash & (uint64_t) (jc->bucket_count - 1)];
+    while(*link != -1){
+        link = &jc->entries[*link].next;
+    }
+    *link = jc->count - 1;
+    return true;
+}
+
+/**
+ * @brief       Add inserted row to join indexes of the table
+ * @param[in]   tablix: index of the table
+ * @param[in]   rowix: chblix of the row
+ * @param[in]   row: the row
+ */
+
+void jc_insert(int64_t tablix, chblix_t* rowix, void* row){
+    join_cache_t** link = &jc_cache[tablix % JC_BUCKETS];
+    while(*link){
+        join_cache_t* jc = *link;
+        if(jc->tablix != tablix){
+            link = &jc->next;
+            continue;
+        }
+        /* Index which can not take the row is freed by jc_add */
+        join_cache_t* next = jc->next;
+        if(jc_add(jc, rowix, row)){
+            link = &jc->next;
+        } else {
+            *link = next;
+        }
+    }
+    while(jc_total_memory > jc_budget && jc_evict());
+}
+
+/**
+ * @brief       Drop join indexes of columns of the table in rewritten part of row
+ * @param[in]   tablix: index of the table
+ * @param[in]   offset: offset of the part in row
+ * @param[in]   size: size of the part
+ */
+
+void jc_invalidate(int64_t tablix, int64_t offset, int64_t size){
+    join_cache_t** link = &jc_cache[tablix % JC_BUCKETS];
+    while(*link){
+        join_cache_t* jc = *link;
+        if(jc->tablix == tablix && (int64_t) jc->field.offset < offset + size &&
+           (int64_t) (jc->field.offset + jc->field.size) > offset){
+            jc_remove(link);
+        } else {
+            link = &jc->next;
+        }
+    }
+}
+
+/**
+ * @brief       Get memory taken by join indexes
+ * @return      number of bytes
+ */
+
+int64_t jc_memory(void){
+    return jc_total_memory;
+}
+
+/**
+ * @brief       Set memory budget of join indexes, least recently used ones are dropped to fit it
+ * @param[in]   budget: number of bytes
+ */
+
+void jc_set_budget(int64_t budget){
+    jc_budget = budget;
+    while(jc_total_memory > jc_budget && jc_evict());
+}
+
+/**
+ * @brief       Drop all join indexes
+ * @note        called when database file is opened or closed
+ */
+
+void jc_clear(void){
+    for(int64_t i = 0; i < JC_BUCKETS; i++){
+        while(jc_cache[i]){
+            jc_remove(&jc_cache[i]);
+        }
+    }
+}
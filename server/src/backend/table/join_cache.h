@@ -0,0 +1,64 @@
+#pragma once
+
+#include "table_base.h"
+#include <stdint.h>
+
+/**
+ * In-memory join indexes of table columns kept between queries. A join
+ * index maps hash of every element of the column to chblix of its row, so a
+ * join probes it and reads only rows whose hash matches. Indexes are built
+ * on first use, inserted rows are added to them. They are dropped when a
+ * stored row of the table is rewritten or deleted in the range of the column,
+ * when the schema changes and when the database is closed. Total memory of
+ * indexes stays under the budget, JC_MEMORY_BUDGET unless set by
+ * jc_set_budget, least recently used ones are dropped first, index larger
+ * than the budget is not built.
+ */
+
+#ifndef JC_MEMORY_BUDGET
+#define JC_MEMORY_BUDGET (64 * 1024 * 1024)
+#endif
+
+#ifndef JC_BUCKETS
+#define JC_BUCKETS 16
+#endif
+
+typedef struct jc_entry{
+    uint64_t hash;
+    chblix_t rowix;
+    int64_t next; //next entry of the bucket or -1
+} jc_entry_t;
+
+typedef struct join_cache{
+    int64_t tablix;
+    int64_t version; //version of the schema the index was built with
+    field_t field;
+    int64_t bucket_count;
+    int64_t* buckets;
+    int64_t count;
+    int64_t capacity;
+    jc_entry_t* entries;
+    int64_t memory;
+    int64_t last_used;
+    struct join_cache* next;
+} join_cache_t;
+
+/**
+ * @brief       For each row with element of the hash
+ * @param[in]   jc: pointer to the join index
+ * @param[in]   hash_value: hash of the element
+ * @param[in]   rowix: name of pointer to chblix of the row
+ */
+
+#define jc_for_each_match(jc, hash_value, rowix) \
+    for(int64_t jc_i_##rowix = (jc)->buckets[(hash_value) & (uint64_t)((jc)->bucket_count - 1)]; jc_i_##rowix != -1; \
+        jc_i_##rowix = (jc)->entries[jc_i_##rowix].next) \
+        for(chblix_t* rowix = &(jc)->entries[jc_i_##rowix].rowix; \
+            rowix != NULL && (jc)->entries[jc_i_##rowix].hash == (hash_value); rowix = NULL)
+
+join_cache_t* jc_load(table_t* table, field_t* field);
+void jc_insert(int64_t tablix, chblix_t* rowix, void* row);
+void jc_invalidate(int64_t tablix, int64_t offset, int64_t size);
+int64_t jc_memory(void);
+void jc_set_budget(int64_t budget);
+void jc_clear(void);
@@ -0,0 +1,752 @@
+#include "operator.h"
+#include "schema_desc.h"
+#include "utils/logger.h"
+#include "utils/simd.h"
+#include <stdlib.h>
+
+typedef struct op_scan{
+    table_t* table;
+    tab_row_pred_t pred;
+    void* arg;
+    chblix_t chblix; //next row to read
+    uint8_t* row;
+} op_scan_t;
+
+typedef struct op_filter{
+    tab_row_pred_t pred;
+    void* arg;
+} op_filter_t;
+
+typedef struct op_compare{
+    field_t field;
+    comp_pred_t pred;
+    simd_op_t op;
+    union {
+        int64_t int_val;
+        double float_val;
+        vch_ticket_t vch;
+    } value;
+    union {
+        int64_t ints[OP_BATCH_SIZE];
+        double floats[OP_BATCH_SIZE];
+    } column; //column of selected rows of batch
+    uint64_t mask[simd_mask_words(OP_BATCH_SIZE)];
+} op_compare_t;
+
+typedef struct op_join_entry{
+    uint64_t hash;
+    int64_t next; //next entry of the bucket or -1
+} op_join_entry_t;
+
+typedef struct op_join{
+    db_t* db;
+    field_t left_field;
+    field_t right_field;
+    bool by_code;
+    int64_t left_size;
+    int64_t right_size;
+    int64_t right_offset; //offset of the right row in joined rows, sch_join_offset of the left schema
+    /* Rows of the right input with hash table on them, built by open */
+    uint8_t* rows;
+    op_join_entry_t* entries;
+    int64_t count;
+    int64_t* buckets;
+    int64_t bucket_count;
+    /* Left row being probed */
+    uint8_t* left_row;
+    uint64_t hash;
+    int64_t match; //next entry of the chain to check or -1
+    /* Left batch being probed */
+    op_batch_t* left_batch;
+    int64_t left_pos;
+    uint64_t hashes[OP_BATCH_SIZE];
+    uint8_t* row;
+    uint8_t* left_el;
+    uint8_t* right_el;
+} op_join_t;
+
+typedef struct op_project{
+    int64_t num_of_fields;
+    field_t* fields;
+    int64_t* offsets; //offsets of fields in projected row
+    op_batch_t* input;
+    uint8_t* row;
+} op_project_t;
+
+/**
+ * @brief       Allocate operator with its state
+ * @param[in]   state_size: size of state, buffers of the state follow it in the same allocation
+ * @return      pointer to zeroed operator on success, NULL on failure
+ */
+
+static operator_t* op_alloc(int64_t state_size){
+    operator_t* op = calloc(1, sizeof(operator_t));
+    void* state = calloc(1, state_size);
+    if(!op || !state){
+        logger(LL_ERROR, __func__, "Unable to allocate operator");
+        free(op);
+        free(state);
+        return NULL;
+    }
+    op->state = state;
+    return op;
+}
+
+static int op_scan_open(operator_t* op){
+    op_scan_t* scan = op->state;
+    chunk_t* chunk = ppl_load_chunk(scan->table->ppl_header.head);
+    scan->chblix = lb_pool_start(&scan->table->ppl_header, &chunk);
+    return OP_SUCCESS;
+}
+
+/**
+ * @brief       Read the next row matching predicate of scan
+ * @param[in]   op: pointer to the scan
+ * @param[out]  dest: buffer of the row
+ * @return      OP_SUCCESS on success, OP_END when there are no more rows, OP_FAIL on failure
+ */
+
+static int op_scan_read(operator_t* op, uint8_t* dest){
+    op_scan_t* scan = op->state;
+    while(chblix_cmp(&scan->chblix, &CHBLIX_FAIL) != 0){
+        /* Chunk is loaded again every time, predicates and consumers may have evicted it */
+        chunk_t* chunk = ppl_load_chunk(scan->chblix.chunk_idx);
+        if(!chunk || tab_read_nova(scan->table, chunk, &scan->chblix, dest, op->schema->slot_size, 0) == TABLE_FAIL){
+            logger(LL_ERROR, __func__, "Unable to read row of table %s", scan->table->name);
+            return OP_FAIL;
+        }
+        scan->chblix.block_idx++;
+        scan->chblix = lb_nearest_valid_chblix(&scan->table->ppl_header, scan->chblix, &chunk);
+        if(!scan->pred || scan->pred(dest, scan->arg)){
+            return OP_SUCCESS;
+        }
+    }
+    return OP_END;
+}
+
+static int op_scan_next(operator_t* op, void** row){
+    op_scan_t* scan = op->state;
+    *row = scan->row;
+    return op_scan_read(op, scan->row);
+}
+
+static int op_scan_next_batch(operator_t* op, op_batch_t* batch){
+    int res = OP_SUCCESS;
+    batch->count = 0;
+    while(batch->count < OP_BATCH_SIZE &&
+          (res = op_scan_read(op, batch->rows + batch->count * batch->row_size)) == OP_SUCCESS){
+        batch->sel[batch->count] = (uint16_t) batch->count;
+        batch->count++;
+    }
+    batch->selected = batch->count;
+    if(res == OP_FAIL){
+        return OP_FAIL;
+    }
+    return batch->count > 0 ? OP_SUCCESS : OP_END;
+}
+
+static void op_scan_close(operator_t* op){
+    op_scan_t* scan = op->state;
+    scan->chblix = chblix_fail();
+}
+
+/**
+ * @brief       Create scan of table
+ * @param[in]   table: pointer to the table
+ * @param[in]   pred: predicate on rows, NULL to hand out all rows
+ * @param[in]   arg: argument of the predicate
+ * @return      pointer to the operator on success, NULL on failure
+ */
+
+operator_t* op_scan_init(table_t* table, tab_row_pred_t pred, void* arg){
+    schema_t* schema = sch_load(table->schidx);
+    if(!schema){
+        logger(LL_ERROR, __func__, "Unable to load schema of table %s", table->name);
+        return NULL;
+    }
+    operator_t* op = op_alloc((int64_t) sizeof(op_scan_t) + schema->slot_size);
+    if(!op){
+        return NULL;
+    }
+    op_scan_t* scan = op->state;
+    scan->table = table;
+    scan->pred = pred;
+    scan->arg = arg;
+    scan->chblix = chblix_fail();
+    scan->row = (uint8_t*) (scan + 1);
+    op->open = op_scan_open;
+    op->next = op_scan_next;
+    op->next_batch = op_scan_next_batch;
+    op->close = op_scan_close;
+    op->schema = schema;
+    return op;
+}
+
+static int op_filter_open(operator_t* op){
+    return op_open(op->left);
+}
+
+static int op_filter_next(operator_t* op, void** row){
+    op_filter_t* filter = op->state;
+    int res;
+    while((res = op_next(op->left, row)) == OP_SUCCESS){
+        if(filter->pred(*row, filter->arg)){
+            return OP_SUCCESS;
+        }
+    }
+    return res;
+}
+
+static int op_filter_next_batch(operator_t* op, op_batch_t* batch){
+    op_filter_t* filter = op->state;
+    int res;
+    while((res = op_next_batch(op->left, batch)) == OP_SUCCESS){
+        int64_t selected = 0;
+        for(int64_t i = 0; i < batch->selected; i++){
+            if(filter->pred(op_batch_row(batch, i), filter->arg)){
+                batch->sel[selected++] = batch->sel[i];
+            }
+        }
+        batch->selected = selected;
+        if(selected > 0){
+            return OP_SUCCESS;
+        }
+    }
+    return res;
+}
+
+static void op_filter_close(operator_t* op){
+    op_close(op->left);
+}
+
+/**
+ * @brief       Create filter of rows
+ * @param[in]   child: operator handing out rows
+ * @param[in]   pred: predicate rows must match
+ * @param[in]   arg: argument of the predicate
+ * @return      pointer to the operator on success, NULL on failure
+ * @note        the operator owns the child
+ */
+
+operator_t* op_filter_init(operator_t* child, tab_row_pred_t pred, void* arg){
+    operator_t* op = op_alloc(sizeof(op_filter_t));
+    if(!op){
+        return NULL;
+    }
+    op_filter_t* filter = op->state;
+    filter->pred = pred;
+    filter->arg = arg;
+    op->open = op_filter_open;
+    op->next = op_filter_next;
+    op->next_batch = op_filter_next_batch;
+    op->close = op_filter_close;
+    op->schema = child->schema;
+    op->left = child;
+    return op;
+}
+
+static int op_compare_next(operator_t* op, void** row){
+    op_compare_t* compare = op->state;
+    int res;
+    while((res = op_next(op->left, row)) == OP_SUCCESS){
+        if(comp_pred_test(&compare->pred, (uint8_t*) *row + compare->field.offset)){
+            return OP_SUCCESS;
+        }
+    }
+    return res;
+}
+
+static int op_compare_next_batch(operator_t* op, op_batch_t* batch){
+    op_compare_t* compare = op->state;
+    int64_t offset = compare->field.offset;
+    int res;
+    while((res = op_next_batch(op->left, batch)) == OP_SUCCESS){
+        int64_t n = batch->selected;
+        int64_t selected = 0;
+        if(compare->field.type == DT_INT || compare->field.type == DT_FLOAT){
+            /* Column of selected rows is gathered and compared in one pass */
+            for(int64_t i = 0; i < n; i++){
+                memcpy(&compare->column.ints[i], op_batch_row(batch, i) + offset, sizeof(int64_t));
+            }
+            if(compare->field.type == DT_INT){
+                simd_cmp_mask_i64(compare->column.ints, n, compare->value.int_val, compare->op, compare->mask);
+            } else {
+                simd_cmp_mask_f64(compare->column.floats, n, compare->value.float_val, compare->op, compare->mask);
+            }
+            for(int64_t i = 0; i < n; i++){
+                if(simd_mask_test(compare->mask, i)){
+                    batch->sel[selected++] = batch->sel[i];
+                }
+            }
+        } else {
+            for(int64_t i = 0; i < n; i++){
+                if(comp_pred_test(&compare->pred, op_batch_row(batch, i) + offset)){
+                    batch->sel[selected++] = batch->sel[i];
+                }
+            }
+        }
+        batch->selected = selected;
+        if(selected > 0){
+            return OP_SUCCESS;
+        }
+    }
+    return res;
+}
+
+static void op_compare_close(operator_t* op){
+    op_close(op->left);
+}
+
+/**
+ * @brief       Create filter of rows on comparison of field with value
+ * @param[in]   db: pointer to db
+ * @param[in]   child: operator handing out rows
+ * @param[in]   field: field of rows
+ * @param[in]   cond: comparison condition
+ * @param[in]   value: value to compare with, varchar value is a ticket
+ * @return      pointer to the operator on success, NULL on failure
+ * @note        the operator owns the child
+ */
+
+operator_t* op_compare_init(db_t* db, operator_t* child, field_t* field, condition_t cond, void* value){
+    static const simd_op_t simd_ops[] = {
+            [COND_EQ] = SIMD_EQ, [COND_NEQ] = SIMD_NE, [COND_LT] = SIMD_LT,
+            [COND_LTE] = SIMD_LE, [COND_GT] = SIMD_GT, [COND_GTE] = SIMD_GE
+    };
+    operator_t* op = op_alloc(sizeof(op_compare_t));
+    if(!op){
+        return NULL;
+    }
+    op_compare_t* compare = op->state;
+    compare->field = *field;
+    compare->op = simd_ops[cond];
+    switch(field->type){
+        case DT_INT:
+        case DT_FLOAT:
+            memcpy(&compare->value, value, sizeof(int64_t));
+            break;
+        case DT_VARCHAR:
+            memcpy(&compare->value, value, sizeof(vch_ticket_t));
+            break;
+        default:
+            logger(LL_ERROR, __func__, "Unable to compare field %s of type %d", field->name, field->type);
+            op_free(op);
+            return NULL;
+    }
+    comp_pred_init(&compare->pred, db, &compare->field, cond, &compare->value);
+    op->open = op_filter_open;
+    op->next = op_compare_next;
+    op->next_batch = op_compare_next_batch;
+    op->close = op_compare_close;
+    op->schema = child->schema;
+    op->left = child;
+    return op;
+}
+
+static void op_hash_join_close(operator_t* op){
+    op_join_t* join = op->state;
+    free(join->rows);
+    free(join->entries);
+    free(join->buckets);
+    join->rows = NULL;
+    join->entries = NULL;
+    join->buckets = NULL;
+    join->count = 0;
+    join->left_row = NULL;
+    op_batch_free(join->left_batch);
+    join->left_batch = NULL;
+    op_close(op->left);
+    op_close(op->right);
+}
+
+static int op_hash_join_open(operator_t* op){
+    op_join_t* join = op->state;
+    int res = op_open(op->right);
+    int64_t capacity = 0;
+    void* right_row;
+    while(res == OP_SUCCESS && (res = op_next(op->right, &right_row)) == OP_SUCCESS){
+        if(join->count == capacity){
+            capacity = capacity ? 2 * capacity : OP_HASH_JOIN_MIN_BUCKETS;
+            uint8_t* rows = realloc(join->rows, capacity * join->right_size);
+            if(rows){
+                join->rows = rows;
+            }
+            op_join_entry_t* entries = realloc(join->entries, capacity * sizeof(op_join_entry_t));
+            if(entries){
+                join->entries = entries;
+            }
+            if(!rows || !entries){
+                logger(LL_ERROR, __func__, "Unable to allocate hash table of %ld rows", capacity);
+                res = OP_FAIL;
+                break;
+            }
+        }
+        uint8_t* dest = join->rows + join->count * join->right_size;
+        memcpy(dest, right_row, join->right_size);
+        join->entries[join->count].hash = comp_hash_field(&join->right_field, dest + join->right_field.offset,
+                                                          join->by_code);
+        join->count++;
+    }
+    if(res == OP_FAIL){
+        op_hash_join_close(op);
+        return OP_FAIL;
+    }
+
+    join->bucket_count = OP_HASH_JOIN_MIN_BUCKETS;
+    while(join->bucket_count < 2 * join->count){
+        join->bucket_count *= 2;
+    }
+    join->buckets = malloc(join->bucket_count * sizeof(int64_t));
+    if(!join->buckets){
+        logger(LL_ERROR, __func__, "Unable to allocate %ld buckets", join->bucket_count);
+        op_hash_join_close(op);
+        return OP_FAIL;
+    }
+    for(int64_t i = 0; i < join->bucket_count; i++){
+        join->buckets[i] = -1;
+    }
+    /* Chains are filled from the end to keep order of the right rows */
+    for(int64_t i = join->count - 1; i >= 0; i--){
+        int64_t bucket = (int64_t) (join->entries[i].hash & (uint64_t) (join->bucket_count - 1));
+        join->entries[i].next = join->buckets[bucket];
+        join->buckets[bucket] = i;
+    }
+    join->left_row = NULL;
+    join->match = -1;
+    join->left_pos = 0;
+    return op_open(op->left);
+}
+
+static int op_hash_join_next(operator_t* op, void** row){
+    op_join_t* join = op->state;
+    while(true){
+        if(!join->left_row){
+            void* left_row;
+            int res = op_next(op->left, &left_row);
+            if(res != OP_SUCCESS){
+                return res;
+            }
+            join->left_row = left_row;
+            memcpy(join->left_el, join->left_row + join->left_field.offset, join->left_field.size);
+            join->hash = comp_hash_field(&join->left_field, join->left_el, join->by_code);
+            join->match = join->buckets[join->hash & (uint64_t) (join->bucket_count - 1)];
+        }
+        while(join->match != -1){
+            int64_t i = join->match;
+            join->match = join->entries[i].next;
+            uint8_t* right_row = join->rows + i * join->right_size;
+            if(join->entries[i].hash != join->hash){
+                continue;
+            }
+            memcpy(join->right_el, right_row + join->right_field.offset, join->right_field.size);
+            if(comp_compare_fields(join->db, &join->left_field, join->left_el, &join->right_field, join->right_el,
+                                   COND_EQ)){
+                memcpy(join->row, join->left_row, join->left_size);
+                memcpy(join->row + join->right_offset, right_row, join->right_size);
+                *row = join->row;
+                return OP_SUCCESS;
+            }
+        }
+        join->left_row = NULL;
+    }
+}
+
+static int op_hash_join_next_batch(operator_t* op, op_batch_t* batch){
+    op_join_t* join = op->state;
+    /* Batch of the left rows is allocated only when the join is read by batches */
+    if(!join->left_batch){
+        join->left_batch = op_batch_init(join->left_size);
+        if(!join->left_batch){
+            return OP_FAIL;
+        }
+    }
+    op_batch_t* left = join->left_batch;
+    batch->count = 0;
+    while(batch->count < OP_BATCH_SIZE){
+        if(join->match == -1){
+            if(++join->left_pos >= left->selected){
+                int res = op_next_batch(op->left, left);
+                if(res == OP_FAIL){
+                    return OP_FAIL;
+                }
+                if(res == OP_END){
+                    break;
+                }
+                /* Hashes of the whole left batch are computed before probing */
+                for(int64_t i = 0; i < left->selected; i++){
+                    memcpy(join->left_el, op_batch_row(left, i) + join->left_field.offset, join->left_field.size);
+                    join->hashes[i] = comp_hash_field(&join->left_field, join->left_el, join->by_code);
+                }
+                join->left_pos = 0;
+            }
+            join->match = join->buckets[join->hashes[join->left_pos] & (uint64_t) (join->bucket_count - 1)];
+            continue;
+        }
+        int64_t i = join->match;
+        join->match = join->entries[i].next;
+        if(join->entries[i].hash != join->hashes[join->left_pos]){
+            continue;
+        }
+        uint8_t* left_row = op_batch_row(left, join->left_pos);
+        uint8_t* right_row = join->rows + i * join->right_size;
+        memcpy(join->left_el, left_row + join->left_field.offset, join->left_field.size);
+        memcpy(join->right_el, right_row + join->right_field.offset, join->right_field.size);
+        if(comp_compare_fields(join->db, &join->left_field, join->left_el, &join->right_field, join->right_el,
+                               COND_EQ)){
+            uint8_t* dest = batch->rows + batch->count * batch->row_size;
+            memcpy(dest, left_row, join->left_size);
+            memcpy(dest + join->right_offset, right_row, join->right_size);
+            batch->sel[batch->count] = (uint16_t) batch->count;
+            batch->count++;
+        }
+    }
+    batch->selected = batch->count;
+    return batch->count > 0 ? OP_SUCCESS : OP_END;
+}
+
+/**
+ * @brief       Create join on equality of fields with hash table on rows of the right input
+ * @param[in]   db: pointer to db
+ * @param[in]   left: operator handing out the left rows
+ * @param[in]   left_field: field of the left rows
+ * @param[in]   right: operator handing out the right rows
+ * @param[in]   right_field: field of the right rows
+ * @return      pointer to the operator on success, NULL on failure
+ * @note        joined rows are the left row followed by the right row, in order of the left rows
+ * @note        the operator owns both inputs
+ */
+
+operator_t* op_hash_join_init(db_t* db, operator_t* left, field_t* left_field, operator_t* right, field_t* right_field){
+    if(left_field->type != right_field->type){
+        logger(LL_ERROR, __func__, "Unable to join %s with %s of other type", left_field->name, right_field->name);
+        return NULL;
+    }
+    schema_t* schema = rll_join_schema(left->schema, right->schema);
+    if(!schema){
+        return NULL;
+    }
+    operator_t* op = op_alloc((int64_t) sizeof(op_join_t) + schema->slot_size + left_field->size + right_field->size);
+    if(!op){
+        return NULL;
+    }
+    op_join_t* join = op->state;
+    join->db = db;
+    join->left_field = *left_field;
+    join->right_field = *right_field;
+    /* Fields sharing dictionary are equal when their codes are */
+    join->by_code = sch_is_dict_field(left_field) && left_field->dict == right_field->dict;
+    join->left_size = left->schema->slot_size;
+    join->right_size = right->schema->slot_size;
+    join->right_offset = sch_join_offset(left->schema);
+    join->row = (uint8_t*) (join + 1);
+    join->left_el = join->row + schema->slot_size;
+    join->right_el = join->left_el + left_field->size;
+    op->open = op_hash_join_open;
+    op->next = op_hash_join_next;
+    op->next_batch = op_hash_join_next_batch;
+    op->close = op_hash_join_close;
+    op->schema = schema;
+    op->left = left;
+    op->right = right;
+    return op;
+}
+
+static int op_project_open(operator_t* op){
+    return op_open(op->left);
+}
+
+static int op_project_next(operator_t* op, void** row){
+    op_project_t* project = op->state;
+    void* child_row;
+    int res = op_next(op->left, &child_row);
+    if(res != OP_SUCCESS){
+        return res;
+    }
+    for(int64_t i = 0; i < project->num_of_fields; i++){
+        memcpy(project->row + project->offsets[i], (uint8_t*) child_row + project->fields[i].offset,
+               project->fields[i].size);
+    }
+    *row = project->row;
+    return OP_SUCCESS;
+}
+
+static int op_project_next_batch(operator_t* op, op_batch_t* batch){
+    op_project_t* project = op->state;
+    /* Batch of the child rows is allocated only when the projection is read by batches */
+    if(!project->input){
+        project->input = op_batch_init(op->left->schema->slot_size);
+        if(!project->input){
+            return OP_FAIL;
+        }
+    }
+    op_batch_t* input = project->input;
+    int res = op_next_batch(op->left, input);
+    if(res != OP_SUCCESS){
+        return res;
+    }
+    for(int64_t i = 0; i < input->selected; i++){
+        uint8_t* src = op_batch_row(input, i);
+        uint8_t* dest = batch->rows + i * batch->row_size;
+        for(int64_t j = 0; j < project->num_of_fields; j++){
+            memcpy(dest + project->offsets[j], src + project->fields[j].offset, project->fields[j].size);
+        }
+        batch->sel[i] = (uint16_t) i;
+    }
+    batch->count = input->selected;
+    batch->selected = input->selected;
+    return OP_SUCCESS;
+}
+
+static void op_project_close(operator_t* op){
+    op_project_t* project = op->state;
+    op_batch_free(project->input);
+    project->input = NULL;
+    op_close(op->left);
+}
+
+/**
+ * @brief       Create projection of rows on fields
+ * @param[in]   child: operator handing out rows
+ * @param[in]   fields: fields of the child rows
+ * @param[in]   num_of_fields: number of fields
+ * @return      pointer to the operator on success, NULL on failure
+ * @note        the operator owns the child
+ */
+
+operator_t* op_project_init(operator_t* child, field_t* fields, int64_t num_of_fields){
+    schema_t* schema = sch_init();
+    if(!schema){
+        logger(LL_ERROR, __func__, "Unable to create schema of projection");
+        return NULL;
+    }
+    for(int64_t i = 0; i < num_of_fields; i++){
+        if(sch_copy_field(schema, &fields[i]) == SCHEMA_FAIL){
+            logger(LL_ERROR, __func__, "Unable to add field %s", fields[i].name);
+            return NULL;
+        }
+    }
+    sch_desc_t* desc = sch_desc_load(schema_index(schema));
+    if(!desc){
+        logger(LL_ERROR, __func__, "Unable to load schema descriptor");
+        return NULL;
+    }
+    operator_t* op = op_alloc((int64_t) sizeof(op_project_t) + num_of_fields * (int64_t) sizeof(field_t) +
+                              num_of_fields * (int64_t) sizeof(int64_t) + schema->slot_size);
+    if(!op){
+        return NULL;
+    }
+    op_project_t* project = op->state;
+    project->num_of_fields = num_of_fields;
+    project->fields = (field_t*) (project + 1);
+    project->offsets = (int64_t*) (project->fields + num_of_fields);
+    project->row = (uint8_t*) (project->offsets + num_of_fields);
+    /* Offsets in projected row are resolved once instead of matching names per row */
+    for(int64_t i = 0; i < num_of_fields; i++){
+        field_t* field = sch_desc_field(desc, fields[i].name);
+        if(!field){
+            logger(LL_ERROR, __func__, "Field %s not found", fields[i].name);
+            op_free(op);
+            return NULL;
+        }
+        project->fields[i] = fields[i];
+        project->offsets[i] = field->offset;
+    }
+    op->open = op_project_open;
+    op->next = op_project_next;
+    op->next_batch = op_project_next_batch;
+    op->close = op_project_close;
+    op->schema = schema;
+    op->left = child;
+    return op;
+}
+
+/**
+ * @brief       Open operator and its inputs
+ * @param[in]   op: pointer to the operator
+ * @return      OP_SUCCESS on success, OP_FAIL on failure
+ */
+
+int op_open(operator_t* op){
+    return op->open(op);
+}
+
+/**
+ * @brief       Get the next row
+ * @param[in]   op: pointer to the open operator
+ * @param[out]  row: pointer to the row, valid until the next call
+ * @return      OP_SUCCESS on success, OP_END when there are no more rows, OP_FAIL on failure
+ */
+
+int op_next(operator_t* op, void** row){
+    return op->next(op, row);
+}
+
+/**
+ * @brief       Get the next batch of rows
+ * @param[in]   op: pointer to the open operator
+ * @param[out]  batch: batch of row size of schema of the operator
+ * @return      OP_SUCCESS on success, OP_END when there are no more rows, OP_FAIL on failure
+ */
+
+int op_next_batch(operator_t* op, op_batch_t* batch){
+    return op->next_batch(op, batch);
+}
+
+/**
+ * @brief       Close operator and its inputs, releasing their state
+ * @param[in]   op: pointer to the operator
+ */
+
+void op_close(operator_t* op){
+    op->close(op);
+}
+
+/**
+ * @brief       Free closed operator with its inputs
+ * @param[in]   op: pointer to the operator or NULL
+ */
+
+void op_free(operator_t* op){
+    if(!op){
+        return;
+    }
+    op_free(op->left);
+    op_free(op->right);
+    free(op->state);
+    free(op);
+}
+
+/**
+ * @brief       Allocate batch
+ * @param[in]   row_size: size of row
+ * @return      pointer to the batch on success, NULL on failure
+ */
+
+op_batch_t* op_batch_init(int64_t row_size){
+    op_batch_t* batch = malloc(sizeof(op_batch_t));
+    uint8_t* rows = malloc(OP_BATCH_SIZE * row_size);
+    if(!batch || !rows){
+        logger(LL_ERROR, __func__, "Unable to allocate batch of rows of %ld bytes", row_size);
+        free(batch);
+        free(rows);
+        return NULL;
+    }
+    batch->row_size = row_size;
+    batch->count = 0;
+    batch->selected = 0;
+    batch->rows = rows;
+    return batch;
+}
+
+/**
+ * @brief       Free batch
+ * @param[in]   batch: pointer to the batch or NULL
+ */
+
+void op_batch_free(op_batch_t* batch){
+    if(!batch){
+        return;
+    }
+    free(batch->rows);
+    free(batch);
+}
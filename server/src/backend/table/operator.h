@@ -0,0 +1,67 @@
+#pragma once
+
+#include "table.h"
+#include <stdint.h>
+
+/**
+ * Pull-based operators of query plan. Every operator hands out one row per
+ * next, so rows stream from the scan of table through filters, joins and
+ * projections to the consumer without lists of rows in between. Memory of
+ * plan is bounded by state of its operators: hash join keeps rows of its
+ * right input, others keep a single row.
+ *
+ * Operators also hand out batches of up to OP_BATCH_SIZE rows with selection
+ * vector of rows still in play. Filter of batch only shrinks the selection,
+ * filter of int and float column compares the whole column of batch at once.
+ * A plan is read either by rows or by batches between open and close.
+ */
+
+#ifndef OP_HASH_JOIN_MIN_BUCKETS
+#define OP_HASH_JOIN_MIN_BUCKETS 16
+#endif
+
+#ifndef OP_BATCH_SIZE
+#define OP_BATCH_SIZE 1024
+#endif
+
+typedef enum {OP_SUCCESS = 0, OP_FAIL = -1, OP_END = 1} op_status_t;
+
+typedef struct op_batch{
+    int64_t row_size;
+    int64_t count; //rows in the batch
+    int64_t selected; //rows in the selection vector
+    uint16_t sel[OP_BATCH_SIZE]; //indexes of selected rows in ascending order
+    uint8_t* rows; //OP_BATCH_SIZE rows of row_size bytes
+} op_batch_t;
+
+/**
+ * @brief       Get selected row of batch
+ * @param[in]   batch: pointer to the batch
+ * @param[in]   i: index in the selection vector
+ */
+
+#define op_batch_row(batch, i) ((batch)->rows + (int64_t) (batch)->sel[i] * (batch)->row_size)
+
+typedef struct operator{
+    int (*open)(struct operator* op);
+    int (*next)(struct operator* op, void** row); //row is valid until the next call
+    int (*next_batch)(struct operator* op, op_batch_t* batch); //batch has at least one selected row on success
+    void (*close)(struct operator* op);
+    schema_t* schema; //schema of rows the operator hands out
+    struct operator* left;
+    struct operator* right;
+    void* state;
+} operator_t;
+
+operator_t* op_scan_init(table_t* table, tab_row_pred_t pred, void* arg);
+operator_t* op_filter_init(operator_t* child, tab_row_pred_t pred, void* arg);
+operator_t* op_compare_init(db_t* db, operator_t* child, field_t* field, condition_t cond, void* value);
+operator_t* op_hash_join_init(db_t* db, operator_t* left, field_t* left_field, operator_t* right, field_t* right_field);
+operator_t* op_project_init(operator_t* child, field_t* fields, int64_t num_of_fields);
+int op_open(operator_t* op);
+int op_next(operator_t* op, void** row);
+int op_next_batch(operator_t* op, op_batch_t* batch);
+void op_close(operator_t* op);
+void op_free(operator_t* op);
+op_batch_t* op_batch_init(int64_t row_size);
+void op_batch_free(op_batch_t* batch);
@@ -1,4 +1,5 @@
 #include "schema.h"
+#include "schema_desc.h"
 
 /**
  * @brief       Initialize a schema
@@ -13,19 +14,22 @@ void* sch_init(void){
         return NULL;
     }
     sch->slot_size = 0;
+    sch->version = sch_desc_next_version();
     return sch;
 }
 
 /**
- * @brief       Add a field
+ * @brief       Add a field at given offset in row
  * @param[in]   schema: pointer to schema
  * @param[in]   name: name of the field
  * @param[in]   type: type of the field
  * @param[in]   size: size of the type
+ * @param[in]   dict: index of the dictionary of the field or DICT_NONE
+ * @param[in]   offset: offset of the field in row
  * @return      SCHEMA_SUCCESS on success, SCHEMA_FAIL on failure
  */
 
-int sch_add_field(schema_t* schema, const char* name, datatype_t type, int64_t size){
+static int sch_add_field_at(schema_t* schema, const char* name, datatype_t type, int64_t size, int64_t dict, int64_t offset){
     if(schema == NULL) {
         logger(LL_ERROR, __func__, "Invalid argument: schema is NULL");
         return SCHEMA_FAIL;
@@ -44,8 +48,15 @@ int sch_add_field(schema_t* schema, const char* name, datatype_t type, int64_t s
     strncpy(field.name, name, MAX_NAME_LENGTH);
     field.type = type;
     field.size = size;
-    field.offset = schema->slot_size;
-    schema->slot_size += size;
+    field.offset = offset;
+    field.dict = dict;
+    /* Copies of fields in other schemas never share the index */
+    field.index = IDX_NONE;
+    field.index_kind = IDX_BTREE;
+    if(offset + size > schema->slot_size){
+        schema->slot_size = offset + size;
+    }
+    schema->version = sch_desc_next_version();
     if(sch_field_update(schema_index(schema), &fieldix, &field) == LB_FAIL){
         logger(LL_ERROR, __func__, "Failed to update field %s", name);
         return SCHEMA_FAIL;
@@ -53,6 +64,74 @@ int sch_add_field(schema_t* schema, const char* name, datatype_t type, int64_t s
     return SCHEMA_SUCCESS;
 }
 
+/**
+ * @brief       Add a field
+ * @param[in]   schema: pointer to schema
+ * @param[in]   name: name of the field
+ * @param[in]   type: type of the field
+ * @param[in]   size: size of the type
+ * @return      SCHEMA_SUCCESS on success, SCHEMA_FAIL on failure
+ */
+
+int sch_add_field(schema_t* schema, const char* name, datatype_t type, int64_t size){
+    if(schema == NULL) {
+        logger(LL_ERROR, __func__, "Invalid argument: schema is NULL");
+        return SCHEMA_FAIL;
+    }
+    return sch_add_field_at(schema, name, type, size, DICT_NONE, schema->slot_size);
+}
+
+/**
+ * @brief       Add a dictionary encoded varchar field
+ * @param[in]   schema: pointer to schema
+ * @param[in]   name: name of the field
+ * @return      SCHEMA_SUCCESS on success, SCHEMA_FAIL on failure
+ * @note        rows keep 4-byte codes of strings of the field dictionary
+ */
+
+int sch_add_dict_varchar_field(schema_t* schema, const char* name){
+    if(schema == NULL) {
+        logger(LL_ERROR, __func__, "Invalid argument: schema is NULL");
+        return SCHEMA_FAIL;
+    }
+    int64_t dict = dict_init();
+    if(dict == DICT_FAIL){
+        logger(LL_ERROR, __func__, "Failed to create dictionary of field %s", name);
+        return SCHEMA_FAIL;
+    }
+    return sch_add_field_at(schema, name, DT_VARCHAR, sizeof(int32_t), dict, schema->slot_size);
+}
+
+/**
+ * @brief       Add a copy of a field of another schema to the end of row
+ * @param[in]   schema: pointer to schema
+ * @param[in]   field: field to copy
+ * @return      SCHEMA_SUCCESS on success, SCHEMA_FAIL on failure
+ * @note        dictionary encoded field shares dictionary with the source
+ */
+
+int sch_copy_field(schema_t* schema, const field_t* field){
+    if(schema == NULL) {
+        logger(LL_ERROR, __func__, "Invalid argument: schema is NULL");
+        return SCHEMA_FAIL;
+    }
+    return sch_add_field_at(schema, field->name, field->type, (int64_t) field->size, field->dict, schema->slot_size);
+}
+
+/**
+ * @brief       Add a copy of a field keeping its place in row
+ * @param[in]   schema: pointer to schema
+ * @param[in]   field: field to copy
+ * @param[in]   base: offset of the source row in the new row
+ * @return      SCHEMA_SUCCESS on success, SCHEMA_FAIL on failure
+ * @note        rows of the source schema may be copied into the new rows as a whole
+ */
+
+int sch_copy_field_at(schema_t* schema, const field_t* field, int64_t base){
+    return sch_add_field_at(schema, field->name, field->type, (int64_t) field->size, field->dict,
+                            base + (int64_t) field->offset);
+}
+
 /**
  * @brief       Get a field
  * @param[in]   schema: pointer to the schema
@@ -67,11 +146,15 @@ int sch_get_field(schema_t* schema, const char* name, field_t* field){
         return SCHEMA_FAIL;
     }
 
-    sch_for_each(schema, chunk, fieldi, chblix, schema->ppl_header.lp_header.page_index){
-        if(strcmp(fieldi.name, name) == 0){
-            *field = fieldi;
-            return SCHEMA_SUCCESS;
-        }
+    sch_desc_t* desc = sch_desc_load(schema_index(schema));
+    if(desc == NULL){
+        logger(LL_ERROR, __func__, "Failed to load descriptor of schema %ld", schema_index(schema));
+        return SCHEMA_FAIL;
+    }
+    field_t* found = sch_desc_field(desc, name);
+    if(found != NULL){
+        *field = *found;
+        return SCHEMA_SUCCESS;
     }
 
     logger(LL_ERROR, __func__, "Failed to find field %s", name);
@@ -98,6 +181,7 @@ int sch_delete_field(schema_t* schema, const char* name){
                 logger(LL_ERROR, __func__, "Failed to deallocate field %s", name);
                 return SCHEMA_FAIL;
             }
+            schema->version = sch_desc_next_version();
             return SCHEMA_SUCCESS;
         }
     }
@@ -106,3 +190,188 @@ int sch_delete_field(schema_t* schema, const char* name){
     return SCHEMA_FAIL;
 }
 
+/**
+ * @brief       Delete a schema
+ * @param[in]   schidx: index of the schema
+ * @return      SCHEMA_SUCCESS on success, SCHEMA_FAIL on failure
+ */
+
+int sch_delete(int64_t schidx){
+    /* Index may be given to a new schema, its descriptor must not be found */
+    sch_desc_drop(schidx);
+    return lb_ppl_destroy(schidx) == PPL_FAIL ? SCHEMA_FAIL : SCHEMA_SUCCESS;
+}
+
+/**
+ * @brief       Attach index to a field or detach it
+ * @param[in]   schema: pointer to schema
+ * @param[in]   name: name of the field
+ * @param[in]   index: index of the index or IDX_NONE
+ * @param[in]   kind: kind of the index
+ * @return      SCHEMA_SUCCESS on success, SCHEMA_FAIL on failure
+ */
+
+int sch_set_field_index(schema_t* schema, const char* name, int64_t index, index_kind_t kind){
+    if(schema == NULL) {
+        logger(LL_ERROR, __func__, "Invalid argument: schema is NULL");
+        return SCHEMA_FAIL;
+    }
+    field_t field;
+    if(sch_get_field(schema, name, &field) != SCHEMA_SUCCESS){
+        return SCHEMA_FAIL;
+    }
+    field.index = index;
+    field.index_kind = kind;
+    if(sch_field_update(schema_index(schema), &field.lb_header.chblix, &field) == LB_FAIL){
+        logger(LL_ERROR, __func__, "Failed to update field %s", name);
+        return SCHEMA_FAIL;
+    }
+    schema->version = sch_desc_next_version();
+    return SCHEMA_SUCCESS;
+}
+
+/**
+ * @brief       Get alignment of a field in row
+ * @param[in]   field: pointer to field
+ * @return      alignment in bytes
+ */
+
+static int64_t sch_field_align(const field_t* field){
+    switch(field->type){
+        case DT_INT:
+        case DT_FLOAT:
+            return 8;
+        case DT_VARCHAR:
+            /* Dictionary keeps int32 code, ticket holds 64-bit block or pointer */
+            return sch_is_dict_field(field) ? (int64_t) sizeof(int32_t) : 8;
+        default:
+            return 1;
+    }
+}
+
+/**
+ * @brief       Get layout group of a field, fixed-width scalars go first
+ * @param[in]   field: pointer to field
+ * @return      0 for columns compared by value, 1 for strings
+ */
+
+static int sch_field_group(const field_t* field){
+    if(field->type == DT_CHAR || (field->type == DT_VARCHAR && !sch_is_dict_field(field))){
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief       Compare fields by their place in optimized layout
+ * @param[in]   a: pointer to the first field
+ * @param[in]   b: pointer to the second field
+ * @return      negative if a goes first, positive if b goes first
+ */
+
+static int sch_layout_cmp(const void* a, const void* b){
+    const field_t* fa = a;
+    const field_t* fb = b;
+    int group = sch_field_group(fa) - sch_field_group(fb);
+    if(group != 0){
+        return group;
+    }
+    int64_t align = sch_field_align(fb) - sch_field_align(fa);
+    if(align != 0){
+        return align < 0 ? -1 : 1;
+    }
+    /* Keep declaration order among equal fields */
+    return fa->offset < fb->offset ? -1 : fa->offset > fb->offset;
+}
+
+/**
+ * @brief       Reassign offsets of fields for natural alignment, fixed-width columns first
+ * @param[in]   schema: pointer to schema without rows
+ * @return      SCHEMA_SUCCESS on success, SCHEMA_FAIL on failure
+ * @note        order of fields seen by clients does not change, only their place in row
+ */
+
+int sch_optimize_layout(schema_t* schema){
+    if(schema == NULL) {
+        logger(LL_ERROR, __func__, "Invalid argument: schema is NULL");
+        return SCHEMA_FAIL;
+    }
+    sch_desc_t* desc = sch_desc_load(schema_index(schema));
+    if(desc == NULL){
+        logger(LL_ERROR, __func__, "Failed to load descriptor of schema %ld", schema_index(schema));
+        return SCHEMA_FAIL;
+    }
+    int64_t count = desc->count;
+    if(count == 0){
+        return SCHEMA_SUCCESS;
+    }
+    field_t* fields = malloc(count * sizeof(field_t));
+    if(fields == NULL){
+        logger(LL_ERROR, __func__, "Failed to allocate %ld fields", count);
+        return SCHEMA_FAIL;
+    }
+    memcpy(fields, desc->fields, count * sizeof(field_t));
+    qsort(fields, count, sizeof(field_t), sch_layout_cmp);
+
+    int64_t offset = 0;
+    for(int64_t i = 0; i < count; i++){
+        int64_t align = sch_field_align(&fields[i]);
+        offset = (offset + align - 1) / align * align;
+        fields[i].offset = offset;
+        offset += (int64_t) fields[i].size;
+        if(sch_field_update(schema_index(schema), &fields[i].lb_header.chblix, &fields[i]) == LB_FAIL){
+            logger(LL_ERROR, __func__, "Failed to update field %s", fields[i].name);
+            free(fields);
+            return SCHEMA_FAIL;
+        }
+    }
+    free(fields);
+    schema = sch_load(schema_index(schema));
+    /* Rows follow each other in pages and batches, so each starts aligned too */
+    schema->slot_size = sch_row_align(offset);
+    schema->version = sch_desc_next_version();
+    return SCHEMA_SUCCESS;
+}
+
+/**
+ * @brief       Put a varchar into a slot of the field
+ * @param[in]   vchmgr_idx: varchar manager index
+ * @param[in]   field: varchar field
+ * @param[in]   varchar: string to put
+ * @param[out]  slot: slot of the field in row
+ * @return      SCHEMA_SUCCESS on success, SCHEMA_FAIL on failure
+ */
+
+int sch_put_varchar(int64_t vchmgr_idx, const field_t* field, const char* varchar, void* slot){
+    if(!sch_is_dict_field(field)){
+        return vch_put(vchmgr_idx, varchar, slot, (int64_t) field->size) == LB_FAIL ? SCHEMA_FAIL : SCHEMA_SUCCESS;
+    }
+    int32_t code = dict_intern(vchmgr_idx, field->dict, varchar);
+    if(code == DICT_FAIL){
+        logger(LL_ERROR, __func__, "Failed to intern value of field %s", field->name);
+        return SCHEMA_FAIL;
+    }
+    memcpy(slot, &code, sizeof(int32_t));
+    return SCHEMA_SUCCESS;
+}
+
+/**
+ * @brief       Get varchar ticket from a slot of the field
+ * @param[in]   field: varchar field
+ * @param[in]   slot: slot of the field in row
+ * @param[out]  ticket: buffer for ticket of dictionary encoded field
+ * @return      pointer to slot or ticket on success, NULL on failure
+ */
+
+vch_ticket_t* sch_varchar_ticket(const field_t* field, void* slot, vch_ticket_t* ticket){
+    if(!sch_is_dict_field(field)){
+        return slot;
+    }
+    int32_t code;
+    memcpy(&code, slot, sizeof(int32_t));
+    if(dict_ticket(field->dict, code, ticket) == PA_FAIL){
+        logger(LL_ERROR, __func__, "Failed to decode value %d of field %s", code, field->name);
+        return NULL;
+    }
+    return ticket;
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include "../data_type.h"
+#include "backend/index/index.h"
+#include "backend/journal/dictionary.h"
 #include "backend/journal/varchar_mgr.h"
 #include "core/page_pool/linked_blocks.h"
 #include "core/page_pool/page_pool.h"
@@ -7,17 +9,48 @@
 #include <string.h>
 
 #define MAX_NAME_LENGTH 128
+
+/**
+ * CREATE lays fields out for natural alignment with fixed-width columns
+ * first, see sch_optimize_layout. Set to 0 to keep declaration order.
+ */
+
+#ifndef SCH_OPTIMIZE_LAYOUT
+#define SCH_OPTIMIZE_LAYOUT 1
+#endif
+
+/* Alignment of laid out rows and of the right row in joined rows */
+#define SCH_ROW_ALIGN 8
+
+/**
+ * @brief       Round size of a row up to SCH_ROW_ALIGN
+ * @param[in]   size: size of the row
+ */
+
+#define sch_row_align(size) (((int64_t) (size) + SCH_ROW_ALIGN - 1) / SCH_ROW_ALIGN * SCH_ROW_ALIGN)
+
+/**
+ * @brief       Get offset of the right row in rows joined after the left row
+ * @param[in]   left: pointer to schema of the left rows
+ */
+
+#define sch_join_offset(left) sch_row_align((left)->slot_size)
+
 typedef struct field{
     linked_block_t lb_header;
     char name[MAX_NAME_LENGTH];
     datatype_t type;
     uint64_t size;
     uint64_t offset;
+    int64_t dict;
+    int64_t index; //index of the column or IDX_NONE
+    int64_t index_kind; //index_kind_t of the index
 } field_t;
 
 typedef struct schema{
     page_pool_t ppl_header;
     int64_t slot_size;
+    int64_t version; //changes with every field added or deleted
 } schema_t;
 
 typedef enum {SCHEMA_SUCCESS = 0, SCHEMA_FAIL = -1, SCHEMA_NOT_FOUND = -2} schema_status_t;
@@ -30,14 +63,6 @@ typedef enum {SCHEMA_SUCCESS = 0, SCHEMA_FAIL = -1, SCHEMA_NOT_FOUND = -2} schem
 
 #define sch_load(schidx) ((schema_t*)lb_ppl_load(schidx))
 
-/**
- * @brief       Delete a schema
- * @param[in]   schidx: index of the schema
- * @return      SCHEMA_SUCCESS on success, SCHEMA_FAIL on failure
- */
-
-#define sch_delete(schidx) (lb_ppl_destroy((schidx)))
-
 /**
  * @brief      Load field
  * @param[in]  schidx: index of the schema
@@ -62,10 +87,14 @@ typedef enum {SCHEMA_SUCCESS = 0, SCHEMA_FAIL = -1, SCHEMA_NOT_FOUND = -2} schem
 
 #define sch_add_int_field(schema, name) sch_add_field((schema), name, DT_INT, sizeof(int64_t))
 #define sch_add_char_field(schema, name, size) sch_add_field((schema), name, DT_CHAR, size)
-#define sch_add_varchar_field(schema, name) sch_add_field((schema), name, DT_VARCHAR, sizeof(vch_ticket_t))
+#define sch_add_varchar_field(schema, name) sch_add_field((schema), name, DT_VARCHAR, vch_slot_size(VCH_DEFAULT_INLINE_SIZE))
+#define sch_add_varchar_field_inline(schema, name, inline_size) sch_add_field((schema), name, DT_VARCHAR, vch_slot_size(inline_size))
 #define sch_add_float_field(schema, name) sch_add_field((schema), name, DT_FLOAT, sizeof(double))
 #define sch_add_bool_field(schema, name) sch_add_field((schema), name, DT_BOOL, sizeof(bool))
 
+#define sch_is_dict_field(field) ((field)->dict != DICT_NONE)
+#define sch_is_indexed_field(field) ((field)->index != IDX_NONE)
+
 #define schema_index(schema) ((schema)->ppl_header.lp_header.page_index)
 
 
@@ -90,5 +119,13 @@ typedef enum {SCHEMA_SUCCESS = 0, SCHEMA_FAIL = -1, SCHEMA_NOT_FOUND = -2} schem
 
 void* sch_init(void);
 int sch_add_field(schema_t* schema, const char* name, datatype_t type, int64_t size);
+int sch_add_dict_varchar_field(schema_t* schema, const char* name);
+int sch_copy_field(schema_t* schema, const field_t* field);
+int sch_copy_field_at(schema_t* schema, const field_t* field, int64_t base);
+int sch_optimize_layout(schema_t* schema);
 int sch_get_field(schema_t* schema, const char* name, field_t* field);
 int sch_delete_field(schema_t* schema, const char* name);
+int sch_delete(int64_t schidx);
+int sch_set_field_index(schema_t* schema, const char* name, int64_t index, index_kind_t kind);
+int sch_put_varchar(int64_t vchmgr_idx, const field_t* field, const char* varchar, void* slot);
+vch_ticket_t* sch_varchar_ticket(const field_t* field, void* slot, vch_ticket_t* ticket);
@@ -0,0 +1,169 @@
+#include "schema_desc.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+
+static sch_desc_t* sch_desc_cache[SCH_DESC_BUCKETS];
+static int64_t sch_desc_version = 0;
+
+/**
+ * @brief       Free descriptor content
+ * @param[in]   desc: pointer to the descriptor
+ */
+
+static void sch_desc_free_fields(sch_desc_t* desc){
+    if(desc->names){
+        ht_free(desc->names);
+    }
+    free(desc->fields);
+    desc->names = NULL;
+    desc->fields = NULL;
+    desc->count = 0;
+}
+
+/**
+ * @brief       Read fields of schema into descriptor
+ * @param[in]   desc: pointer to the descriptor
+ * @param[in]   schema: pointer to the schema
+ * @return      SCHEMA_SUCCESS on success, SCHEMA_FAIL on failure
+ */
+
+static int sch_desc_compile(sch_desc_t* desc, schema_t* schema){
+    int64_t count = 0;
+    sch_for_each(schema, chunk, field, chblix, desc->schidx){
+        count++;
+    }
+    desc->fields = malloc((count ? count : 1) * sizeof(field_t));
+    desc->names = ht_init();
+    if(!desc->fields || !desc->names || ht_reserve(desc->names, count) == -1){
+        logger(LL_ERROR, __func__, "Unable to allocate descriptor of schema %ld", desc->schidx);
+        sch_desc_free_fields(desc);
+        return SCHEMA_FAIL;
+    }
+    sch_for_each(schema, chunk2, field2, chblix2, desc->schidx){
+        desc->fields[desc->count] = field2;
+        desc->count++;
+    }
+    /* Array does not move anymore, names may point into it */
+    for(int64_t i = 0; i < desc->count; i++){
+        ht_put(desc->names, desc->fields[i].name, &desc->fields[i]);
+    }
+    desc->version = schema->version;
+    desc->slot_size = schema->slot_size;
+    return SCHEMA_SUCCESS;
+}
+
+/**
+ * @brief       Get new version for changed schema
+ * @return      version, unique in the database file
+ * @note        versions continue after the last one saved in the db header, see sch_desc_last_version
+ */
+
+int64_t sch_desc_next_version(void){
+    return ++sch_desc_version;
+}
+
+/**
+ * @brief       Continue versions after the last one saved in the db header
+ * @param[in]   version: the last version saved in the db header
+ */
+
+void sch_desc_attach(int64_t version){
+    if(version > sch_desc_version){
+        sch_desc_version = version;
+    }
+}
+
+/**
+ * @brief       Get the last version given to a schema
+ * @return      version to save in the db header when the database is closed
+ * @note        versions are not saved on every change, so reading queries do not write the db header
+ */
+
+int64_t sch_desc_last_version(void){
+    return sch_desc_version;
+}
+
+/**
+ * @brief       Load descriptor of schema, compiling it if needed
+ * @param[in]   schidx: index of the schema
+ * @return      pointer to the descriptor on success, NULL on failure
+ * @warning     descriptor is valid until the schema changes
+ */
+
+sch_desc_t* sch_desc_load(int64_t schidx){
+    schema_t* schema = sch_load(schidx);
+    if(!schema){
+        logger(LL_ERROR, __func__, "Unable to load schema %ld", schidx);
+        return NULL;
+    }
+    sch_desc_t** bucket = &sch_desc_cache[schidx % SCH_DESC_BUCKETS];
+    sch_desc_t* desc = *bucket;
+    while(desc && desc->schidx != schidx){
+        desc = desc->next;
+    }
+    if(desc && desc->version == schema->version){
+        return desc;
+    }
+    if(!desc){
+        desc = calloc(1, sizeof(sch_desc_t));
+        if(!desc){
+            logger(LL_ERROR, __func__, "Unable to allocate descriptor of schema %ld", schidx);
+            return NULL;
+        }
+        desc->schidx = schidx;
+        desc->next = *bucket;
+        *bucket = desc;
+    }
+    sch_desc_free_fields(desc);
+    if(sch_desc_compile(desc, schema) == SCHEMA_FAIL){
+        return NULL;
+    }
+    return desc;
+}
+
+/**
+ * @brief       Find field by name
+ * @param[in]   desc: pointer to the descriptor
+ * @param[in]   name: name of the field
+ * @return      pointer to the field or NULL if there is no such field
+ */
+
+field_t* sch_desc_field(sch_desc_t* desc, const char* name){
+    return (field_t*) ht_get(desc->names, (char*) name);
+}
+
+/**
+ * @brief       Drop cached descriptor of schema
+ * @param[in]   schidx: index of the schema
+ * @note        called when the schema is deleted
+ */
+
+void sch_desc_drop(int64_t schidx){
+    for(sch_desc_t** link = &sch_desc_cache[schidx % SCH_DESC_BUCKETS]; *link; link = &(*link)->next){
+        if((*link)->schidx == schidx){
+            sch_desc_t* desc = *link;
+            *link = desc->next;
+            sch_desc_free_fields(desc);
+            free(desc);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief       Drop all cached descriptors
+ * @note        called when database file is opened or closed
+ */
+
+void sch_desc_clear(void){
+    for(int64_t i = 0; i < SCH_DESC_BUCKETS; i++){
+        sch_desc_t* desc = sch_desc_cache[i];
+        while(desc){
+            sch_desc_t* next = desc->next;
+            sch_desc_free_fields(desc);
+            free(desc);
+            desc = next;
+        }
+        sch_desc_cache[i] = NULL;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "schema.h"
+#include "utils/hashtable.h"
+#include <stdint.h>
+
+/**
+ * Compiled in-memory descriptor of a schema: array of fields in storage
+ * order and hash of their names. Descriptors are built once per schema index
+ * and cached, every change of the schema assigns it a new version, so the
+ * stale descriptor is rebuilt on the next load. The last version is saved in
+ * the db header when the database is closed, so versions given after reopening
+ * the file continue from it.
+ */
+
+#ifndef SCH_DESC_BUCKETS
+#define SCH_DESC_BUCKETS 64
+#endif
+
+typedef struct sch_desc{
+    int64_t schidx;
+    int64_t version;
+    int64_t slot_size;
+    int64_t count;
+    field_t* fields;
+    hmap_t* names;
+    struct sch_desc* next;
+} sch_desc_t;
+
+/**
+ * @brief       For each field in a schema descriptor
+ * @param[in]   desc: pointer to the descriptor
+ * @param[in]   field: name of pointer to the field
+ */
+
+#define sch_desc_for_each(desc, field) \
+    for(field_t* field = (desc)->fields; field < (desc)->fields + (desc)->count; field++)
+
+int64_t sch_desc_next_version(void);
+void sch_desc_attach(int64_t version);
+int64_t sch_desc_last_version(void);
+sch_desc_t* sch_desc_load(int64_t schidx);
+field_t* sch_desc_field(sch_desc_t* desc, const char* name);
+void sch_desc_drop(int64_t schidx);
+void sch_desc_clear(void);
@@ -1,7 +1,20 @@
 #include "table.h"
+#include "schema_desc.h"
+#include "operator.h"
 #include <inttypes.h>
 #include <stdio.h>
 
+typedef struct rll_hash_entry {
+    uint64_t hash;
+    row_node_t *node;
+    int64_t next;
+} rll_hash_entry_t;
+
+typedef struct rll_sort_key {
+    row_node_t *node;
+    data_t key;
+} rll_sort_key_t;
+
 /**
  * @brief       Initialize table and add it to the metatable
  * @param[in]   db: pointer to db
@@ -16,10 +29,115 @@ table_t *tab_init(db_t *db, const char *name, schema_t *schema) {
         logger(LL_ERROR, __func__, "Unable to init table");
         return NULL;
     }
+    table->vchmgr_idx = db->varchar_mgr_idx;
     mtab_add(db->meta_table_idx, name, table_index(table));
     return table;
 }
 
+/**
+ * @brief       Initialize result table that shares varchars with source rows
+ * @param[in]   db: pointer to db
+ * @param[in]   name: name of the table
+ * @param[in]   schema: pointer to schema
+ * @return      pointer to the table on success, NULL on failure
+ */
+
+static table_t *tab_init_result(db_t *db, const char *name, schema_t *schema) {
+    table_t *table = tab_base_init(name, schema);
+    if (table == NULL) {
+        logger(LL_ERROR, __func__, "Unable to init table");
+        return NULL;
+    }
+    table->vchmgr_idx = TAB_SHARED_VARCHARS;
+    /* Results built in temp space stay out of the catalog */
+    if (!pg_is_temp(table_index(table))) {
+        mtab_add(db->meta_table_idx, name, table_index(table));
+    }
+    return table;
+}
+
+/**
+ * @brief       Open cursor of index of field on rows matching condition
+ * @param[in]   field: indexed field
+ * @param[in]   condition: comparison condition the index supports
+ * @param[in]   value: value to compare with, varchar value is a ticket or a slot of any size
+ * @param[out]  cursor: cursor to open, value must outlive it
+ * @return      IDX_SUCCESS on success, IDX_FAIL on failure
+ */
+
+static int tab_index_seek(field_t *field, condition_t condition, void *value, idx_cursor_t *cursor) {
+    int64_t key_size = tab_index_key_size(field);
+    void *key = calloc(1, key_size);
+    if (key == NULL) {
+        logger(LL_ERROR, __func__, "Failed to allocate key");
+        return IDX_FAIL;
+    }
+    int64_t size = key_size;
+    if (field->type == DT_VARCHAR) {
+        /* Inline string of a wide slot runs past the ticket, bare ticket ends with it */
+        vch_ticket_t ticket;
+        memcpy(&ticket, value, sizeof(vch_ticket_t));
+        size = vch_is_inline(&ticket) ? vch_slot_size(ticket.size) : (int64_t) sizeof(vch_ticket_t);
+        if (size > key_size) {
+            /* String does not fit inline in the key, it is compared in place */
+            ticket = vch_transient(vch_inline_str((vch_ticket_t *) value));
+            value = &ticket;
+            size = (int64_t) sizeof(vch_ticket_t);
+        }
+    }
+    memcpy(key, value, size);
+    int res = idx_seek(field->index_kind, field->index, condition, key, cursor);
+    free(key);
+    return res;
+}
+
+/**
+ * @brief       Select rows matching condition through index of the field
+ * @param[in]   db: pointer to db
+ * @param[in]   table: pointer to the table
+ * @param[in]   schema: pointer to the schema
+ * @param[in]   field: indexed field
+ * @param[in]   condition: comparison condition the index supports
+ * @param[in]   value: value to compare with
+ * @return      list of rows, ordered by the field for B+tree, on success, NULL on failure
+ */
+
+row_likedlist_t *tab_index_filter(db_t *db,
+                                  table_t *table,
+                                  schema_t *schema,
+                                  field_t *field,
+                                  condition_t condition,
+                                  void *value) {
+    if (!sch_is_indexed_field(field)) {
+        logger(LL_ERROR, __func__, "Field %s is not indexed", field->name);
+        return NULL;
+    }
+    idx_cursor_t cursor;
+    if (tab_index_seek(field, condition, value, &cursor) == IDX_FAIL) {
+        return NULL;
+    }
+    row_likedlist_t *list = row_likedlist_init(schema);
+    void *row = malloc(schema->slot_size);
+    int64_t tablix = table_index(table);
+    chblix_t rowix;
+    int res;
+    while ((res = idx_next(&cursor, &rowix)) == IDX_SUCCESS) {
+        if (tab_select_row(tablix, &rowix, row) == TABLE_FAIL) {
+            res = IDX_FAIL;
+            break;
+        }
+        row_likedlist_add(list, &rowix, row, schema, table);
+    }
+    idx_cursor_close(&cursor);
+    free(row);
+    if (res == IDX_FAIL) {
+        logger(LL_ERROR, __func__, "Failed to read rows through index of %s", field->name);
+        row_likedlist_free(list);
+        return NULL;
+    }
+    return list;
+}
+
 /**
  * @brief       Get row by value in column
  * @param[in]   db: pointer to db
@@ -41,9 +159,20 @@ chblix_t tab_get_row(db_t *db, table_t *table, schema_t *schema, field_t *field,
         logger(LL_ERROR, __func__, "Invalid argument, schema is NULL");
         return CHBLIX_FAIL;
     }
+    if (sch_is_indexed_field(field) && type == field->type) {
+        idx_cursor_t cursor;
+        chblix_t rowix = CHBLIX_FAIL;
+        if (tab_index_seek(field, COND_EQ, value, &cursor) == IDX_FAIL || idx_next(&cursor, &rowix) != IDX_SUCCESS) {
+            rowix = CHBLIX_FAIL;
+        }
+        idx_cursor_close(&cursor);
+        return rowix;
+    }
     void *element = malloc(field->size);
+    comp_pred_t pred;
+    comp_pred_init(&pred, db, field, COND_EQ, value);
     tab_for_each_element(table, chunk, chblix, element, field) {
-        if (comp_eq(db, type, element, value)) {
+        if (comp_pred_test(&pred, element)) {
             free(element);
             return chblix;
         }
@@ -69,21 +198,30 @@ void tab_print(db_t *db, table_t *table, schema_t *schema) {
         logger(LL_ERROR, __func__, "Invalid argument, schema is NULL");
         return;
     }
-    sch_for_each(schema, chunka, fielda, sch_chblixa, table->schidx) {
-        printf("%-25s\t", fielda.name);
+    sch_desc_t *desc = sch_desc_load(table->schidx);
+    if (desc == NULL) {
+        logger(LL_ERROR, __func__, "Failed to load schema descriptor");
+        return;
+    }
+    sch_desc_for_each(desc, fielda) {
+        printf("%-25s\t", fielda->name);
     }
     printf("\n");
     void *row = malloc(schema->slot_size);
     tab_for_each_row(table, chunk, chblix, row, schema) {
-        sch_for_each(schema, chunk2, field, sch_chblix, table->schidx) {
+        sch_desc_for_each(desc, fieldp) {
+            field_t field = *fieldp;
             switch (field.type) {
                 case DT_INT: {
-                    int64_t val = *(int64_t *) ((char *) row + field.offset);
+                    /* Schemas in declaration order keep elements unaligned */
+                    int64_t val;
+                    memcpy(&val, (char *) row + field.offset, sizeof(val));
                     printf("%-25"PRId64"\t", val);
                     break;
                 }
                 case DT_FLOAT: {
-                    double val = *(double *) ((char *) row + field.offset);
+                    double val;
+                    memcpy(&val, (char *) row + field.offset, sizeof(val));
                     printf("%-25.2f\t", val);
                     break;
                 }
@@ -98,11 +236,13 @@ void tab_print(db_t *db, table_t *table, schema_t *schema) {
                     break;
                 }
                 case DT_VARCHAR: {
-                    vch_ticket_t *vch = (vch_ticket_t *) ((char *) row + field.offset);
-                    char *str = malloc(vch->size);
-                    vch_get(db->varchar_mgr_idx, vch, str);
+                    vch_ticket_t ticket;
+                    vch_ticket_t *vch = sch_varchar_ticket(&field, (char *) row + field.offset, &ticket);
+                    char *str = vch ? vch_acquire(db->varchar_mgr_idx, vch) : NULL;
                     printf("%-25s\t", str);
-                    free(str);
+                    if (str) {
+                        vch_release(vch, str);
+                    }
                     break;
                 }
 
@@ -162,35 +302,21 @@ table_t *tab_join_on_field(
     }
 
     /* Create new schema */
-    schema_t *new_schema = sch_init();
+    schema_t *new_schema = rll_join_schema(left_schema, right_schema);
     if (new_schema == NULL) {
         logger(LL_ERROR, __func__, "Failed to create new schema");
         return NULL;
     }
-    sch_for_each(left_schema, chunk, left_field_t, left_chblix, left->schidx) {
-        if (sch_add_field(new_schema, left_field_t.name, left_field_t.type, (int64_t) left_field_t.size) ==
-            SCHEMA_FAIL) {
-            logger(LL_ERROR, __func__, "Failed to add field %s", left_field_t.name);
-            return NULL;
-        }
-    }
-    sch_for_each(right_schema, chunk2, right_field_t, right_chblix, right->schidx) {
-        if (sch_add_field(new_schema, right_field_t.name, right_field_t.type, (int64_t) right_field_t.size) ==
-            SCHEMA_FAIL) {
-            logger(LL_ERROR, __func__, "Failed to add field %s", right_field_t.name);
-            return NULL;
-        }
-    }
 
     /* Create new table */
-    table_t *table = tab_init(db, name, new_schema);
+    table_t *table = tab_init_result(db, name, new_schema);
     if (table == NULL) {
         logger(LL_ERROR, __func__, "Failed to create new table");
         return NULL;
     }
 
     /* Create new row */
-    void *row = malloc(new_schema->slot_size);
+    void *row = calloc(1, new_schema->slot_size);
 
     void *left_row = malloc(left_schema->slot_size);
     void *right_row = malloc(right_schema->slot_size);
@@ -204,9 +330,9 @@ table_t *tab_join_on_field(
         memcpy(elleft, (char *) left_row + join_field_left->offset, join_field_left->size);
         tab_for_each_row(right, right_chunk, rightt_chblix, right_row, right_schema) {
             memcpy(elright, (char *) right_row + join_field_right->offset, join_field_right->size);
-            if (comp_eq(db, join_field_left->type, elleft, elright)) {
+            if (comp_compare_fields(db, join_field_left, elleft, join_field_right, elright, COND_EQ)) {
                 memcpy(row, left_row, left_schema->slot_size);
-                memcpy((char *) row + left_schema->slot_size, right_row, right_schema->slot_size);
+                memcpy((char *) row + sch_join_offset(left_schema), right_row, right_schema->slot_size);
                 chblix_t rowix = tab_insert(table, new_schema, row);
                 if (chblix_cmp(&rowix, &CHBLIX_FAIL) == 0) {
                     logger(LL_ERROR, __func__, "Failed to insert row");
@@ -250,35 +376,21 @@ table_t *tab_join(db_t *db,
     }
 
     /* Create new schema */
-    schema_t *new_schema = sch_init();
+    schema_t *new_schema = rll_join_schema(left_schema, right_schema);
     if (new_schema == NULL) {
         logger(LL_ERROR, __func__, "Failed to create new schema");
         return NULL;
     }
-    sch_for_each(left_schema, chunk, left_field_t, left_chblix, left->schidx) {
-        if (sch_add_field(new_schema, left_field_t.name, left_field_t.type, (int64_t) left_field_t.size) ==
-            SCHEMA_FAIL) {
-            logger(LL_ERROR, __func__, "Failed to add field %s", left_field_t.name);
-            return NULL;
-        }
-    }
-    sch_for_each(right_schema, chunk2, right_field_t, right_chblix, right->schidx) {
-        if (sch_add_field(new_schema, right_field_t.name, right_field_t.type, (int64_t) right_field_t.size) ==
-            SCHEMA_FAIL) {
-            logger(LL_ERROR, __func__, "Failed to add field %s", right_field_t.name);
-            return NULL;
-        }
-    }
 
     /* Create new table */
-    table_t *table = tab_init(db, name, new_schema);
+    table_t *table = tab_init_result(db, name, new_schema);
     if (table == NULL) {
         logger(LL_ERROR, __func__, "Failed to create new table");
         return NULL;
     }
 
     /* Create new row */
-    void *row = malloc(new_schema->slot_size);
+    void *row = calloc(1, new_schema->slot_size);
 
     void *left_row = malloc(left_schema->slot_size);
     void *right_row = malloc(right_schema->slot_size);
@@ -286,7 +398,7 @@ table_t *tab_join(db_t *db,
     tab_for_each_row(left, left_chunk, leftt_chblix, left_row, left_schema) {
         tab_for_each_row(right, right_chunk, rightt_chblix, right_row, right_schema) {
             memcpy(row, left_row, left_schema->slot_size);
-            memcpy((char *) row + left_schema->slot_size, right_row, right_schema->slot_size);
+            memcpy((char *) row + sch_join_offset(left_schema), right_row, right_schema->slot_size);
             chblix_t rowix = tab_insert(table, new_schema, row);
             if (chblix_cmp(&rowix, &CHBLIX_FAIL) == 0) {
                 logger(LL_ERROR, __func__, "Failed to insert row");
@@ -329,14 +441,14 @@ table_t *tab_select_op(db_t *db,
         return NULL;
     }
     sch_for_each(sel_schema, sch_chunk, field, chblix, sel_table->schidx) {
-        if (sch_add_field(schema, field.name, field.type, (int64_t) field.size) == SCHEMA_FAIL) {
+        if (sch_copy_field_at(schema, &field, 0) == SCHEMA_FAIL) {
             logger(LL_ERROR, __func__, "Failed to add field %s", field.name);
             return NULL;
         }
     }
 
     /* Create new table */
-    table_t *table = tab_init(db, name, schema);
+    table_t *table = tab_init_result(db, name, schema);
     if (table == NULL) {
         logger(LL_ERROR, __func__, "Failed to create new table");
         return NULL;
@@ -353,13 +465,13 @@ table_t *tab_select_op(db_t *db,
 
     void *el_row = malloc(sel_schema->slot_size);
     void *el = malloc(select_field->size);
-    void *comp_val = malloc(select_field->size);
-    memcpy(comp_val, value, select_field->size);
+    comp_pred_t pred;
+    comp_pred_init(&pred, db, select_field, condition, value);
 
     /* Select */
     tab_for_each_row(sel_table, tab_chunk, sel_chblix, el_row, sel_schema) {
         memcpy(el, (char *) el_row + select_field->offset, select_field->size);
-        if (comp_compare(db, type, el, comp_val, condition)) {
+        if (comp_pred_test(&pred, el)) {
             memcpy(row, el_row, schema->slot_size);
             chblix_t rowix = tab_insert(table, schema, row);
             if (chblix_cmp(&rowix, &CHBLIX_FAIL) == 0) {
@@ -368,7 +480,6 @@ table_t *tab_select_op(db_t *db,
             }
         }
     }
-    free(comp_val);
     free(row);
     free(el_row);
     free(el);
@@ -404,25 +515,125 @@ row_likedlist_t *tab_filter(db_t *db,
     if (type != select_field->type) {
         return NULL;
     }
+    if (sch_is_indexed_field(select_field) && idx_supports(select_field->index_kind, condition)) {
+        row_likedlist_free(list);
+        return tab_index_filter(db, sel_table, sel_schema, select_field, condition, value);
+    }
 
     void *el_row = malloc(sel_schema->slot_size);
     void *el = malloc(select_field->size);
-    void *comp_val = malloc(select_field->size);
-    memcpy(comp_val, value, select_field->size);
+    comp_pred_t pred;
+    comp_pred_init(&pred, db, select_field, condition, value);
 
     /* Select */
     tab_for_each_row(sel_table, tab_chunk, sel_chblix, el_row, sel_schema) {
         memcpy(el, (char *) el_row + select_field->offset, select_field->size);
-        if (comp_compare(db, type, el, comp_val, condition)) {
+        if (comp_pred_test(&pred, el)) {
             row_likedlist_add(list, &sel_chblix, el_row, sel_schema, sel_table);
         }
     }
-    free(comp_val);
     free(el_row);
     free(el);
     return list;
 }
 
+static int rrl_validate_join_context(row_likedlist_t *left, row_likedlist_t *right) {
+    if (left == NULL) {
+        logger(LL_ERROR, __func__, "Invalid argument, left table is NULL");
+        return -1;
+    }
+
+    if (right == NULL) {
+        logger(LL_ERROR, __func__, "Invalid argument, right table is NULL");
+        return -1;
+    }
+
+    if (left->schema == NULL) {
+        logger(LL_ERROR, __func__, "Invalid argument, left schema is NULL");
+        return -1;
+    }
+
+    if (right->schema == NULL) {
+        logger(LL_ERROR, __func__, "Invalid argument, right schema is NULL");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief       Create schema of joined rows
+ * @param[in]   left: schema of the left rows
+ * @param[in]   right: schema of the right rows
+ * @return      pointer to schema with fields of the right row after the left row, NULL on failure
+ */
+
+schema_t *rll_join_schema(schema_t *left, schema_t *right) {
+    schema_t *new_schema = sch_init();
+    if (new_schema == NULL) {
+        logger(LL_ERROR, __func__, "Failed to create new schema");
+        return NULL;
+    }
+
+    sch_for_each(left, chunk, left_field, left_chblix, schema_index(left)) {
+        if (sch_copy_field_at(new_schema, &left_field, 0) == SCHEMA_FAIL) {
+            logger(LL_ERROR, __func__, "Failed to add field %s", left_field.name);
+            return NULL;
+        }
+    }
+    sch_for_each(right, chunk2, right_field, right_chblix, schema_index(right)) {
+        if (sch_copy_field_at(new_schema, &right_field, sch_join_offset(left)) == SCHEMA_FAIL) {
+            logger(LL_ERROR, __func__, "Failed to add field %s", right_field.name);
+            return NULL;
+        }
+    }
+    /* Padding at the end of the right row is copied with it */
+    if (new_schema->slot_size < sch_join_offset(left) + right->slot_size) {
+        new_schema->slot_size = sch_join_offset(left) + right->slot_size;
+    }
+    return new_schema;
+}
+
+/**
+ * @brief       Add joined row to the list with sources of the left row
+ * @param[in]   list: list of joined rows
+ * @param[in]   row: joined row
+ * @param[in]   left: node of the left row
+ * @return      node of the joined row, sources of the right row are added to it by the caller
+ */
+
+static row_node_t *rll_add_left(row_likedlist_t *list, void *row, row_node_t *left) {
+    row_likedlist_add(list, &left->rst_head->rowix, row, left->rst_head->schema, left->rst_head->table);
+    row_node_t *current_row = list->tail;
+    for (rst_node_t *rst = left->rst_head->next; rst != NULL; rst = rst->next) {
+        row_likedlist_add_rst(&rst->rowix, current_row, rst->schema, rst->table);
+    }
+    return current_row;
+}
+
+/**
+ * @brief       Add joined row to the list
+ * @param[in]   list: list of joined rows
+ * @param[in]   row: buffer of joined row
+ * @param[in]   left: node of the left row
+ * @param[in]   left_size: slot size of the left row
+ * @param[in]   right: node of the right row
+ * @param[in]   right_size: slot size of the right row
+ */
+
+static void rll_add_joined(row_likedlist_t *list,
+                           void *row,
+                           row_node_t *left,
+                           int64_t left_size,
+                           row_node_t *right,
+                           int64_t right_size) {
+    memcpy(row, left->row, left_size);
+    memcpy((char *) row + sch_row_align(left_size), right->row, right_size);
+    row_node_t *current_row = rll_add_left(list, row, left);
+    for (rst_node_t *rst = right->rst_head; rst != NULL; rst = rst->next) {
+        row_likedlist_add_rst(&rst->rowix, current_row, rst->schema, rst->table);
+    }
+}
+
 row_likedlist_t *rll_filter_var(db_t *db,
                                 row_likedlist_t *right_list,
                                 field_t *right_field,
@@ -434,66 +645,483 @@ row_likedlist_t *rll_filter_var(db_t *db,
         return NULL;
     }
 
-    /* Create new schema */
-    schema_t *new_schema = sch_init();
+    schema_t *new_schema = rll_join_schema(left_list->schema, right_list->schema);
     if (new_schema == NULL) {
-        logger(LL_ERROR, __func__, "Failed to create new schema");
         return NULL;
     }
 
-    sch_for_each(left_list->schema, chunk2, field2, chblix2, schema_index(left_list->schema)) {
-        if (sch_add_field(new_schema, field2.name, field2.type, (int64_t) field2.size) == SCHEMA_FAIL) {
-            logger(LL_ERROR, __func__, "Failed to add field %s", field2.name);
-            return NULL;
+    row_likedlist_t *list = row_likedlist_init(new_schema);
+    if (list == NULL) {
+        logger(LL_ERROR, __func__, "Failed to create new row_likedlist");
+        return NULL;
+    }
+
+    void *el1 = malloc(left_field->size);
+    void *el2 = malloc(right_field->size);
+    void *row = calloc(1, new_schema->slot_size);
+
+    for (row_node_t *current_left = left_list->head; current_left != NULL; current_left = current_left->next) {
+        memcpy(el1, (char *) current_left->row + left_field->offset, left_field->size);
+        for (row_node_t *current_right = right_list->head; current_right != NULL; current_right = current_right->next) {
+            memcpy(el2, (char *) current_right->row + right_field->offset, right_field->size);
+            if (comp_compare_fields(db, left_field, el1, right_field, el2, condition)) {
+                rll_add_joined(list, row, current_left, left_list->schema->slot_size,
+                               current_right, right_list->schema->slot_size);
+            }
         }
     }
 
-    sch_for_each(right_list->schema, chunk, field, chblix, schema_index(right_list->schema)) {
-        if (sch_add_field(new_schema, field.name, field.type, (int64_t) field.size) == SCHEMA_FAIL) {
-            logger(LL_ERROR, __func__, "Failed to add field %s", field.name);
-            return NULL;
+    free(el1);
+    free(el2);
+    free(row);
+    return list;
+}
+
+/**
+ * @brief       Join two lists on equality of fields with hash table
+ * @param[in]   db: pointer to db
+ * @param[in]   right_list: list of the right rows
+ * @param[in]   right_field: field of the right rows
+ * @param[in]   left_list: list of the left rows
+ * @param[in]   left_field: field of the left rows
+ * @return      list of joined rows as rll_filter_var makes with COND_EQ, NULL on failure
+ * @note        hash table is built on the smaller list, joined rows follow order of the other one
+ */
+
+row_likedlist_t *rll_hash_join(db_t *db,
+                               row_likedlist_t *right_list,
+                               field_t *right_field,
+                               row_likedlist_t *left_list,
+                               field_t *left_field) {
+    if (rrl_validate_join_context(left_list, right_list) == -1) {
+        return NULL;
+    }
+    if (left_field->type != right_field->type) {
+        return NULL;
+    }
+
+    schema_t *new_schema = rll_join_schema(left_list->schema, right_list->schema);
+    if (new_schema == NULL) {
+        return NULL;
+    }
+    row_likedlist_t *list = row_likedlist_init(new_schema);
+    if (list == NULL) {
+        logger(LL_ERROR, __func__, "Failed to create new row_likedlist");
+        return NULL;
+    }
+
+    bool build_left = left_list->size < right_list->size;
+    row_likedlist_t *build = build_left ? left_list : right_list;
+    row_likedlist_t *probe = build_left ? right_list : left_list;
+    field_t *build_field = build_left ? left_field : right_field;
+    field_t *probe_field = build_left ? right_field : left_field;
+    /* Fields sharing dictionary are equal when their codes are */
+    bool by_code = sch_is_dict_field(left_field) && left_field->dict == right_field->dict;
+
+    int64_t bucket_count = RLL_HASH_JOIN_MIN_BUCKETS;
+    while (bucket_count < 2 * (int64_t) build->size) {
+        bucket_count *= 2;
+    }
+    int64_t *buckets = malloc(bucket_count * sizeof(int64_t));
+    rll_hash_entry_t *entries = malloc((build->size + 1) * sizeof(rll_hash_entry_t));
+    void *build_el = malloc(build_field->size);
+    void *probe_el = malloc(probe_field->size);
+    void *row = calloc(1, new_schema->slot_size);
+    if (!buckets || !entries || !build_el || !probe_el || !row) {
+        logger(LL_ERROR, __func__, "Failed to allocate hash table of %d rows", build->size);
+        free(buckets);
+        free(entries);
+        free(build_el);
+        free(probe_el);
+        free(row);
+        row_likedlist_free(list);
+        return NULL;
+    }
+    for (int64_t i = 0; i < bucket_count; i++) {
+        buckets[i] = -1;
+    }
+
+    /* Build */
+    int64_t count = 0;
+    for (row_node_t *node = build->head; node != NULL; node = node->next, count++) {
+        entries[count].hash = comp_hash_field(build_field, node->row + build_field->offset, by_code);
+        entries[count].node = node;
+    }
+    /* Chains are filled from the end to keep order of the build list */
+    for (int64_t i = count - 1; i >= 0; i--) {
+        int64_t bucket = (int64_t) (entries[i].hash & (uint64_t) (bucket_count - 1));
+        entries[i].next = buckets[bucket];
+        buckets[bucket] = i;
+    }
+
+    /* Probe */
+    for (row_node_t *node = probe->head; node != NULL; node = node->next) {
+        memcpy(probe_el, node->row + probe_field->offset, probe_field->size);
+        uint64_t hash = comp_hash_field(probe_field, probe_el, by_code);
+        for (int64_t i = buckets[hash & (uint64_t) (bucket_count - 1)]; i != -1; i = entries[i].next) {
+            if (entries[i].hash != hash) {
+                continue;
+            }
+            memcpy(build_el, entries[i].node->row + build_field->offset, build_field->size);
+            bool equal = build_left
+                         ? comp_compare_fields(db, left_field, build_el, right_field, probe_el, COND_EQ)
+                         : comp_compare_fields(db, left_field, probe_el, right_field, build_el, COND_EQ);
+            if (equal) {
+                rll_add_joined(list, row, build_left ? entries[i].node : node, left_list->schema->slot_size,
+                               build_left ? node : entries[i].node, right_list->schema->slot_size);
+            }
         }
     }
 
+    free(buckets);
+    free(entries);
+    free(build_el);
+    free(probe_el);
+    free(row);
+    return list;
+}
+
+/**
+ * @brief       Join list with table on equality of fields through index of the table field
+ * @param[in]   db: pointer to db
+ * @param[in]   table: pointer to the table
+ * @param[in]   schema: pointer to the schema of the table
+ * @param[in]   field: indexed field of the table
+ * @param[in]   left_list: list of the left rows
+ * @param[in]   left_field: field of the left rows
+ * @return      list of joined rows as rll_hash_join makes with rows of the table on the right, NULL on failure
+ * @note        each left row probes the index, rows of the table are read only when they match
+ */
+
+row_likedlist_t *tab_index_join(db_t *db,
+                                table_t *table,
+                                schema_t *schema,
+                                field_t *field,
+                                row_likedlist_t *left_list,
+                                field_t *left_field) {
+    if (left_list == NULL || !sch_is_indexed_field(field) || left_field->type != field->type) {
+        logger(LL_ERROR, __func__, "Invalid argument, field %s can not be joined through index", field->name);
+        return NULL;
+    }
+    schema_t *new_schema = rll_join_schema(left_list->schema, schema);
+    if (new_schema == NULL) {
+        return NULL;
+    }
     row_likedlist_t *list = row_likedlist_init(new_schema);
     if (list == NULL) {
         logger(LL_ERROR, __func__, "Failed to create new row_likedlist");
         return NULL;
     }
+    int64_t left_size = left_list->schema->slot_size;
+    int64_t tablix = table_index(table);
+    void *row = calloc(1, new_schema->slot_size);
+    void *left_el = malloc(left_field->size);
+    if (!row || !left_el) {
+        logger(LL_ERROR, __func__, "Failed to allocate row");
+        free(row);
+        free(left_el);
+        row_likedlist_free(list);
+        return NULL;
+    }
 
-    void *el1 = malloc(right_field->size);
-    void *el2 = malloc(left_field->size);
-    void *row = malloc(new_schema->slot_size);
+    int res = IDX_END;
+    for (row_node_t *node = left_list->head; node != NULL && res != IDX_FAIL; node = node->next) {
+        memcpy(left_el, node->row + left_field->offset, left_field->size);
+        /* Index is keyed by tickets, dictionary code of the left row is decoded */
+        vch_ticket_t ticket;
+        void *value = left_field->type == DT_VARCHAR ? sch_varchar_ticket(left_field, left_el, &ticket) : left_el;
+        idx_cursor_t cursor;
+        if (value == NULL || tab_index_seek(field, COND_EQ, value, &cursor) == IDX_FAIL) {
+            res = IDX_FAIL;
+            break;
+        }
+        chblix_t rowix;
+        while ((res = idx_next(&cursor, &rowix)) == IDX_SUCCESS) {
+            memcpy(row, node->row, left_size);
+            if (tab_select_row(tablix, &rowix, (char *) row + sch_row_align(left_size)) == TABLE_FAIL) {
+                res = IDX_FAIL;
+                break;
+            }
+            row_likedlist_add_rst(&rowix, rll_add_left(list, row, node), schema, table);
+        }
+        idx_cursor_close(&cursor);
+    }
+    free(row);
+    free(left_el);
+    if (res == IDX_FAIL) {
+        logger(LL_ERROR, __func__, "Failed to join through index of %s", field->name);
+        row_likedlist_free(list);
+        return NULL;
+    }
+    return list;
+}
 
-    for (row_node_t *current_left = left_list->head; current_left != NULL; current_left = current_left->next) {
-        memcpy(el1, (char *) current_left->row + left_field->offset, left_field->size);
-        for (row_node_t *current_right = right_list->head; current_right != NULL; current_right = current_right->next) {
-            memcpy(el2, (char *) current_right->row + right_field->offset, right_field->size);
-            if (comp_compare(db, type, el1, el2, condition)) {
-                memcpy(row, current_left->row, left_list->schema->slot_size);
-                memcpy((char *) row + left_list->schema->slot_size, current_right->row, right_list->schema->slot_size);
-                row_likedlist_add(list, &current_left->rst_head->rowix, row, current_left->rst_head->schema,
-                                  current_left->rst_head->table);
-                row_node_t *current_row = list->tail;
-                rst_node_t *current_rst_left = current_left->rst_head->next;
-                while (current_rst_left != NULL) {
-                    row_likedlist_add_rst(&current_rst_left->rowix, current_row, current_rst_left->schema,
-                                          current_rst_left->table);
-                    current_rst_left = current_rst_left->next;
+/**
+ * @brief       Join list with table on equality of fields through cached join index of the table field
+ * @param[in]   db: pointer to db
+ * @param[in]   table: pointer to the table
+ * @param[in]   schema: pointer to the schema of the table
+ * @param[in]   field: field of the table
+ * @param[in]   left_list: list of the left rows
+ * @param[in]   left_field: field of the left rows
+ * @return      list of joined rows as tab_index_join makes, NULL on failure or when join index does not fit
+ *              the budget
+ * @note        join index is built on the first join and reused until the column is written
+ */
+
+row_likedlist_t *tab_cached_join(db_t *db,
+                                 table_t *table,
+                                 schema_t *schema,
+                                 field_t *field,
+                                 row_likedlist_t *left_list,
+                                 field_t *left_field) {
+    if (left_list == NULL || left_field->type != field->type) {
+        logger(LL_ERROR, __func__, "Invalid argument, field %s can not be joined", field->name);
+        return NULL;
+    }
+    join_cache_t *jc = jc_load(table, field);
+    if (jc == NULL) {
+        return NULL;
+    }
+    schema_t *new_schema = rll_join_schema(left_list->schema, schema);
+    if (new_schema == NULL) {
+        return NULL;
+    }
+    row_likedlist_t *list = row_likedlist_init(new_schema);
+    if (list == NULL) {
+        logger(LL_ERROR, __func__, "Failed to create new row_likedlist");
+        return NULL;
+    }
+    int64_t left_size = left_list->schema->slot_size;
+    int64_t tablix = table_index(table);
+    void *row = calloc(1, new_schema->slot_size);
+    void *left_el = malloc(left_field->size);
+    if (!row || !left_el) {
+        logger(LL_ERROR, __func__, "Failed to allocate row");
+        free(row);
+        free(left_el);
+        row_likedlist_free(list);
+        return NULL;
+    }
+
+    for (row_node_t *node = left_list->head; node != NULL; node = node->next) {
+        memcpy(left_el, node->row + left_field->offset, left_field->size);
+        uint64_t hash = comp_hash_field(left_field, left_el, false);
+        jc_for_each_match(jc, hash, rowix) {
+            memcpy(row, node->row, left_size);
+            char *right = (char *) row + sch_row_align(left_size);
+            /* Equal hash still has to be checked on the row */
+            if (tab_select_row(tablix, rowix, right) == TABLE_FAIL) {
+                logger(LL_ERROR, __func__, "Failed to read row of %s", table->name);
+                free(row);
+                free(left_el);
+                row_likedlist_free(list);
+                return NULL;
+            }
+            if (comp_compare_fields(db, left_field, left_el, field, right + field->offset, COND_EQ)) {
+                row_likedlist_add_rst(rowix, rll_add_left(list, row, node), schema, table);
+            }
+        }
+    }
+    free(row);
+    free(left_el);
+    return list;
+}
+
+static int rll_key_cmp_int(const void *a, const void *b) {
+    int64_t x = ((const rll_sort_key_t *) a)->key.int_val;
+    int64_t y = ((const rll_sort_key_t *) b)->key.int_val;
+    return (x > y) - (x < y);
+}
+
+static int rll_key_cmp_float(const void *a, const void *b) {
+    double x = ((const rll_sort_key_t *) a)->key.float_val;
+    double y = ((const rll_sort_key_t *) b)->key.float_val;
+    return (x > y) - (x < y);
+}
+
+static int rll_key_cmp_str(const void *a, const void *b) {
+    return strcmp(((const rll_sort_key_t *) a)->key.char_val, ((const rll_sort_key_t *) b)->key.char_val);
+}
+
+/**
+ * @brief       Free keys made by rll_sort_keys
+ * @param[in]   keys: array of keys
+ * @param[in]   count: number of keys with resolved values
+ * @param[in]   field: field of the keys
+ */
+
+static void rll_sort_keys_free(rll_sort_key_t *keys, int64_t count, field_t *field) {
+    if (field->type == DT_VARCHAR || field->type == DT_CHAR) {
+        for (int64_t i = 0; i < count; i++) {
+            free(keys[i].key.char_val);
+        }
+    }
+    free(keys);
+}
+
+/**
+ * @brief       Make array of rows of list sorted by field
+ * @param[in]   db: pointer to db
+ * @param[in]   list: list of rows
+ * @param[in]   field: field to sort by
+ * @return      array of list->size keys on success, NULL on failure
+ * @note        strings are read once here, sorting compares them in memory
+ */
+
+static rll_sort_key_t *rll_sort_keys(db_t *db, row_likedlist_t *list, field_t *field) {
+    rll_sort_key_t *keys = malloc((list->size + 1) * sizeof(rll_sort_key_t));
+    if (keys == NULL) {
+        logger(LL_ERROR, __func__, "Failed to allocate %d keys", list->size);
+        return NULL;
+    }
+    int64_t count = 0;
+    for (row_node_t *node = list->head; node != NULL; node = node->next, count++) {
+        void *el = node->row + field->offset;
+        keys[count].node = node;
+        switch (field->type) {
+            case DT_INT:
+                memcpy(&keys[count].key.int_val, el, sizeof(int64_t));
+                break;
+            case DT_FLOAT:
+                memcpy(&keys[count].key.float_val, el, sizeof(double));
+                break;
+            case DT_BOOL:
+                keys[count].key.int_val = *(bool *) el;
+                break;
+            case DT_CHAR:
+                keys[count].key.char_val = calloc(1, field->size + 1);
+                if (keys[count].key.char_val) {
+                    memcpy(keys[count].key.char_val, el, field->size);
+                }
+                break;
+            case DT_VARCHAR: {
+                vch_ticket_t ticket;
+                vch_ticket_t *vch = sch_varchar_ticket(field, el, &ticket);
+                char *str = vch ? vch_acquire(db->varchar_mgr_idx, vch) : NULL;
+                keys[count].key.char_val = str ? malloc(vch->size) : NULL;
+                if (keys[count].key.char_val) {
+                    memcpy(keys[count].key.char_val, str, vch->size);
                 }
-                rst_node_t *current_rst_right = current_right->rst_head;
-                while (current_rst_right != NULL) {
-                    row_likedlist_add_rst(&current_rst_right->rowix, current_row, current_rst_right->schema,
-                                          current_rst_right->table);
-                    current_rst_right = current_rst_right->next;
+                if (str) {
+                    vch_release(vch, str);
                 }
+                break;
             }
+            default:
+                logger(LL_ERROR, __func__, "Field %s can not be sorted", field->name);
+                rll_sort_keys_free(keys, count, field);
+                return NULL;
+        }
+        if ((field->type == DT_VARCHAR || field->type == DT_CHAR) && keys[count].key.char_val == NULL) {
+            logger(LL_ERROR, __func__, "Failed to read value of %s", field->name);
+            rll_sort_keys_free(keys, count, field);
+            return NULL;
+        }
+    }
+    switch (field->type) {
+        case DT_FLOAT:
+            qsort(keys, count, sizeof(rll_sort_key_t), rll_key_cmp_float);
+            break;
+        case DT_CHAR:
+        case DT_VARCHAR:
+            qsort(keys, count, sizeof(rll_sort_key_t), rll_key_cmp_str);
+            break;
+        default:
+            qsort(keys, count, sizeof(rll_sort_key_t), rll_key_cmp_int);
+            break;
+    }
+    return keys;
+}
+
+/**
+ * @brief       Join two lists on inequality of fields by sorting and merging them
+ * @param[in]   db: pointer to db
+ * @param[in]   right_list: list of the right rows
+ * @param[in]   right_field: field of the right rows
+ * @param[in]   condition: one of COND_LT, COND_LTE, COND_GT, COND_GTE, left compared to right
+ * @param[in]   left_list: list of the left rows
+ * @param[in]   left_field: field of the left rows
+ * @return      list of joined rows as rll_filter_var makes, NULL on failure
+ * @note        joined rows are ordered by the left field, then by the right field
+ */
+
+row_likedlist_t *rll_merge_join(db_t *db,
+                                row_likedlist_t *right_list,
+                                field_t *right_field,
+                                condition_t condition,
+                                row_likedlist_t *left_list,
+                                field_t *left_field) {
+    if (rrl_validate_join_context(left_list, right_list) == -1) {
+        return NULL;
+    }
+    if (left_field->type != right_field->type) {
+        return NULL;
+    }
+    if (condition == COND_EQ || condition == COND_NEQ) {
+        logger(LL_ERROR, __func__, "Condition %d is not a range", condition);
+        return NULL;
+    }
+
+    schema_t *new_schema = rll_join_schema(left_list->schema, right_list->schema);
+    if (new_schema == NULL) {
+        return NULL;
+    }
+    row_likedlist_t *list = row_likedlist_init(new_schema);
+    if (list == NULL) {
+        logger(LL_ERROR, __func__, "Failed to create new row_likedlist");
+        return NULL;
+    }
+
+    rll_sort_key_t *left_keys = rll_sort_keys(db, left_list, left_field);
+    rll_sort_key_t *right_keys = left_keys ? rll_sort_keys(db, right_list, right_field) : NULL;
+    if (right_keys == NULL) {
+        if (left_keys) {
+            rll_sort_keys_free(left_keys, left_list->size, left_field);
+        }
+        row_likedlist_free(list);
+        return NULL;
+    }
+    int (*cmp)(const void *, const void *) = left_field->type == DT_FLOAT ? rll_key_cmp_float
+                                              : left_field->type == DT_VARCHAR || left_field->type == DT_CHAR
+                                                ? rll_key_cmp_str : rll_key_cmp_int;
+
+    /*
+     * Right rows matching a left row are a suffix (LT, LTE) or a prefix (GT, GTE)
+     * of sorted right rows, its boundary only moves forward with the left row
+     */
+    bool suffix = condition == COND_LT || condition == COND_LTE;
+    bool strict = condition == COND_LT || condition == COND_GTE;
+    int64_t left_size = left_list->schema->slot_size;
+    int64_t right_size = right_list->schema->slot_size;
+    void *row = calloc(1, new_schema->slot_size);
+    if (row == NULL) {
+        logger(LL_ERROR, __func__, "Failed to allocate row");
+        rll_sort_keys_free(left_keys, left_list->size, left_field);
+        rll_sort_keys_free(right_keys, right_list->size, right_field);
+        row_likedlist_free(list);
+        return NULL;
+    }
+    int64_t bound = 0;
+    for (int64_t i = 0; i < left_list->size; i++) {
+        /* First right row greater than the left one when strict, not less otherwise */
+        while (bound < right_list->size) {
+            int res = cmp(&right_keys[bound], &left_keys[i]);
+            if (strict ? res > 0 : res >= 0) {
+                break;
+            }
+            bound++;
+        }
+        int64_t from = suffix ? bound : 0;
+        int64_t to = suffix ? right_list->size : bound;
+        for (int64_t j = from; j < to; j++) {
+            rll_add_joined(list, row, left_keys[i].node, left_size, right_keys[j].node, right_size);
         }
     }
 
-    free(el1);
-    free(el2);
     free(row);
+    rll_sort_keys_free(left_keys, left_list->size, left_field);
+    rll_sort_keys_free(right_keys, right_list->size, right_field);
     return list;
 }
 
@@ -512,14 +1140,14 @@ row_likedlist_t *rll_filter(db_t *db,
 
     void *el_row = malloc(rll->schema->slot_size);
     void *el = malloc(select_field->size);
-    void *comp_val = malloc(select_field->size);
-    memcpy(comp_val, value, select_field->size);
+    comp_pred_t pred;
+    comp_pred_init(&pred, db, select_field, condition, value);
 
     /* Select */
     row_node_t *current = rll->head;
     while (current != NULL) {
         memcpy(el, (char *) current->row + select_field->offset, select_field->size);
-        if (comp_compare(db, type, el, comp_val, condition)) {
+        if (comp_pred_test(&pred, el)) {
             row_likedlist_add(list, &current->rst_head->rowix, current->row, current->rst_head->schema,
                               current->rst_head->table);
             row_node_t *current_row = list->tail;
@@ -533,35 +1161,11 @@ row_likedlist_t *rll_filter(db_t *db,
             current = current->next;
         }
     }
-    free(comp_val);
     free(el_row);
     free(el);
     return list;
 }
 
-static int rrl_validate_join_context(row_likedlist_t *left, row_likedlist_t *right) {
-    if (left == NULL) {
-        logger(LL_ERROR, __func__, "Invalid argument, left table is NULL");
-        return -1;
-    }
-
-    if (right == NULL) {
-        logger(LL_ERROR, __func__, "Invalid argument, right table is NULL");
-        return -1;
-    }
-
-    if (left->schema == NULL) {
-        logger(LL_ERROR, __func__, "Invalid argument, left schema is NULL");
-        return -1;
-    }
-
-    if (right->schema == NULL) {
-        logger(LL_ERROR, __func__, "Invalid argument, right schema is NULL");
-        return -1;
-    }
-    return 0;
-}
-
 row_likedlist_t *
 rll_projection(db_t *db, row_likedlist_t *list, field_t *fields, int64_t num_of_fields, const char *name) {
     if (list == NULL) {
@@ -583,7 +1187,7 @@ rll_projection(db_t *db, row_likedlist_t *list, field_t *fields, int64_t num_of_
 
     for (int64_t i = 0; i < num_of_fields; i++) {
         field_t *field = &fields[i];
-        if (sch_add_field(new_schema, field->name, field->type, (int64_t) field->size) == SCHEMA_FAIL) {
+        if (sch_copy_field(new_schema, field) == SCHEMA_FAIL) {
             logger(LL_ERROR, __func__, "Failed to add field %s", field->name);
             return NULL;
         }
@@ -596,6 +1200,22 @@ rll_projection(db_t *db, row_likedlist_t *list, field_t *fields, int64_t num_of_
         return NULL;
     }
 
+    /* Resolve offsets in new schema once instead of matching names per row */
+    sch_desc_t *desc = sch_desc_load(schema_index(new_schema));
+    if (desc == NULL) {
+        logger(LL_ERROR, __func__, "Failed to load schema descriptor");
+        return NULL;
+    }
+    int64_t offsets[num_of_fields];
+    for (int64_t i = 0; i < num_of_fields; i++) {
+        field_t *field = sch_desc_field(desc, fields[i].name);
+        if (field == NULL) {
+            logger(LL_ERROR, __func__, "Field %s not found", fields[i].name);
+            return NULL;
+        }
+        offsets[i] = field->offset;
+    }
+
     /* Create new row */
     void *row = malloc(new_schema->slot_size);
 
@@ -603,13 +1223,8 @@ rll_projection(db_t *db, row_likedlist_t *list, field_t *fields, int64_t num_of_
     /* Select */
     row_node_t *current = list->head;
     while (current != NULL) {
-        sch_for_each(new_schema, chunk, field, chblix, schema_index(new_schema)) {
-            for (int64_t i = 0; i < num_of_fields; i++) {
-                if (strcmp(field.name, fields[i].name) == 0) {
-                    memcpy((char *) row + field.offset, (char *) current->row + fields[i].offset, fields[i].size);
-                    break;
-                }
-            }
+        for (int64_t i = 0; i < num_of_fields; i++) {
+            memcpy((char *) row + offsets[i], (char *) current->row + fields[i].offset, fields[i].size);
         }
 
         row_likedlist_add(new_list, &current->rst_head->rowix, row, current->rst_head->schema,
@@ -632,28 +1247,11 @@ row_likedlist_t *rll_join(db_t *db,
     if (rrl_validate_join_context(left, right) == -1) {
         return NULL;
     }
-    /* Create new schema */
-    schema_t *new_schema = sch_init();
+    schema_t *new_schema = rll_join_schema(left->schema, right->schema);
     if (new_schema == NULL) {
-        logger(LL_ERROR, __func__, "Failed to create new schema");
         return NULL;
     }
 
-    sch_for_each(left->schema, chunk, left_field_t, left_chblix, schema_index(left->schema)) {
-        if (sch_add_field(new_schema, left_field_t.name, left_field_t.type, (int64_t) left_field_t.size) ==
-            SCHEMA_FAIL) {
-            logger(LL_ERROR, __func__, "Failed to add field %s", left_field_t.name);
-            return NULL;
-        }
-    }
-    sch_for_each(right->schema, chunk2, right_field_t, right_chblix, schema_index(right->schema)) {
-        if (sch_add_field(new_schema, right_field_t.name, right_field_t.type, (int64_t) right_field_t.size) ==
-            SCHEMA_FAIL) {
-            logger(LL_ERROR, __func__, "Failed to add field %s", right_field_t.name);
-            return NULL;
-        }
-    }
-
     row_likedlist_t *list = row_likedlist_init(new_schema);
     if (list == NULL) {
         logger(LL_ERROR, __func__, "Failed to create new row_likedlist");
@@ -661,7 +1259,7 @@ row_likedlist_t *rll_join(db_t *db,
     }
 
     /* Create new row */
-    void *row = malloc(new_schema->slot_size);
+    void *row = calloc(1, new_schema->slot_size);
 
     row_node_t *current_left = left->head;
 
@@ -669,23 +1267,8 @@ row_likedlist_t *rll_join(db_t *db,
     while (current_left != NULL) {
         row_node_t *current_right = right->head;
         while (current_right != NULL) {
-            memcpy(row, current_left->row, left->schema->slot_size);
-            memcpy((char *) row + left->schema->slot_size, current_right->row, right->schema->slot_size);
-            row_likedlist_add(list, &current_left->rst_head->rowix, row, current_left->rst_head->schema,
-                              current_left->rst_head->table);
-            row_node_t *current_row = list->tail;
-            rst_node_t *current_rst_left = current_left->rst_head->next;
-            while (current_rst_left != NULL) {
-                row_likedlist_add_rst(&current_rst_left->rowix, current_row, current_rst_left->schema,
-                                      current_rst_left->table);
-                current_rst_left = current_rst_left->next;
-            }
-            rst_node_t *current_rst_right = current_right->rst_head;
-            while (current_rst_right != NULL) {
-                row_likedlist_add_rst(&current_rst_right->rowix, current_row, current_rst_right->schema,
-                                      current_rst_right->table);
-                current_rst_right = current_rst_right->next;
-            }
+            rll_add_joined(list, row, current_left, left->schema->slot_size,
+                           current_right, right->schema->slot_size);
             current_right = current_right->next;
         }
         current_left = current_left->next;
@@ -694,6 +1277,152 @@ row_likedlist_t *rll_join(db_t *db,
     return list;
 }
 
+/**
+ * @brief       Hash index of row in table
+ * @param[in]   rowix: index of the row
+ * @return      hash of the packed index
+ */
+
+static uint64_t rll_rowix_hash(const chblix_t *rowix) {
+    return comp_mix((uint64_t) rowix->chunk_idx << 32 ^ (uint64_t) rowix->block_idx);
+}
+
+/**
+ * @brief       Build hash table of rows of list by index of their first source row
+ * @param[in]   list: list of rows
+ * @param[out]  bucket_count: number of buckets
+ * @param[out]  entries: entries of rows in order of the list
+ * @return      buckets with chains of entries in order of the list on success, NULL on failure
+ */
+
+static int64_t *rll_rowix_index(row_likedlist_t *list, int64_t *bucket_count, rll_hash_entry_t **entries) {
+    *bucket_count = RLL_HASH_JOIN_MIN_BUCKETS;
+    while (*bucket_count < 2 * (int64_t) list->size) {
+        *bucket_count *= 2;
+    }
+    int64_t *buckets = malloc(*bucket_count * sizeof(int64_t));
+    *entries = malloc((list->size + 1) * sizeof(rll_hash_entry_t));
+    if (!buckets || !*entries) {
+        logger(LL_ERROR, __func__, "Failed to allocate hash table of %d rows", list->size);
+        free(buckets);
+        free(*entries);
+        return NULL;
+    }
+    for (int64_t i = 0; i < *bucket_count; i++) {
+        buckets[i] = -1;
+    }
+    int64_t count = 0;
+    for (row_node_t *node = list->head; node != NULL; node = node->next, count++) {
+        (*entries)[count].hash = rll_rowix_hash(&node->rst_head->rowix);
+        (*entries)[count].node = node;
+    }
+    /* Chains are filled from the end to keep order of the list */
+    for (int64_t i = count - 1; i >= 0; i--) {
+        int64_t bucket = (int64_t) ((*entries)[i].hash & (uint64_t) (*bucket_count - 1));
+        (*entries)[i].next = buckets[bucket];
+        buckets[bucket] = i;
+    }
+    return buckets;
+}
+
+/**
+ * @brief       Find next row with the same first source row
+ * @param[in]   buckets: buckets of hash table built by rll_rowix_index
+ * @param[in]   bucket_count: number of buckets
+ * @param[in]   entries: entries of hash table
+ * @param[in]   rowix: index of the source row
+ * @param[in]   from: entry found before or -1 to find the first one
+ * @return      entry of the row or -1 when there are no more rows
+ */
+
+static int64_t rll_rowix_find(int64_t *buckets, int64_t bucket_count, rll_hash_entry_t *entries,
+                              chblix_t *rowix, int64_t from) {
+    uint64_t hash = rll_rowix_hash(rowix);
+    int64_t i = from == -1 ? buckets[hash & (uint64_t) (bucket_count - 1)] : entries[from].next;
+    for (; i != -1; i = entries[i].next) {
+        if (entries[i].hash == hash && chblix_cmp(&entries[i].node->rst_head->rowix, rowix) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief       Check that rows of list have different first source rows
+ * @param[in]   list: list of rows
+ * @return      true if no two rows share index of their first source row, false otherwise or on failure
+ */
+
+bool rll_unique_rowix(row_likedlist_t *list) {
+    int64_t bucket_count;
+    rll_hash_entry_t *entries;
+    int64_t *buckets = rll_rowix_index(list, &bucket_count, &entries);
+    if (buckets == NULL) {
+        return false;
+    }
+    bool unique = true;
+    int64_t i = 0;
+    for (row_node_t *node = list->head; node != NULL && unique; node = node->next, i++) {
+        /* Chains keep order of the list, so only the first of equal rows finds itself */
+        unique = rll_rowix_find(buckets, bucket_count, entries, &node->rst_head->rowix, -1) == i;
+    }
+    free(buckets);
+    free(entries);
+    return unique;
+}
+
+/**
+ * @brief       Mark rows of list matching condition
+ * @param[in]   db: pointer to db
+ * @param[in]   rll: list of rows
+ * @param[in]   select_field: field of rows to compare
+ * @param[in]   condition: comparison condition
+ * @param[in]   value: value to compare with
+ * @param[out]  bits: bitmap of positions of rows in the list, rll_bitmap_words(rll->size) words
+ */
+
+void rll_filter_bits(db_t *db,
+                     row_likedlist_t *rll,
+                     field_t *select_field,
+                     condition_t condition,
+                     void *value,
+                     uint64_t *bits) {
+    memset(bits, 0, rll_bitmap_words(rll->size) * sizeof(uint64_t));
+    comp_pred_t pred;
+    comp_pred_init(&pred, db, select_field, condition, value);
+    int64_t i = 0;
+    for (row_node_t *current = rll->head; current != NULL; current = current->next, i++) {
+        bits[i / 64] |= (uint64_t) comp_pred_test(&pred, current->row + select_field->offset) << (i % 64);
+    }
+}
+
+/**
+ * @brief       Copy marked rows of list
+ * @param[in]   rll: list of rows
+ * @param[in]   bits: bitmap of positions of rows in the list
+ * @return      list of marked rows in order of the list as rll_filter makes it, NULL on failure
+ */
+
+row_likedlist_t *rll_select_bits(row_likedlist_t *rll, const uint64_t *bits) {
+    row_likedlist_t *list = row_likedlist_init(rll->schema);
+    if (list == NULL) {
+        logger(LL_ERROR, __func__, "Failed to create new row_likedlist");
+        return NULL;
+    }
+    int64_t i = 0;
+    for (row_node_t *current = rll->head; current != NULL; current = current->next, i++) {
+        if (!rll_bitmap_test(bits, i)) {
+            continue;
+        }
+        row_likedlist_add(list, &current->rst_head->rowix, current->row, current->rst_head->schema,
+                          current->rst_head->table);
+        for (rst_node_t *rst = current->rst_head->next; rst != NULL; rst = rst->next) {
+            row_likedlist_add_rst(&rst->rowix, list->tail, rst->schema, rst->table);
+        }
+    }
+    return list;
+}
+
 row_likedlist_t *rll_join_or(row_likedlist_t *left,
                              row_likedlist_t *right) {
     if (rrl_validate_join_context(left, right) == -1) {
@@ -707,8 +1436,7 @@ row_likedlist_t *rll_join_or(row_likedlist_t *left,
     }
 
     sch_for_each(left->schema, chunk, left_field_t, left_chblix, schema_index(left->schema)) {
-        if (sch_add_field(new_schema, left_field_t.name, left_field_t.type, (int64_t) left_field_t.size) ==
-            SCHEMA_FAIL) {
+        if (sch_copy_field_at(new_schema, &left_field_t, 0) == SCHEMA_FAIL) {
             logger(LL_ERROR, __func__, "Failed to add field %s", left_field_t.name);
             return NULL;
         }
@@ -720,9 +1448,17 @@ row_likedlist_t *rll_join_or(row_likedlist_t *left,
         return NULL;
     }
 
-    /* Create new row */
-    void *row = malloc(new_schema->slot_size);
-
+    /* Create new row, rows of right list are cut to the fields of the left one */
+    void *row = calloc(1, left->schema->slot_size > right->schema->slot_size ? left->schema->slot_size
+                                                                              : right->schema->slot_size);
+    int64_t bucket_count;
+    rll_hash_entry_t *entries;
+    int64_t *buckets = rll_rowix_index(left, &bucket_count, &entries);
+    if (row == NULL || buckets == NULL) {
+        free(row);
+        row_likedlist_free(list);
+        return NULL;
+    }
 
     /* Join */
     for (row_node_t *current_left = left->head; current_left != NULL; current_left = current_left->next) {
@@ -739,13 +1475,7 @@ row_likedlist_t *rll_join_or(row_likedlist_t *left,
     }
 
     for (row_node_t *current_right = right->head; current_right != NULL; current_right = current_right->next) {
-        row_node_t *current_left = left->head;
-        for (; current_left != NULL; current_left = current_left->next) {
-            if (chblix_cmp(&current_right->rst_head->rowix, &current_left->rst_head->rowix) == 0) {
-                break;
-            }
-        }
-        if (current_left != NULL) {
+        if (rll_rowix_find(buckets, bucket_count, entries, &current_right->rst_head->rowix, -1) != -1) {
             continue;
         }
         memcpy(row, current_right->row, right->schema->slot_size);
@@ -758,6 +1488,8 @@ row_likedlist_t *rll_join_or(row_likedlist_t *left,
         }
     }
     free(row);
+    free(buckets);
+    free(entries);
     return list;
 }
 
@@ -774,8 +1506,7 @@ row_likedlist_t *rll_join_and(row_likedlist_t *left,
     }
 
     sch_for_each(left->schema, chunk, left_field_t, left_chblix, schema_index(left->schema)) {
-        if (sch_add_field(new_schema, left_field_t.name, left_field_t.type, (int64_t) left_field_t.size) ==
-            SCHEMA_FAIL) {
+        if (sch_copy_field_at(new_schema, &left_field_t, 0) == SCHEMA_FAIL) {
             logger(LL_ERROR, __func__, "Failed to add field %s", left_field_t.name);
             return NULL;
         }
@@ -787,33 +1518,44 @@ row_likedlist_t *rll_join_and(row_likedlist_t *left,
         return NULL;
     }
 
-    /* Create new row */
-    void *row = malloc(new_schema->slot_size);
+    /* Create new row, the whole left row is copied including padding after its last field */
+    void *row = calloc(1, left->schema->slot_size);
+    int64_t bucket_count;
+    rll_hash_entry_t *entries;
+    int64_t *buckets = rll_rowix_index(right, &bucket_count, &entries);
+    if (row == NULL || buckets == NULL) {
+        free(row);
+        row_likedlist_free(list);
+        return NULL;
+    }
 
     /* Join */
     for (row_node_t *current_left = left->head; current_left != NULL; current_left = current_left->next) {
-        for (row_node_t *current_right = right->head; current_right != NULL; current_right = current_right->next) {
-            if (chblix_cmp(&current_left->rst_head->rowix, &current_right->rst_head->rowix) == 0) {
-                memcpy(row, current_left->row, left->schema->slot_size);
-                row_likedlist_add(list, &current_left->rst_head->rowix, row, current_left->rst_head->schema,
-                                  current_left->rst_head->table);
-                row_node_t *current_row = list->tail;
-                rst_node_t *current_rst_left = current_left->rst_head->next;
-                while (current_rst_left != NULL) {
-                    row_likedlist_add_rst(&current_rst_left->rowix, current_row, current_rst_left->schema,
-                                          current_rst_left->table);
-                    current_rst_left = current_rst_left->next;
-                }
-                rst_node_t *current_rst_right = current_right->rst_head;
-                while (current_rst_right != NULL) {
-                    row_likedlist_add_rst(&current_rst_right->rowix, current_row, current_rst_right->schema,
-                                          current_rst_right->table);
-                    current_rst_right = current_rst_right->next;
-                }
+        chblix_t *rowix = &current_left->rst_head->rowix;
+        for (int64_t i = rll_rowix_find(buckets, bucket_count, entries, rowix, -1); i != -1;
+             i = rll_rowix_find(buckets, bucket_count, entries, rowix, i)) {
+            row_node_t *current_right = entries[i].node;
+            memcpy(row, current_left->row, left->schema->slot_size);
+            row_likedlist_add(list, &current_left->rst_head->rowix, row, current_left->rst_head->schema,
+                              current_left->rst_head->table);
+            row_node_t *current_row = list->tail;
+            rst_node_t *current_rst_left = current_left->rst_head->next;
+            while (current_rst_left != NULL) {
+                row_likedlist_add_rst(&current_rst_left->rowix, current_row, current_rst_left->schema,
+                                      current_rst_left->table);
+                current_rst_left = current_rst_left->next;
+            }
+            rst_node_t *current_rst_right = current_right->rst_head;
+            while (current_rst_right != NULL) {
+                row_likedlist_add_rst(&current_rst_right->rowix, current_row, current_rst_right->schema,
+                                      current_rst_right->table);
+                current_rst_right = current_rst_right->next;
             }
         }
     }
     free(row);
+    free(buckets);
+    free(entries);
     return list;
 }
 
@@ -834,13 +1576,13 @@ table_t *tab_rll2table(db_t *db, row_likedlist_t *row_ll, const char *name) {
         return NULL;
     }
     sch_for_each(row_ll->schema, chunk, field, chblix, schema_index(row_ll->schema)) {
-        if (sch_add_field(schema, field.name, field.type, (int64_t) field.size) == SCHEMA_FAIL) {
+        if (sch_copy_field_at(schema, &field, 0) == SCHEMA_FAIL) {
             logger(LL_ERROR, __func__, "Failed to add field %s", field.name);
             return NULL;
         }
     }
 
-    table_t *table = tab_init(db, name, schema);
+    table_t *table = tab_init_result(db, name, schema);
     if (table == NULL) {
         logger(LL_ERROR, __func__, "Failed to create new table");
         return NULL;
@@ -860,7 +1602,72 @@ table_t *tab_rll2table(db_t *db, row_likedlist_t *row_ll, const char *name) {
     return table;
 }
 
+/**
+ * @brief       Write rows handed out by operator to new table, reading them by batches
+ * @param[in]   db: pointer to db
+ * @param[in]   op: pointer to the operator, it is opened and closed here
+ * @param[in]   name: name of the new table
+ * @return      pointer to the new table on success, NULL on failure
+ */
+
+table_t *tab_op2table(db_t *db, operator_t *op, const char *name) {
+    schema_t *schema = sch_init();
+    if (schema == NULL) {
+        logger(LL_ERROR, __func__, "Failed to create new schema");
+        return NULL;
+    }
+    sch_for_each(op->schema, chunk, field, chblix, schema_index(op->schema)) {
+        if (sch_copy_field_at(schema, &field, 0) == SCHEMA_FAIL) {
+            logger(LL_ERROR, __func__, "Failed to add field %s", field.name);
+            return NULL;
+        }
+    }
+
+    table_t *table = tab_init_result(db, name, schema);
+    if (table == NULL) {
+        logger(LL_ERROR, __func__, "Failed to create new table");
+        return NULL;
+    }
+
+    op_batch_t *batch = op_batch_init(op->schema->slot_size);
+    if (batch == NULL || op_open(op) == OP_FAIL) {
+        logger(LL_ERROR, __func__, "Failed to open operator");
+        op_batch_free(batch);
+        return NULL;
+    }
+    int res;
+    while ((res = op_next_batch(op, batch)) == OP_SUCCESS) {
+        for (int64_t i = 0; i < batch->selected && res == OP_SUCCESS; i++) {
+            chblix_t rowix = tab_insert(table, op->schema, op_batch_row(batch, i));
+            if (chblix_cmp(&rowix, &CHBLIX_FAIL) == 0) {
+                logger(LL_ERROR, __func__, "Failed to insert row");
+                res = OP_FAIL;
+            }
+        }
+        if (res == OP_FAIL) {
+            break;
+        }
+    }
+    op_close(op);
+    op_batch_free(batch);
+    return res == OP_FAIL ? NULL : table;
+}
+
 row_likedlist_t *tab_table2rll(db_t *db, table_t *table) {
+    return tab_scan(db, table, NULL, NULL);
+}
+
+/**
+ * @brief       Read rows of table matching predicate into list
+ * @param[in]   db: pointer to db
+ * @param[in]   table: pointer to the table
+ * @param[in]   pred: predicate on row read from the table, NULL to read all rows
+ * @param[in]   arg: argument of the predicate
+ * @return      list of rows on success, NULL on failure
+ * @note        rows failing the predicate are not copied to the list
+ */
+
+row_likedlist_t *tab_scan(db_t *db, table_t *table, tab_row_pred_t pred, void *arg) {
     schema_t *schema = sch_load(table->schidx);
     row_likedlist_t *list = row_likedlist_init(schema);
     if (list == NULL) {
@@ -869,7 +1676,9 @@ row_likedlist_t *tab_table2rll(db_t *db, table_t *table) {
     }
     void *row = malloc(schema->slot_size);
     tab_for_each_row(table, tab_chunk, chblix, row, schema) {
-        row_likedlist_add(list, &chblix, row, schema, table);
+        if (pred == NULL || pred(row, arg)) {
+            row_likedlist_add(list, &chblix, row, schema, table);
+        }
     }
     free(row);
     return list;
@@ -883,7 +1692,15 @@ row_likedlist_t *tab_table2rll(db_t *db, table_t *table) {
  */
 
 int tab_drop(db_t *db, table_t *table) {
-    if (mtab_delete(db->meta_table_idx, table_index(table)) == TABLE_FAIL) {
+    if (tab_destroy_indexes(table) == TABLE_FAIL) {
+        logger(LL_ERROR, __func__, "Failed to destroy indexes of table %"PRId64, table_index(table));
+        return PPL_FAIL;
+    }
+    if (tab_release_varchars(table, sch_load(table->schidx)) == TABLE_FAIL) {
+        logger(LL_ERROR, __func__, "Failed to free varchars of table %"PRId64, table_index(table));
+        return PPL_FAIL;
+    }
+    if (!pg_is_temp(table_index(table)) && mtab_delete(db->meta_table_idx, table_index(table)) == TABLE_FAIL) {
         logger(LL_ERROR, __func__, "Failed to delete table %"PRId64, table_index(table));
         return PPL_FAIL;
     }
@@ -912,18 +1729,22 @@ int tab_update_row_op(db_t *db,
                       void *value,
                       datatype_t type,
                       void *row) {
+    /* Check if datatype of field equals datatype of value */
+    if (type != field->type) {
+        return TABLE_FAIL;
+    }
 
     void *el_row = malloc(schema->slot_size);
     void *el = malloc(field->size);
-    void *comp_val = malloc(field->size);
-    memcpy(comp_val, value, field->size);
+    comp_pred_t pred;
+    comp_pred_init(&pred, db, field, condition, value);
     int64_t counter = 0;
 
     /* Update */
     tab_for_each_row(table, upd_chunk, upd_chblix, el_row, schema) {
         counter++;
         memcpy(el, (char *) el_row + field->offset, field->size);
-        if (comp_compare(db, type, el, comp_val, condition)) {
+        if (comp_pred_test(&pred, el)) {
             memcpy(el_row, row, schema->slot_size);
             if (tab_update_row(table, schema, &upd_chblix, el_row) == TABLE_FAIL) {
                 logger(LL_ERROR, __func__, "Failed to update row");
@@ -935,7 +1756,6 @@ int tab_update_row_op(db_t *db,
         }
     }
     printf("counter %"PRId64"\n", counter);
-    free(comp_val);
     free(el_row);
     free(el);
     return TABLE_SUCCESS;
@@ -999,13 +1819,13 @@ int tab_update_element_op(db_t *db,
     void *el_row = malloc(upd_schema->slot_size);
     void *el = malloc(comp_field.size);
     void *upd_el = malloc(upd_field.size);
-    void *comp_val = malloc(comp_field.size);
-    memcpy(comp_val, value, comp_field.size);
+    comp_pred_t pred;
+    comp_pred_init(&pred, db, &comp_field, condition, value);
 
     /* Update */
     tab_for_each_row(upd_tab, upd_chunk, upd_chblix, el_row, upd_schema) {
         memcpy(el, (char *) el_row + comp_field.offset, comp_field.size);
-        if (comp_compare(db, type, el, comp_val, condition)) {
+        if (comp_pred_test(&pred, el)) {
             memcpy(upd_el, element, upd_field.size);
             if (tab_update_element(upd_tab, &upd_chblix, &upd_field, upd_el) == TABLE_FAIL) {
                 logger(LL_ERROR, __func__, "Failed to update row");
@@ -1014,7 +1834,6 @@ int tab_update_element_op(db_t *db,
         }
     }
     free(upd_el);
-    free(comp_val);
     free(el_row);
     free(el);
     return TABLE_SUCCESS;
@@ -1040,8 +1859,8 @@ int tab_delete_op(db_t *db,
 
     void *el_row = malloc(schema->slot_size);
     void *el = malloc(field_comp->size);
-    void *comp_val = malloc(field_comp->size);
-    memcpy(comp_val, value, field_comp->size);
+    comp_pred_t pred;
+    comp_pred_init(&pred, db, field_comp, condition, value);
     int64_t counter = 0;
 
     /* Delete */
@@ -1050,7 +1869,7 @@ int tab_delete_op(db_t *db,
         memcpy(el, (char *) el_row + field_comp->offset, field_comp->size);
 //        int64_t* id = el;
 //        printf("c: %lld | b: %lld | id: %lld\n", del_chblix.chunk_idx, del_chblix.block_idx, *id);
-        if (comp_compare(db, field_comp->type, el, comp_val, condition)) {
+        if (comp_pred_test(&pred, el)) {
             chblix_t temp = del_chblix;
             bool flag = false;
             if (del_chunk->num_of_free_blocks + 1 == del_chunk->capacity) {
@@ -1068,7 +1887,6 @@ int tab_delete_op(db_t *db,
             }
         }
     }
-    free(comp_val);
     free(el_row);
     free(el);
 //    int64_t* val = value;
@@ -1105,14 +1923,14 @@ table_t *tab_projection(db_t *db,
         return NULL;
     }
     for (int64_t i = 0; i < num_of_fields; ++i) {
-        if (sch_add_field(new_schema, fields[i].name, fields[i].type, (int64_t) fields[i].size) == SCHEMA_FAIL) {
+        if (sch_copy_field_at(new_schema, &fields[i], 0) == SCHEMA_FAIL) {
             logger(LL_ERROR, __func__, "Failed to add field %s", fields[i].name);
             return NULL;
         }
     }
 
     /* Create new table */
-    table_t *new_table = tab_init(db, name, new_schema);
+    table_t *new_table = tab_init_result(db, name, new_schema);
     if (new_table == NULL) {
         logger(LL_ERROR, __func__, "Failed to create new table");
         return NULL;
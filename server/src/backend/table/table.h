@@ -3,9 +3,36 @@
 #include "backend/utils/row_likedlist.h"
 #include "backend/db/db.h"
 #include "backend/journal/metatab.h"
+#include "join_cache.h"
 #include "table_base.h"
 #include <inttypes.h>
 
+/**
+ * Equality joins of row lists use hash table on the smaller list, its buckets
+ * start from this count and double until there are two per row.
+ */
+
+#ifndef RLL_HASH_JOIN_MIN_BUCKETS
+#define RLL_HASH_JOIN_MIN_BUCKETS 16
+#endif
+
+/**
+ * Predicate of scan, gets row read from the table and argument given to the
+ * scan. Rows it rejects are never copied out of the table.
+ */
+
+typedef bool (*tab_row_pred_t)(void *row, void *arg);
+
+/**
+ * Sets of rows of a list as bitmaps over positions of rows in the list, one
+ * bit per row. Conditions of a filter mark rows in their own bitmaps, AND and
+ * OR of them are word by word, rows are copied once for the whole filter.
+ */
+
+#define rll_bitmap_words(size) (((int64_t) (size) + 63) / 64)
+#define rll_bitmap_test(bits, i) (((bits)[(i) / 64] >> ((i) % 64)) & 1)
+
+struct operator;
 
 table_t* tab_init(db_t* db, const char* name, schema_t* schema);
 chblix_t tab_get_row(db_t* db,
@@ -79,6 +106,12 @@ row_likedlist_t *tab_filter(db_t *db,
                             condition_t condition,
                             void *value,
                             datatype_t type);
+row_likedlist_t *tab_index_filter(db_t *db,
+                                  table_t *table,
+                                  schema_t *schema,
+                                  field_t *field,
+                                  condition_t condition,
+                                  void *value);
 row_likedlist_t *rll_filter(db_t *db,
                             row_likedlist_t *rll,
                             field_t *select_field,
@@ -100,11 +133,49 @@ row_likedlist_t *rll_filter_var(db_t *db,
                                 field_t *left_field,
                                 datatype_t type);
 
+row_likedlist_t *rll_hash_join(db_t *db,
+                               row_likedlist_t *right_list,
+                               field_t *right_field,
+                               row_likedlist_t *left_list,
+                               field_t *left_field);
+
+row_likedlist_t *tab_index_join(db_t *db,
+                                table_t *table,
+                                schema_t *schema,
+                                field_t *field,
+                                row_likedlist_t *left_list,
+                                field_t *left_field);
+
+row_likedlist_t *tab_cached_join(db_t *db,
+                                 table_t *table,
+                                 schema_t *schema,
+                                 field_t *field,
+                                 row_likedlist_t *left_list,
+                                 field_t *left_field);
+
+row_likedlist_t *rll_merge_join(db_t *db,
+                                row_likedlist_t *right_list,
+                                field_t *right_field,
+                                condition_t condition,
+                                row_likedlist_t *left_list,
+                                field_t *left_field);
+
+bool rll_unique_rowix(row_likedlist_t *list);
+void rll_filter_bits(db_t *db,
+                     row_likedlist_t *rll,
+                     field_t *select_field,
+                     condition_t condition,
+                     void *value,
+                     uint64_t *bits);
+row_likedlist_t *rll_select_bits(row_likedlist_t *rll, const uint64_t *bits);
 row_likedlist_t *rll_join_or(row_likedlist_t *left,
                              row_likedlist_t *right);
 row_likedlist_t *rll_join_and(row_likedlist_t *left,
                               row_likedlist_t *right);
 
 row_likedlist_t* tab_table2rll(db_t *db, table_t *table);
+row_likedlist_t *tab_scan(db_t *db, table_t *table, tab_row_pred_t pred, void *arg);
 table_t *tab_rll2table(db_t *db, row_likedlist_t *row_ll, const char *name);
+table_t *tab_op2table(db_t *db, struct operator *op, const char *name);
+schema_t *rll_join_schema(schema_t *left, schema_t *right);
 
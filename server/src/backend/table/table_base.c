@@ -1,4 +1,7 @@
 #include "table_base.h"
+#include "join_cache.h"
+#include "schema_desc.h"
+#include "core/io/pager.h"
 #include "utils/logger.h"
 #include <stdio.h>
 
@@ -41,9 +44,239 @@ table_t* tab_base_init(const char* name, schema_t* schema){
     }
     table->schidx = schema_index(schema);
     strncpy(table->name, name, MAX_NAME_LENGTH);
+    table->vchmgr_idx = TAB_SHARED_VARCHARS;
     return table;
 }
 
+/**
+ * @brief       Fill columns missing in a row written with older schema
+ * @param[in]   table: pointer to table
+ * @param[out]  dest: part of row read from table, missing bytes are zeroed
+ * @param[in]   size: size of the part
+ * @param[in]   offset: offset of the part in row
+ * @return      TABLE_SUCCESS on success, TABLE_FAIL on failure
+ * @note        zero is the default of every type except plain varchar, whose
+ *              zeroed ticket becomes empty string
+ */
+
+static int tab_fill_defaults(table_t* table, void* dest, int64_t size, int64_t offset){
+    sch_desc_t* desc = sch_desc_load(table->schidx);
+    if(!desc){
+        return TABLE_FAIL;
+    }
+    sch_desc_for_each(desc, field){
+        if(field->type != DT_VARCHAR || sch_is_dict_field(field) ||
+           (int64_t) field->offset < offset || (int64_t)(field->offset + field->size) > offset + size){
+            continue;
+        }
+        vch_ticket_t* ticket = (vch_ticket_t*)((char*) dest + field->offset - offset);
+        /* Stored tickets count '\0' in size, zero means the column was added later */
+        if(ticket->size == 0 && vch_put(table->vchmgr_idx, "", ticket, (int64_t) field->size) == LB_FAIL){
+            return TABLE_FAIL;
+        }
+    }
+    return TABLE_SUCCESS;
+}
+
+/**
+ * @brief       Read part of a row
+ * @param[in]   table: pointer to table
+ * @param[in]   chunk: chunk of the row
+ * @param[in]   rowix: chblix of the row
+ * @param[out]  dest: destination
+ * @param[in]   size: size to read
+ * @param[in]   offset: offset in row
+ * @return      TABLE_SUCCESS on success, TABLE_FAIL on failure
+ */
+
+int tab_read_nova(table_t* table, chunk_t* chunk, chblix_t* rowix, void* dest, int64_t size, int64_t offset){
+    int res = lb_read_nova(&table->ppl_header, chunk, rowix, dest, size, offset);
+    if(res == LB_FAIL){
+        return TABLE_FAIL;
+    }
+    if(res == LB_PARTIAL && tab_fill_defaults(table, dest, size, offset) == TABLE_FAIL){
+        logger(LL_ERROR, __func__, "Failed to fill missing columns of row");
+        return TABLE_FAIL;
+    }
+    return TABLE_SUCCESS;
+}
+
+/**
+ * @brief       Check if element of field holds varchar owned by the table
+ * @param[in]   table: pointer to table
+ * @param[in]   field: pointer to field
+ * @return      true if element must be freed with the row
+ */
+
+static bool tab_owns_element(table_t* table, field_t* field){
+    return table->vchmgr_idx != TAB_SHARED_VARCHARS && field->type == DT_VARCHAR && !sch_is_dict_field(field);
+}
+
+/**
+ * @brief       Free varchar stored in element of a row, unless the new element keeps it
+ * @param[in]   table: pointer to table
+ * @param[in]   rowix: chblix of the row
+ * @param[in]   field: pointer to field
+ * @param[in]   element: new element that replaces the old one or NULL
+ * @return      TABLE_SUCCESS on success, TABLE_FAIL on failure
+ */
+
+static int tab_release_element(table_t* table, chblix_t* rowix, field_t* field, void* element){
+    if(!tab_owns_element(table, field)){
+        return TABLE_SUCCESS;
+    }
+    vch_ticket_t* old = malloc(field->size);
+    if(tab_read_nova(table, ppl_load_chunk(rowix->chunk_idx), rowix, old,
+                     (int64_t) field->size, (int64_t) field->offset) == TABLE_FAIL){
+        logger(LL_ERROR, __func__, "Failed to read element %s", field->name);
+        free(old);
+        return TABLE_FAIL;
+    }
+    int res = LB_SUCCESS;
+    if(element == NULL || memcmp(old, element, field->size) != 0){
+        res = vch_delete(table->vchmgr_idx, old);
+    }
+    free(old);
+    return res == LB_FAIL ? TABLE_FAIL : TABLE_SUCCESS;
+}
+
+/**
+ * @brief       Free varchars stored in a row
+ * @param[in]   table: pointer to table
+ * @param[in]   rowix: chblix of the row
+ * @param[in]   row: new row that replaces the old one or NULL
+ * @return      TABLE_SUCCESS on success, TABLE_FAIL on failure
+ */
+
+static int tab_release_row(table_t* table, chblix_t* rowix, void* row){
+    if(table->vchmgr_idx == TAB_SHARED_VARCHARS){
+        return TABLE_SUCCESS;
+    }
+    sch_desc_t* desc = sch_desc_load(table->schidx);
+    if(!desc){
+        return TABLE_FAIL;
+    }
+    sch_desc_for_each(desc, field){
+        if(tab_release_element(table, rowix, field, row ? (char*) row + field->offset : NULL) == TABLE_FAIL){
+            return TABLE_FAIL;
+        }
+    }
+    return TABLE_SUCCESS;
+}
+
+/**
+ * @brief       Make index key of element
+ * @param[in]   field: indexed field
+ * @param[in]   element: element of the field
+ * @param[out]  key: buffer of tab_index_key_size bytes
+ * @return      TABLE_SUCCESS on success, TABLE_FAIL on failure
+ */
+
+static int tab_index_key(const field_t* field, void* element, void* key){
+    if(!sch_is_dict_field(field)){
+        memcpy(key, element, field->size);
+        return TABLE_SUCCESS;
+    }
+    int32_t code;
+    memcpy(&code, element, sizeof(int32_t));
+    if(dict_ticket(field->dict, code, key) == PA_FAIL){
+        logger(LL_ERROR, __func__, "Failed to decode value %d of field %s", code, field->name);
+        return TABLE_FAIL;
+    }
+    return TABLE_SUCCESS;
+}
+
+/**
+ * @brief       Add or remove entry of an indexed column
+ * @param[in]   table: pointer to table
+ * @param[in]   rowix: chblix of the row
+ * @param[in]   field: indexed field
+ * @param[in]   part: bytes of the part holding the element, NULL to read the element stored in row
+ * @param[in]   offset: offset of the part in row
+ * @param[in]   insert: true to add the entry, false to remove it
+ * @return      TABLE_SUCCESS on success, TABLE_FAIL on failure
+ */
+
+static int tab_index_field(table_t* table, chblix_t* rowix, const field_t* field,
+                           void* part, int64_t offset, bool insert){
+    void* key = malloc(tab_index_key_size(field) + field->size);
+    if(key == NULL){
+        logger(LL_ERROR, __func__, "Failed to allocate key of %s", field->name);
+        return TABLE_FAIL;
+    }
+    void* element = (char*) key + tab_index_key_size(field);
+    int res = TABLE_SUCCESS;
+    if(part != NULL){
+        memcpy(element, (char*) part + field->offset - offset, field->size);
+    } else if(tab_read_nova(table, ppl_load_chunk(rowix->chunk_idx), rowix, element,
+                            (int64_t) field->size, (int64_t) field->offset) == TABLE_FAIL){
+        res = TABLE_FAIL;
+    }
+    if(res == TABLE_SUCCESS && tab_index_key(field, element, key) == TABLE_FAIL){
+        res = TABLE_FAIL;
+    }
+    if(res == TABLE_SUCCESS &&
+       (insert ? idx_insert(field->index_kind, field->index, key, rowix)
+               : idx_delete(field->index_kind, field->index, key, rowix)) == IDX_FAIL){
+        logger(LL_ERROR, __func__, "Failed to update index of %s", field->name);
+        res = TABLE_FAIL;
+    }
+    free(key);
+    return res;
+}
+
+/**
+ * @brief       Add or remove entries of indexed columns in rewritten part of row,
+ *              join indexes of columns in the part are dropped with removed entries
+ * @param[in]   table: pointer to table
+ * @param[in]   rowix: chblix of the row
+ * @param[in]   part: bytes of the part, NULL to use bytes stored in row
+ * @param[in]   size: size of the part
+ * @param[in]   offset: offset of the part in row
+ * @param[in]   insert: true to add entries, false to remove them
+ * @return      TABLE_SUCCESS on success, TABLE_FAIL on failure
+ * @note        on failure indexes are left as they were before the call
+ */
+
+static int tab_index_part(table_t* table, chblix_t* rowix, void* part, int64_t size, int64_t offset, bool insert){
+    /* Stored row is about to change, inserted rows are added to join indexes by tab_insert */
+    if(!insert){
+        jc_invalidate(table_index(table), offset, size);
+    }
+    sch_desc_t* desc = sch_desc_load(table->schidx);
+    if(!desc){
+        return TABLE_FAIL;
+    }
+    field_t* failed = NULL;
+    sch_desc_for_each(desc, field){
+        if(!sch_is_indexed_field(field) || (int64_t) field->offset < offset ||
+           (int64_t)(field->offset + field->size) > offset + size){
+            continue;
+        }
+        if(tab_index_field(table, rowix, field, part, offset, insert) == TABLE_FAIL){
+            failed = field;
+            break;
+        }
+    }
+    if(failed == NULL){
+        return TABLE_SUCCESS;
+    }
+    /* Undo entries of columns before the failed one */
+    sch_desc_for_each(desc, field){
+        if(field == failed){
+            break;
+        }
+        if(!sch_is_indexed_field(field) || (int64_t) field->offset < offset ||
+           (int64_t)(field->offset + field->size) > offset + size){
+            continue;
+        }
+        if(tab_index_field(table, rowix, field, part, offset, !insert) == TABLE_FAIL){
+            logger(LL_ERROR, __func__, "Failed to restore index of %s", field->name);
+        }
+    }
+    return TABLE_FAIL;
+}
+
 /**
  * @brief       Insert a row
  * @param[in]   table: pointer to table
@@ -66,11 +299,20 @@ chblix_t tab_insert(table_t* table, schema_t* schema, void* src){
         return CHBLIX_FAIL;
     }
 
+    /* Row is indexed before it is written, so a failed insert leaves no row the indexes miss */
+    if(tab_index_part(table, &rowix, src, schema->slot_size, 0, true) == TABLE_FAIL){
+        logger(LL_ERROR, __func__, "Failed to index row");
+        lb_dealloc(table_index(table), &rowix);
+        return CHBLIX_FAIL;
+    }
+
     if(lb_write(&table->ppl_header, &rowix, src, schema->slot_size, 0) == LB_FAIL){
         logger(LL_ERROR, __func__, "Failed to write row");
+        tab_index_part(table, &rowix, src, schema->slot_size, 0, false);
+        lb_dealloc(table_index(table), &rowix);
         return CHBLIX_FAIL;
     }
-
+    jc_insert(table_index(table), &rowix, src);
     return rowix;
 
 }
@@ -96,7 +338,7 @@ int tab_select_row(int64_t tablix, chblix_t* rowix, void* dest){
         return TABLE_FAIL;
     }
 
-    if(lb_read(tablix, rowix, dest, schema->slot_size, 0) == LB_FAIL){
+    if(tab_read_nova(table, ppl_load_chunk(rowix->chunk_idx), rowix, dest, schema->slot_size, 0) == TABLE_FAIL){
         logger(LL_ERROR, __func__, "Failed to read row");
         return TABLE_FAIL;
     }
@@ -112,6 +354,15 @@ int tab_select_row(int64_t tablix, chblix_t* rowix, void* dest){
  */
 
 int tab_delete_nova(table_t* table, chunk_t* chunk, chblix_t* rowix){
+    /* Varchar keys are compared by strings, remove them before strings are freed */
+    if(tab_index_part(table, rowix, NULL, sch_load(table->schidx)->slot_size, 0, false) == TABLE_FAIL){
+        logger(LL_ERROR, __func__, "Failed to remove row from indexes");
+        return TABLE_FAIL;
+    }
+    if(tab_release_row(table, rowix, NULL) == TABLE_FAIL){
+        logger(LL_ERROR, __func__, "Failed to free varchars of row");
+        return TABLE_FAIL;
+    }
     /* Loading Linked Block */
     linked_block_t* lb = malloc(table->ppl_header.block_size); /* Don't forget to free it */
     if (lb_load_nova_pppp(&table->ppl_header,chunk, rowix, lb) == LB_FAIL) {
@@ -149,11 +400,19 @@ int tab_update_row(table_t* table, schema_t* schema, chblix_t* rowix, void* row)
     if(validate_table_and_schema(table, schema) == TABLE_FAIL) {
         return TABLE_FAIL;
     }
+    if(tab_index_part(table, rowix, NULL, schema->slot_size, 0, false) == TABLE_FAIL){
+        logger(LL_ERROR, __func__, "Failed to remove row from indexes");
+        return TABLE_FAIL;
+    }
+    if(tab_release_row(table, rowix, row) == TABLE_FAIL){
+        logger(LL_ERROR, __func__, "Failed to free varchars of row");
+        return TABLE_FAIL;
+    }
     if(lb_write(&table->ppl_header, rowix, row, schema->slot_size, 0) == LB_FAIL){
         logger(LL_ERROR, __func__, "Failed to write row");
         return TABLE_FAIL;
     }
-    return TABLE_SUCCESS;
+    return tab_index_part(table, rowix, row, schema->slot_size, 0, true);
 }
 
 /**
@@ -173,12 +432,20 @@ int tab_update_field(table_t* table, schema_t* schema, chblix_t* rowix, field_t*
     if(validate_table_and_schema(table, schema) == TABLE_FAIL) {
         return TABLE_FAIL;
     }
+    if(tab_index_part(table, rowix, NULL, (int64_t) field->size, (int64_t) field->offset, false) == TABLE_FAIL){
+        logger(LL_ERROR, __func__, "Failed to remove old value of %s from index", field->name);
+        return TABLE_FAIL;
+    }
+    if(tab_release_element(table, rowix, field, element) == TABLE_FAIL){
+        logger(LL_ERROR, __func__, "Failed to free old value of %s", field->name);
+        return TABLE_FAIL;
+    }
 
     if(lb_write(&table->ppl_header, rowix, element, (int64_t) field->size, (int64_t) field->offset) == LB_FAIL){
         logger(LL_ERROR, __func__, "Failed to write row");
         return TABLE_FAIL;
     }
-    return TABLE_SUCCESS;
+    return tab_index_part(table, rowix, element, (int64_t) field->size, (int64_t) field->offset, true);
 }
 
 /**
@@ -191,11 +458,19 @@ int tab_update_field(table_t* table, schema_t* schema, chblix_t* rowix, field_t*
  */
 
 int tab_update_element(table_t* table, chblix_t* rowix, field_t* field, void* element){
+    if(tab_index_part(table, rowix, NULL, (int64_t) field->size, (int64_t) field->offset, false) == TABLE_FAIL){
+        logger(LL_ERROR, __func__, "Failed to remove old value of %s from index", field->name);
+        return TABLE_FAIL;
+    }
+    if(tab_release_element(table, rowix, field, element) == TABLE_FAIL){
+        logger(LL_ERROR, __func__, "Failed to free old value of %s", field->name);
+        return TABLE_FAIL;
+    }
     if(lb_write(&table->ppl_header, rowix, element, (int64_t) field->size, (int64_t) field->offset) == LB_FAIL){
         logger(LL_ERROR, __func__, "Failed to write row");
         return TABLE_FAIL;
     }
-    return TABLE_SUCCESS;
+    return tab_index_part(table, rowix, element, (int64_t) field->size, (int64_t) field->offset, true);
 }
 
 
@@ -221,7 +496,8 @@ int tab_get_element(int64_t tablix, chblix_t* rowix, field_t* field, void* eleme
         return TABLE_FAIL;
     }
 
-    if(lb_read(tablix, rowix, element, (int64_t)field->size, (int64_t)field->offset) == LB_FAIL){
+    if(tab_read_nova(table, ppl_load_chunk(rowix->chunk_idx), rowix, element,
+                     (int64_t)field->size, (int64_t)field->offset) == TABLE_FAIL){
         logger(LL_ERROR, __func__, "Failed to read row");
         return TABLE_FAIL;
     }
@@ -232,3 +508,224 @@ int tab_get_element(int64_t tablix, chblix_t* rowix, field_t* field, void* eleme
 
 
 
+
+/**
+ * @brief       Free all varchars owned by the table in one pass
+ * @param[in]   table: pointer to table
+ * @param[in]   schema: pointer to schema
+ * @return      TABLE_SUCCESS on success, TABLE_FAIL on failure
+ * @note        called before the table is dropped, rows keep freed tickets
+ */
+
+int tab_release_varchars(table_t* table, schema_t* schema){
+    if(validate_table_and_schema(table, schema) == TABLE_FAIL) {
+        return TABLE_FAIL;
+    }
+    if(table->vchmgr_idx == TAB_SHARED_VARCHARS){
+        return TABLE_SUCCESS;
+    }
+    int64_t tablix = table_index(table);
+    int64_t vchmgr_idx = table->vchmgr_idx;
+    int64_t count = 0;
+    sch_for_each(schema, sch_chunk, field, sch_chblix, table->schidx){
+        count++;
+    }
+    field_t* owned = malloc(count * sizeof(field_t));
+    int64_t owned_count = 0;
+    sch_for_each(schema, sch_chunk2, field2, sch_chblix2, table->schidx){
+        if(field2.type != DT_VARCHAR){
+            continue;
+        }
+        if(sch_is_dict_field(&field2)){
+            /* Dictionary keeps the strings of the column */
+            if(dict_destroy(vchmgr_idx, field2.dict) == PA_FAIL){
+                logger(LL_ERROR, __func__, "Failed to destroy dictionary of %s", field2.name);
+                free(owned);
+                return TABLE_FAIL;
+            }
+            continue;
+        }
+        owned[owned_count++] = field2;
+    }
+
+    if(owned_count > 0){
+        void* row = malloc(schema->slot_size);
+        tab_for_each_row(table, chunk, chblix, row, schema){
+            for(int64_t i = 0; i < owned_count; i++){
+                if(vch_delete(vchmgr_idx, (vch_ticket_t*)((char*) row + owned[i].offset)) == LB_FAIL){
+                    logger(LL_ERROR, __func__, "Failed to free varchar of %s", owned[i].name);
+                    free(row);
+                    free(owned);
+                    return TABLE_FAIL;
+                }
+            }
+        }
+        free(row);
+    }
+    free(owned);
+    table = tab_load(tablix);
+    table->vchmgr_idx = TAB_SHARED_VARCHARS;
+    return TABLE_SUCCESS;
+}
+
+/**
+ * @brief       Add a column to a table without touching its rows
+ * @param[in]   table: pointer to table
+ * @param[in]   name: name of the column
+ * @param[in]   type: type of the column
+ * @param[in]   size: size of the column in row
+ * @return      TABLE_SUCCESS on success, TABLE_FAIL on failure
+ * @note        column goes to the end of row, old rows get it when rewritten
+ */
+
+int tab_add_column(table_t* table, const char* name, datatype_t type, int64_t size){
+    if(table == NULL){
+        logger(LL_ERROR, __func__, "Invalid argument: table is NULL");
+        return TABLE_FAIL;
+    }
+    sch_desc_t* desc = sch_desc_load(table->schidx);
+    if(desc == NULL){
+        return TABLE_FAIL;
+    }
+    if(sch_desc_field(desc, name) != NULL){
+        logger(LL_ERROR, __func__, "Column %s already exists in table %s", name, table->name);
+        return TABLE_FAIL;
+    }
+    if(sch_add_field(sch_load(table->schidx), name, type, size) == SCHEMA_FAIL){
+        logger(LL_ERROR, __func__, "Failed to add column %s", name);
+        return TABLE_FAIL;
+    }
+    return TABLE_SUCCESS;
+}
+
+/**
+ * @brief       Drop a column of a table
+ * @param[in]   table: pointer to table
+ * @param[in]   name: name of the column
+ * @return      TABLE_SUCCESS on success, TABLE_FAIL on failure
+ * @note        rows keep bytes of the column, only strings owned by the table
+ *              are freed, which takes a pass over rows for plain varchars
+ */
+
+int tab_drop_column(table_t* table, const char* name){
+    if(table == NULL){
+        logger(LL_ERROR, __func__, "Invalid argument: table is NULL");
+        return TABLE_FAIL;
+    }
+    field_t field;
+    if(sch_get_field(sch_load(table->schidx), name, &field) != SCHEMA_SUCCESS){
+        logger(LL_ERROR, __func__, "Failed to find column %s in table %s", name, table->name);
+        return TABLE_FAIL;
+    }
+    if(sch_is_indexed_field(&field) && idx_destroy(field.index_kind, field.index) == IDX_FAIL){
+        logger(LL_ERROR, __func__, "Failed to destroy index of %s", name);
+        return TABLE_FAIL;
+    }
+    if(table->vchmgr_idx != TAB_SHARED_VARCHARS && field.type == DT_VARCHAR && sch_is_dict_field(&field) &&
+       dict_destroy(table->vchmgr_idx, field.dict) == PA_FAIL){
+        logger(LL_ERROR, __func__, "Failed to destroy dictionary of %s", name);
+        return TABLE_FAIL;
+    }
+    if(tab_owns_element(table, &field)){
+        vch_ticket_t* ticket = malloc(field.size);
+        tab_for_each_element(table, chunk, chblix, ticket, &field){
+            if(vch_delete(table->vchmgr_idx, ticket) == LB_FAIL){
+                logger(LL_ERROR, __func__, "Failed to free varchar of %s", name);
+                free(ticket);
+                return TABLE_FAIL;
+            }
+        }
+        free(ticket);
+    }
+    if(sch_delete_field(sch_load(table->schidx), name) == SCHEMA_FAIL){
+        logger(LL_ERROR, __func__, "Failed to delete column %s", name);
+        return TABLE_FAIL;
+    }
+    return TABLE_SUCCESS;
+}
+
+/**
+ * @brief       Create index of a column and fill it with rows of the table
+ * @param[in]   table: pointer to table owning its rows
+ * @param[in]   name: name of the column
+ * @param[in]   kind: kind of the index
+ * @return      TABLE_SUCCESS on success, TABLE_FAIL on failure
+ * @note        index pages are allocated in the space of the table
+ */
+
+int tab_create_index(table_t* table, const char* name, index_kind_t kind){
+    if(table == NULL){
+        logger(LL_ERROR, __func__, "Invalid argument: table is NULL");
+        return TABLE_FAIL;
+    }
+    if(table->vchmgr_idx == TAB_SHARED_VARCHARS){
+        logger(LL_ERROR, __func__, "Table %s does not own its rows and can not be indexed", table->name);
+        return TABLE_FAIL;
+    }
+    field_t field;
+    if(sch_get_field(sch_load(table->schidx), name, &field) != SCHEMA_SUCCESS){
+        logger(LL_ERROR, __func__, "Failed to find column %s in table %s", name, table->name);
+        return TABLE_FAIL;
+    }
+    if(sch_is_indexed_field(&field)){
+        logger(LL_ERROR, __func__, "Column %s of table %s is already indexed", name, table->name);
+        return TABLE_FAIL;
+    }
+    int64_t tablix = table_index(table);
+    int space = pg_use_space(pg_space_of(tablix));
+    int64_t idx = idx_init(kind, field.type, tab_index_key_size(&field), table->vchmgr_idx);
+    pg_use_space(space);
+    if(idx == IDX_FAIL){
+        logger(LL_ERROR, __func__, "Failed to create index of %s", name);
+        return TABLE_FAIL;
+    }
+
+    void* key = malloc(tab_index_key_size(&field) + field.size);
+    if(key == NULL){
+        logger(LL_ERROR, __func__, "Failed to allocate key of %s", name);
+        idx_destroy(kind, idx);
+        return TABLE_FAIL;
+    }
+    void* element = (char*) key + tab_index_key_size(&field);
+    tab_for_each_element(table, chunk, chblix, element, &field){
+        if(tab_index_key(&field, element, key) == TABLE_FAIL || idx_insert(kind, idx, key, &chblix) == IDX_FAIL){
+            logger(LL_ERROR, __func__, "Failed to index row of %s", name);
+            free(key);
+            idx_destroy(kind, idx);
+            return TABLE_FAIL;
+        }
+    }
+    free(key);
+    table = tab_load(tablix);
+    if(sch_set_field_index(sch_load(table->schidx), name, idx, kind) == SCHEMA_FAIL){
+        idx_destroy(kind, idx);
+        return TABLE_FAIL;
+    }
+    return TABLE_SUCCESS;
+}
+
+/**
+ * @brief       Destroy indexes of all columns of a table
+ * @param[in]   table: pointer to table
+ * @return      TABLE_SUCCESS on success, TABLE_FAIL on failure
+ * @note        called before the table is dropped, fields keep destroyed indexes
+ */
+
+int tab_destroy_indexes(table_t* table){
+    if(table == NULL){
+        logger(LL_ERROR, __func__, "Invalid argument: table is NULL");
+        return TABLE_FAIL;
+    }
+    jc_invalidate(table_index(table), 0, INT64_MAX);
+    sch_desc_t* desc = sch_desc_load(table->schidx);
+    if(desc == NULL){
+        return TABLE_FAIL;
+    }
+    sch_desc_for_each(desc, field){
+        if(sch_is_indexed_field(field) && idx_destroy(field->index_kind, field->index) == IDX_FAIL){
+            logger(LL_ERROR, __func__, "Failed to destroy index of %s", field->name);
+            return TABLE_FAIL;
+        }
+    }
+    return TABLE_SUCCESS;
+}
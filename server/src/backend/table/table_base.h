@@ -3,10 +3,37 @@
 #include "core/page_pool/page_pool.h"
 #include "schema.h"
 
+/**
+ * Table owns varchars of its rows when vchmgr_idx is set: they are freed
+ * when rows are deleted or overwritten and when the table is dropped.
+ * Result tables copy tickets of source rows and share them without owning.
+ */
+
+#define TAB_SHARED_VARCHARS (-1)
+
+/**
+ * Columns are added to the end of row and dropped columns keep their bytes,
+ * so layout of a row only grows. Every row remembers how many bytes were
+ * written to it, which is the version of schema it was written with: rows
+ * written before tab_add_column are shorter and read the new columns as zero
+ * or empty string. A row takes the new layout when it is rewritten.
+ */
+
+/**
+ * Indexed columns keep a B+tree or a hash index of their elements, see
+ * index.h. Insert, update and delete of rows maintain the indexes: entries of
+ * rewritten columns are removed before old strings are freed and added after
+ * the row is written. Dictionary encoded column is keyed by ticket of its
+ * string, so it is ordered and hashed by strings, not by codes.
+ */
+
+#define tab_index_key_size(field) (sch_is_dict_field(field) ? (int64_t) sizeof(vch_ticket_t) : (int64_t) (field)->size)
+
 typedef struct table {
     page_pool_t ppl_header;
     int64_t schidx; //schema index
     char name[MAX_NAME_LENGTH];
+    int64_t vchmgr_idx; //varchar manager owning strings of rows or TAB_SHARED_VARCHARS
 } table_t;
 
 typedef enum {TABLE_SUCCESS = 0, TABLE_FAIL = -1} table_status_t;
@@ -40,10 +67,9 @@ typedef enum {TABLE_SUCCESS = 0, TABLE_FAIL = -1} table_status_t;
 #define tab_for_each_element(table, chunk, chblix, element, field) \
 chunk_t* chunk = ppl_load_chunk(table->ppl_header.head);                     \
 chblix_t chblix = lb_pool_start(&table->ppl_header, &chunk);\
-lb_read_nova(&table->ppl_header,chunk, &chblix, element, (int64_t)(field)->size, (int64_t)(field)->offset);\
 for (;\
 chblix_cmp(&chblix, &CHBLIX_FAIL) != 0 &&\
-lb_read_nova(&table->ppl_header, chunk, &chblix, element, (int64_t)(field)->size, (int64_t)(field)->offset) != LB_FAIL;\
+tab_read_nova(table, chunk, &chblix, element, (int64_t)(field)->size, (int64_t)(field)->offset) != TABLE_FAIL;\
 ++chblix.block_idx, chblix = lb_nearest_valid_chblix(&table->ppl_header, chblix, &chunk))
 
 /**
@@ -58,10 +84,9 @@ lb_read_nova(&table->ppl_header, chunk, &chblix, element, (int64_t)(field)->size
 #define tab_for_each_row(table, chunk, chblix, row, schema) \
 chunk_t* chunk = ppl_load_chunk(table->ppl_header.head);   \
 chblix_t chblix = lb_pool_start(&table->ppl_header, &chunk);\
-lb_read_nova(&table->ppl_header, chunk, &chblix, row, schema->slot_size, 0);\
 for (;                                         \
 chblix_cmp(&chblix, &CHBLIX_FAIL) != 0 &&\
-lb_read_nova(&table->ppl_header,chunk,  &chblix, row, schema->slot_size, 0) != LB_FAIL; \
+tab_read_nova(table, chunk, &chblix, row, schema->slot_size, 0) != TABLE_FAIL; \
 ++chblix.block_idx, chblix = lb_nearest_valid_chblix(&table->ppl_header,\
                                                                       chblix, &chunk))
 
@@ -72,6 +97,7 @@ lb_read_nova(&table->ppl_header,chunk,  &chblix, row, schema->slot_size, 0) != L
 row_t row
 
 table_t* tab_base_init(const char* name, schema_t* schema);
+int tab_read_nova(table_t* table, chunk_t* chunk, chblix_t* rowix, void* dest, int64_t size, int64_t offset);
 chblix_t tab_insert(table_t* table, schema_t* schema, void* src);
 int tab_select_row(int64_t tablix, chblix_t* rowix, void* dest);
 int tab_delete_nova(table_t* table, chunk_t* chunk, chblix_t* rowix);
@@ -81,3 +107,8 @@ int tab_update_field(table_t* table, schema_t* schema, chblix_t* rowix, field_t*
 int tab_delete_row(table_t* table, chblix_t* rowix);
 int tab_update_element(table_t* table, chblix_t* rowix, field_t* field, void* element);
 int tab_get_element(int64_t tablix, chblix_t* rowix, field_t* field, void* element);
+int tab_release_varchars(table_t* table, schema_t* schema);
+int tab_add_column(table_t* table, const char* name, datatype_t type, int64_t size);
+int tab_drop_column(table_t* table, const char* name);
+int tab_create_index(table_t* table, const char* name, index_kind_t kind);
+int tab_destroy_indexes(table_t* table);
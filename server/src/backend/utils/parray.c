@@ -1,16 +1,101 @@
 #include "parray.h"
+#include "core/io/pager.h"
 #include "utils/logger.h"
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/types.h>
+
+#define PA_TOP_ENTRIES ((int64_t)(PAGE_SIZE - PA_HEADER_SIZE) / (int64_t)sizeof(int64_t))
+#define PA_DIR_PAGE_ENTRIES ((int64_t)PAGE_SIZE / (int64_t)sizeof(int64_t))
+#define PA_NO_PAGE (-1)
+
+#define pa_top_dir(pa) ((int64_t*)((char*)(pa) + PA_HEADER_SIZE))
+#define pa_page_bytes(pa) ((pa)->blocks_per_page * (pa)->block_size)
+
+_Static_assert(sizeof(parray_t) <= PA_HEADER_SIZE, "PArray header does not fit PA_HEADER_SIZE");
+
+/**
+ * @brief       Allocates page and fills it with PA_NO_PAGE entries
+ * @param[in]   near: page of the parray, new page goes to its space
+ * @return      page index or PA_FAIL
+ */
+
+static int64_t pa_alloc_dir_page(int64_t near){
+    int64_t page_index = pg_alloc_near(near);
+    if(page_index == PAGER_FAIL){
+        logger(LL_ERROR, __func__, "Unable to allocate directory page");
+        return PA_FAIL;
+    }
+    void* page = pg_load_page(page_index);
+    if(!page){
+        logger(LL_ERROR, __func__, "Unable to load directory page %ld", page_index);
+        return PA_FAIL;
+    }
+    memset(page, 0xFF, PAGE_SIZE);
+    return page_index;
+}
+
+/**
+ * @brief       Finds data page that stores page_no-th portion of blocks
+ * @param[in]   pa: pointer to parray
+ * @param[in]   page_no: logical number of data page
+ * @param[in]   alloc: allocate missing directory and data pages
+ * @return      pointer to data page or NULL if page is absent
+ * @warning     allocation goes through pager, which may pop from the parray
+ *              of deleted pages, so callers must re-read pa->size afterwards
+ */
+
+static char* pa_data_page(parray_t* pa, int64_t page_no, bool alloc){
+    int64_t dir_no = page_no / PA_DIR_PAGE_ENTRIES;
+    int64_t slot = page_no % PA_DIR_PAGE_ENTRIES;
+    if(dir_no >= PA_TOP_ENTRIES){
+        logger(LL_ERROR, __func__, "PArray %ld overflow, data page %ld", pa->page_idx, page_no);
+        return NULL;
+    }
+
+    int64_t* top = pa_top_dir(pa);
+    if(top[dir_no] == PA_NO_PAGE){
+        if(!alloc){
+            return NULL;
+        }
+        int64_t dir_idx = pa_alloc_dir_page(pa->page_idx);
+        if(dir_idx == PA_FAIL){
+            return NULL;
+        }
+        top[dir_no] = dir_idx;
+    }
+
+    int64_t* dir = (int64_t*) pg_load_page(top[dir_no]);
+    if(!dir){
+        logger(LL_ERROR, __func__, "Unable to load directory page %ld", top[dir_no]);
+        return NULL;
+    }
+    if(dir[slot] == PA_NO_PAGE){
+        if(!alloc){
+            return NULL;
+        }
+        int64_t data_idx = pg_alloc_near(pa->page_idx);
+        if(data_idx == PAGER_FAIL){
+            logger(LL_ERROR, __func__, "Unable to allocate data page");
+            return NULL;
+        }
+        dir[slot] = data_idx;
+    }
+    return (char*) pg_load_page(dir[slot]);
+}
+
 /**
  * @brief       Initializes PArray
  * @param[in]   block_size: size of block
- * @param[in]   inval: invalid value used when deleting blocks
  * @return      page_index or PA_FAIL
  */
 
 int64_t pa_init(int64_t block_size){
+    if(block_size <= 0 || block_size > PAGE_SIZE){
+        logger(LL_ERROR, __func__, "Invalid block size %ld", block_size);
+        return PA_FAIL;
+    }
     int64_t page_index = lp_init_m(sizeof(parray_t));
     if(page_index == LP_FAIL){
         logger(LL_ERROR, __func__, "Unable to allocate page");
@@ -23,7 +108,9 @@ int64_t pa_init(int64_t block_size){
     }
     pa->page_idx = page_index;
     pa->block_size = block_size;
+    pa->blocks_per_page = PAGE_SIZE / block_size;
     pa->size = 0;
+    memset(pa_top_dir(pa), 0xFF, PA_TOP_ENTRIES * sizeof(int64_t));
     return page_index;
 }
 
@@ -50,6 +137,37 @@ parray_t* pa_load(int64_t page_index){
 
 int pa_destroy(int64_t page_index) {
     logger(LL_DEBUG, __func__, "Destroying PArray");
+    parray_t *pa = (parray_t *) lp_load(page_index);
+    if (!pa) {
+        logger(LL_ERROR, __func__, "Unable to load page");
+        return PA_FAIL;
+    }
+    int64_t* entries = malloc(PA_DIR_PAGE_ENTRIES * sizeof(int64_t));
+    if (!entries) {
+        logger(LL_ERROR, __func__, "Unable to allocate memory");
+        return PA_FAIL;
+    }
+    int64_t* top = pa_top_dir(pa);
+    for (int64_t dir_no = 0; dir_no < PA_TOP_ENTRIES; dir_no++) {
+        int64_t dir_idx = top[dir_no];
+        if (dir_idx == PA_NO_PAGE) {
+            continue;
+        }
+        /* Copy entries, deallocation pushes into pager and may touch pages */
+        if (pg_copy_read(dir_idx, entries, PA_DIR_PAGE_ENTRIES * sizeof(int64_t), 0) == PAGER_FAIL) {
+            logger(LL_ERROR, __func__, "Unable to read directory page %ld", dir_idx);
+            free(entries);
+            return PA_FAIL;
+        }
+        for (int64_t slot = 0; slot < PA_DIR_PAGE_ENTRIES; slot++) {
+            if (entries[slot] != PA_NO_PAGE) {
+                pg_dealloc(entries[slot]);
+            }
+        }
+        top[dir_no] = PA_NO_PAGE;
+        pg_dealloc(dir_idx);
+    }
+    free(entries);
     if (lp_delete(page_index) == LP_FAIL) {
         logger(LL_ERROR, __func__, "Unable to deallocate page");
         return PA_FAIL;
@@ -73,15 +191,16 @@ int pa_write(parray_t *pa, int64_t block_idx, void *src, int64_t size, int64_t s
         logger(LL_ERROR, __func__, "Unable to load page");
         return PA_FAIL;
     }
-    if(pa->block_size < src_offset + size){
+    if(pa->block_size < src_offset + size || block_idx < 0){
         logger(LL_ERROR, __func__, "Unable to write to PArray");
         return PA_FAIL;
     }
-    off_t offset = (off_t)(block_idx * pa->block_size + src_offset);
-    if(lp_write(pa->page_idx, src, size, offset) == LP_FAIL){
+    char* page = pa_data_page(pa, block_idx / pa->blocks_per_page, true);
+    if(!page){
         logger(LL_ERROR, __func__, "Unable to write to PArray");
         return PA_FAIL;
     }
+    memcpy(page + (block_idx % pa->blocks_per_page) * pa->block_size + src_offset, src, size);
     pa->size = (block_idx + 1) > pa->size ? block_idx + 1 : pa->size;
     return PA_SUCCESS;
 }
@@ -109,17 +228,19 @@ int pa_read(parray_t *parray, int64_t block_idx, void *dest, int64_t size, int64
         return PA_EMPTY;
     }
 
-    if (parray->block_size < src_offset + size) {
+    if (parray->block_size < src_offset + size || block_idx < 0) {
         logger(LL_ERROR, __func__,
                "Unable to read from parray src_size = %ld, src_offset = %ld, block_size = %ld",
                size, src_offset, parray->block_size);
         return PA_FAIL;
     }
-    off_t offset = (off_t)(block_idx * parray->block_size + src_offset);
-    if (lp_read_copy(parray->page_idx, dest, size, offset) == LP_FAIL) {
-        logger(LL_ERROR, __func__, "Unable to read from PArray");
-        return PA_FAIL;
+    char* page = pa_data_page(parray, block_idx / parray->blocks_per_page, false);
+    if (!page) {
+        /* Never written blocks are read as zeros */
+        memset(dest, 0, size);
+        return PA_SUCCESS;
     }
+    memcpy(dest, page + (block_idx % parray->blocks_per_page) * parray->block_size + src_offset, size);
     return PA_SUCCESS;
 }
 
@@ -140,10 +261,21 @@ int pa_read_blocks(int64_t paidx, int64_t stblidx, void *dest, int64_t size, int
         logger(LL_ERROR, __func__, "Unable to load page");
         return PA_FAIL;
     }
-    off_t offset = (off_t)(stblidx * pa->block_size + src_offset);
-    if (lp_read_copy(pa->page_idx, dest, size, offset) == LP_FAIL) {
-        logger(LL_ERROR, __func__, "Unable to read from PArray");
-        return PA_FAIL;
+    int64_t page_bytes = pa_page_bytes(pa);
+    int64_t offset = stblidx * pa->block_size + src_offset;
+    char* out = (char*) dest;
+    while (size > 0) {
+        int64_t in_page = offset % page_bytes;
+        int64_t chunk = page_bytes - in_page < size ? page_bytes - in_page : size;
+        char* page = pa_data_page(pa, offset / page_bytes, false);
+        if (page) {
+            memcpy(out, page + in_page, chunk);
+        } else {
+            memset(out, 0, chunk);
+        }
+        out += chunk;
+        offset += chunk;
+        size -= chunk;
     }
     return PA_SUCCESS;
 }
@@ -163,6 +295,11 @@ int pa_append(int64_t paidx, void *src, int64_t size) {
         logger(LL_ERROR, __func__, "Unable to load page");
         return PA_FAIL;
     }
+    /* Make sure the tail page exists before taking the size */
+    if (!pa_data_page(pa, pa->size / pa->blocks_per_page, true)) {
+        logger(LL_ERROR, __func__, "Unable to allocate page for parray %ld", paidx);
+        return PA_FAIL;
+    }
     if(pa_write(pa, pa->size, src, size, 0) == PA_FAIL){
         logger(LL_ERROR, __func__, "Unable to append to parray %ld, pa.size = %ld", paidx
                , pa->size);
@@ -173,6 +310,39 @@ int pa_append(int64_t paidx, void *src, int64_t size) {
     return PA_SUCCESS;
 }
 
+/**
+ * @brief       Append several blocks to PArray, copying page-sized runs
+ * @param[in]   paidx: page index of PArray
+ * @param[in]   src: source of count * block_size bytes
+ * @param[in]   count: number of blocks to append
+ * @return      PA_SUCCESS on success, PA_FAIL otherwise
+ */
+
+int pa_append_blocks(int64_t paidx, void *src, int64_t count) {
+    parray_t *pa = (parray_t *) lp_load(paidx);
+
+    if (!pa) {
+        logger(LL_ERROR, __func__, "Unable to load page");
+        return PA_FAIL;
+    }
+    char* in = (char*) src;
+    while (count > 0) {
+        char* page = pa_data_page(pa, pa->size / pa->blocks_per_page, true);
+        if (!page) {
+            logger(LL_ERROR, __func__, "Unable to append to parray %ld, pa.size = %ld", paidx,
+                   pa->size);
+            return PA_FAIL;
+        }
+        int64_t in_page = pa->size % pa->blocks_per_page;
+        int64_t run = pa->blocks_per_page - in_page < count ? pa->blocks_per_page - in_page : count;
+        memcpy(page + in_page * pa->block_size, in, run * pa->block_size);
+        pa->size += run;
+        in += run * pa->block_size;
+        count -= run;
+    }
+    return PA_SUCCESS;
+}
+
 /**
  * @brief       Pop data from PArray
  * @param[in]   pa_index: page index of PArray
@@ -239,11 +409,9 @@ int pa_at(int64_t page_index, int64_t block_idx, void *dest){
         logger(LL_ERROR, __func__, "Unable to read from PArray");
         return PA_FAIL;
     }
-    off_t offset = (off_t)(block_idx * pa->block_size);
-    if (lp_read_copy(pa->page_idx, dest, pa->block_size, offset) == LP_FAIL) {
+    if (pa_read(pa, block_idx, dest, pa->block_size, 0) != PA_SUCCESS) {
         logger(LL_ERROR, __func__, "Unable to read from PArray");
         return PA_FAIL;
     }
     return PA_SUCCESS;
 }
-
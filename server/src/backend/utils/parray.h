@@ -3,12 +3,23 @@
 #include "core/io/linked_pages.h"
 #include <stdint.h>
 
+/**
+ * PArray is a two-level persistent vector. The header page keeps a top
+ * directory of directory pages starting at PA_HEADER_SIZE, every directory
+ * page maps a page worth of data pages, so any block is reached in two
+ * page lookups instead of walking a chain of linked pages.
+ */
+
+#ifndef PA_HEADER_SIZE
+#define PA_HEADER_SIZE 256
+#endif
 
 typedef struct parray{
     linked_page_t lp;
     int64_t page_idx;
     int64_t size;
     int64_t block_size;
+    int64_t blocks_per_page;
 } parray_t;
 
 enum {PA_SUCCESS = 0, PA_FAIL = -1, PA_EMPTY = -2};
@@ -20,6 +31,7 @@ int pa_write(parray_t *pa, int64_t block_idx, void *src, int64_t size, int64_t s
 int pa_read(parray_t* parray, int64_t block_idx, void *dest, int64_t size, int64_t src_offset);
 int pa_read_blocks(int64_t paidx, int64_t stblidx, void *dest, int64_t size, int64_t src_offset);
 int pa_append(int64_t paidx, void *src, int64_t size);
+int pa_append_blocks(int64_t paidx, void *src, int64_t count);
 int pa_pop(int64_t pa_index, void *dest, int64_t size);
 int64_t pa_size(int64_t page_index);
 int64_t pa_block_size(int64_t page_index);
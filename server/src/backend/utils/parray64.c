@@ -1,5 +1,6 @@
 #include "parray64.h"
 #include "utils/logger.h"
+#include "utils/simd.h"
 #include <stdbool.h>
 #include <stdio.h>
 
@@ -110,81 +111,65 @@ int pa_pop64(int64_t paidx, int64_t* dest){
 }
 
 /**
- * @brief           Returns block index of first occurence of value in PArray
+ * @brief           Scan parray64 chunk by chunk with simd kernel
  * @param[in]       paidx: page index of parray64
  * @param[in]       value: value to find
- * @return          block index of first occurence of value in PArray or PA_FAIL
+ * @param[out]      found: block index of first occurence or SIMD_NOT_FOUND
+ * @return          PA_SUCCESS or PA_FAIL
  */
 
-int64_t pa_find_first_int64(int64_t paidx, int64_t value){
+static int pa_scan64(int64_t paidx, int64_t value, int64_t* found){
+    *found = SIMD_NOT_FOUND;
     int64_t size = pa_size(paidx);
-
-    /* If PArray is empty */
-    if(size == 0){
-        return PA_FAIL;
-    }
-
     if(size == PA_FAIL){
         logger(LL_ERROR, __func__, "Unable to get size of PArray");
         return PA_FAIL;
     }
 
-    /* Load PArray */
-    parray64_t *pa = (parray64_t *) lp_load(paidx);
-
-    /* Reading all blocks */
-    int64_t blocks[(size_t) size];
-    if(pa_read_blocks(paidx, 0, &blocks, size * pa->parray.block_size, 0) == PA_FAIL){
-        logger(LL_ERROR, __func__, "Unable to read PArray");
-        return PA_FAIL;
-    }
-
-    for(int64_t i = 0; i < size; i++){
-        int64_t val = blocks[i];
-        if(val == value){
-            return i;
+    int64_t blocks[PA_SCAN_CHUNK];
+    for(int64_t start = 0; start < size; start += PA_SCAN_CHUNK){
+        int64_t count = size - start < PA_SCAN_CHUNK ? size - start : PA_SCAN_CHUNK;
+        if(pa_read_blocks(paidx, start, blocks, count * (int64_t)sizeof(int64_t), 0) == PA_FAIL){
+            logger(LL_ERROR, __func__, "Unable to read PArray");
+            return PA_FAIL;
+        }
+        int64_t idx = simd_find_first_i64(blocks, count, value);
+        if(idx != SIMD_NOT_FOUND){
+            *found = start + idx;
+            return PA_SUCCESS;
         }
     }
-    return PA_FAIL;
+    return PA_SUCCESS;
 }
 
 /**
- * @brief           Check if value exists in parray64
+ * @brief           Returns block index of first occurence of value in PArray
  * @param[in]       paidx: page index of parray64
  * @param[in]       value: value to find
- * @return          true if value exists, false if not, PA_FAIL on error
+ * @return          block index of first occurence of value in PArray or PA_FAIL
  */
 
-int pa_exists64(int64_t paidx, int64_t value){
-    int64_t size = pa_size(paidx);
-
-    /* If PArray is empty */
-    if(size == 0){
-        return false;
-    }
-
-    if(size == PA_FAIL){
-        logger(LL_ERROR, __func__, "Unable to get size of PArray");
+int64_t pa_find_first_int64(int64_t paidx, int64_t value){
+    int64_t found;
+    if(pa_scan64(paidx, value, &found) == PA_FAIL || found == SIMD_NOT_FOUND){
         return PA_FAIL;
     }
+    return found;
+}
 
-    /* Load PArray */
-    parray64_t *pa = (parray64_t *) lp_load(paidx);
+/**
+ * @brief           Check if value exists in parray64
+ * @param[in]       paidx: page index of parray64
+ * @param[in]       value: value to find
+ * @return          true if value exists, false if not, PA_FAIL on error
+ */
 
-    /* Reading all blocks */
-    int64_t blocks[(size_t) size];
-    if(pa_read_blocks(paidx, 0, &blocks, size * pa->parray.block_size, 0) == PA_FAIL){
-        logger(LL_ERROR, __func__, "Unable to read PArray");
+int pa_exists64(int64_t paidx, int64_t value){
+    int64_t found;
+    if(pa_scan64(paidx, value, &found) == PA_FAIL){
         return PA_FAIL;
     }
-
-    for(int64_t i = 0; i < size; i++){
-        int64_t val = blocks[i];
-        if(val == value){
-            return true;
-        }
-    }
-    return false;
+    return found != SIMD_NOT_FOUND;
 }
 
 /**
@@ -1,6 +1,10 @@
 #pragma once
 #include "parray.h"
 
+#ifndef PA_SCAN_CHUNK
+#define PA_SCAN_CHUNK 512
+#endif
+
 typedef struct parray64{
     parray_t parray;
     int64_t inval;
@@ -6,15 +6,13 @@
 
 
 /**
- * Initializes linked_page_t
- * @breif Initializes linked_page_t
+ * Fills header of allocated linked_page_t
+ * @param page_index allocated page or PAGER_FAIL
  * @param mem_start starting offset for not header data
  * @return page_index or LP_FAIL
  */
 
-int64_t lp_init_m(int64_t mem_start){
-    logger(LL_DEBUG, __func__, "linked_page_t init.");
-    int64_t page_index = pg_alloc();
+static int64_t lp_setup(int64_t page_index, int64_t mem_start){
     if(page_index == PAGER_FAIL){
         logger(LL_ERROR, __func__, "Unable to allocate page");
         return LP_FAIL;
@@ -31,6 +29,31 @@ int64_t lp_init_m(int64_t mem_start){
     return page_index;
 }
 
+/**
+ * Initializes linked_page_t
+ * @breif Initializes linked_page_t in current space of pager
+ * @param mem_start starting offset for not header data
+ * @return page_index or LP_FAIL
+ */
+
+int64_t lp_init_m(int64_t mem_start){
+    logger(LL_DEBUG, __func__, "linked_page_t init.");
+    return lp_setup(pg_alloc(), mem_start);
+}
+
+/**
+ * Initializes linked_page_t
+ * @breif Initializes linked_page_t in the space of another page
+ * @param near page of the structure the new page belongs to
+ * @param mem_start starting offset for not header data
+ * @return page_index or LP_FAIL
+ */
+
+int64_t lp_init_near(int64_t near, int64_t mem_start){
+    logger(LL_DEBUG, __func__, "linked_page_t init near %ld.", near);
+    return lp_setup(pg_alloc_near(near), mem_start);
+}
+
 /**
  *  Initializes linked_page_t
  *  @breif Initializes linked_page_t
@@ -2,6 +2,7 @@
 #include "backend/utils/parray64.h"
 #include "caching.h"
 #include "utils/logger.h"
+#include <stdio.h>
 
 #ifndef PAGER
 pager_t* pg_pager;
@@ -12,17 +13,57 @@ pager_t* pg_pager;
 #define DELETED_PAGES_START_INDEX 0
 #endif
 
+#ifndef PG_TEMP_SUFFIX
+#define PG_TEMP_SUFFIX ".tmp"
+#endif
+
+static pager_t* pg_temp_pager = NULL;
+static int pg_space = PG_MAIN;
+
+#define pg_pager_of(page_index) (pg_is_temp(page_index) ? pg_temp_pager : PAGER)
+#define pg_local(page_index) (pg_is_temp(page_index) ? (page_index) & ~PG_TEMP_BIT : (page_index))
+#define pg_global(space, page_index) ((space) == PG_TEMP ? (page_index) | PG_TEMP_BIT : (page_index))
+
 /**
  * @brief       Creates pager
+ * @param[in]   pager: pointer to pager
  * @return      PAGER_SUCCESS on success, PAGER_FAIL otherwise
  */
-static int pg_create(void){
+static int pg_create(pager_t* pager){
     logger(LL_DEBUG, __func__, "Creating pager");
-    PAGER->deleted_pages = -1;
-    PAGER->deleted_pages = pa_init64(sizeof(int64_t), -1);
+    pager->deleted_pages = -1;
+    pager->deleted_pages = pa_init64(sizeof(int64_t), -1);
     return PAGER_SUCCESS;
 }
 
+/**
+ * @brief       Opens temp space, truncating scratch file left from previous run
+ * @return      PAGER_SUCCESS on success, PAGER_FAIL otherwise
+ */
+
+static int pg_temp_open(void){
+    if(pg_temp_pager){
+        return PAGER_SUCCESS;
+    }
+    const char* file_name = PAGER->ch.file.filename;
+    char temp_name[strlen(file_name) + sizeof(PG_TEMP_SUFFIX)];
+    snprintf(temp_name, sizeof(temp_name), "%s%s", file_name, PG_TEMP_SUFFIX);
+    remove(temp_name);
+    pager_t* pager = malloc(sizeof(pager_t));
+    if(!pager || ch_init(temp_name, &pager->ch) == CH_FAIL){
+        logger(LL_ERROR, __func__, "Unable to initialize temp space %s", temp_name);
+        free(pager);
+        return PAGER_FAIL;
+    }
+    pager->deleted_pages = -1;
+    pg_temp_pager = pager;
+    /* List of deleted pages lives in temp space itself */
+    int space = pg_use_space(PG_TEMP);
+    pg_create(pager);
+    pg_use_space(space);
+    return pager->deleted_pages == PA_FAIL ? PAGER_FAIL : PAGER_SUCCESS;
+}
+
 /**
  * @breif       Initializes pager
  * @param[in]   file_name: name of file to store data
@@ -32,12 +73,13 @@ static int pg_create(void){
 int pg_init(const char* file_name){
     logger(LL_DEBUG, __func__, "Initializing pager");
     PAGER = malloc(sizeof(pager_t));
+    pg_space = PG_MAIN;
     if (ch_init(file_name, &PAGER->ch) == CH_FAIL) {
         logger(LL_ERROR, __func__, "Unable to initialize caching");
         return PAGER_FAIL;
     }
     if(pg_max_page_index()){
-        pg_create();
+        pg_create(PAGER);
     }
     else{
         PAGER->deleted_pages = 0;
@@ -53,6 +95,7 @@ int pg_init(const char* file_name){
 
 int pg_delete(void){
     logger(LL_DEBUG, __func__, "Deleting file");
+    pg_temp_reset();
     if(ch_delete(&PAGER->ch) == CH_FAIL){
         logger(LL_ERROR, __func__, "Unable to delete caching");
         return PAGER_FAIL;
@@ -68,6 +111,7 @@ int pg_delete(void){
 
 int pg_close(void){
     logger(LL_DEBUG, __func__, "Closing file");
+    pg_temp_reset();
     if(ch_close(&PAGER->ch) == CH_FAIL){
         logger(LL_ERROR, __func__, "Unable to delete caching");
         return PAGER_FAIL;
@@ -77,35 +121,85 @@ int pg_close(void){
 }
 /**
  * Allocates page
- * @brief Loads free pages from file or allocates new page
+ * @brief Loads free pages from file or allocates new page in current space
  * @return index of page or PAGER_FAIL
  */
 
 int64_t pg_alloc(void){
     logger(LL_DEBUG, __func__, "Allocating page");
+    int space = pg_space;
+    if(space == PG_TEMP && pg_temp_open() == PAGER_FAIL){
+        return PAGER_FAIL;
+    }
+    pager_t* pager = space == PG_TEMP ? pg_temp_pager : PAGER;
     int64_t page_idx = -1;
 
     int64_t del_pag_idx = -1;
 
-    if(PAGER->deleted_pages != -1){
-        if((pa_pop64(PAGER->deleted_pages, &del_pag_idx)) == PA_SUCCESS){
+    if(pager->deleted_pages != -1){
+        if((pa_pop64(pager->deleted_pages, &del_pag_idx)) == PA_SUCCESS){
             page_idx = del_pag_idx;
         }
         if(del_pag_idx != -1){
-            ch_use_again(&PAGER->ch, del_pag_idx);
+            ch_use_again(&pager->ch, pg_local(del_pag_idx));
         }
     }
 
-    if(del_pag_idx == -1 || del_pag_idx > pg_max_page_index()){
+    if(del_pag_idx == -1 || pg_local(del_pag_idx) > ch_max_page_index((&pager->ch))){
         logger(LL_DEBUG, __func__, "Unable to pop page from deleted pages, allocating new page");
-        if((page_idx = ch_new_page(&PAGER->ch)) == CH_FAIL){
+        if((page_idx = ch_new_page(&pager->ch)) == CH_FAIL){
             logger(LL_ERROR, __func__, "Unable to load new page");
             return PAGER_FAIL;
         }
+        page_idx = pg_global(space, page_idx);
     }
     return page_idx;
 }
 
+/**
+ * @brief       Allocates page in the same space as given page
+ * @param[in]   page_index: index of page of the structure that grows
+ * @return      index of page or PAGER_FAIL
+ */
+
+int64_t pg_alloc_near(int64_t page_index){
+    int space = pg_use_space(pg_space_of(page_index));
+    int64_t page_idx = pg_alloc();
+    pg_use_space(space);
+    return page_idx;
+}
+
+/**
+ * @brief       Allocates run of contiguous pages at the end of file
+ * @note        Deleted pages are not reused, they are scattered across file
+ * @param[in]   count: number of pages
+ * @return      index of first page of run or PAGER_FAIL
+ */
+
+int64_t pg_alloc_run(int64_t count){
+    logger(LL_DEBUG, __func__, "Allocating run of %ld pages", count);
+    if(count <= 0){
+        logger(LL_ERROR, __func__, "Invalid run length %ld", count);
+        return PAGER_FAIL;
+    }
+    int space = pg_space;
+    if(space == PG_TEMP && pg_temp_open() == PAGER_FAIL){
+        return PAGER_FAIL;
+    }
+    pager_t* pager = space == PG_TEMP ? pg_temp_pager : PAGER;
+    int64_t first = -1;
+    for(int64_t i = 0; i < count; i++){
+        int64_t page_idx = ch_new_page(&pager->ch);
+        if(page_idx == CH_FAIL){
+            logger(LL_ERROR, __func__, "Unable to load new page");
+            return PAGER_FAIL;
+        }
+        if(first == -1){
+            first = page_idx;
+        }
+    }
+    return pg_global(space, first);
+}
 
 /**
  * Deallocates page
@@ -117,13 +211,14 @@ int64_t pg_alloc(void){
 
 int pg_dealloc(int64_t page_index) {
     logger(LL_DEBUG, __func__, "Deallocating page %ld", page_index);
-    pa_push_unique64(PAGER->deleted_pages, page_index);
-    ch_delete_page(&PAGER->ch, page_index);
+    pager_t* pager = pg_pager_of(page_index);
+    pa_push_unique64(pager->deleted_pages, page_index);
+    ch_delete_page(&pager->ch, pg_local(page_index));
     return PAGER_SUCCESS;
 }
 
 int pg_rm_cached(int64_t page_index){
-    ch_remove(&PAGER->ch, page_index);
+    ch_remove(&pg_pager_of(page_index)->ch, pg_local(page_index));
     return PAGER_SUCCESS;
 }
 
@@ -135,8 +230,13 @@ int pg_rm_cached(int64_t page_index){
 
 void* pg_load_page(int64_t page_index) {
     logger(LL_DEBUG, __func__, "Loading page %ld", page_index);
+    pager_t* pager = pg_pager_of(page_index);
+    if (pager == NULL) {
+        logger(LL_ERROR, __func__, "Temp space is not open, page %ld", page_index);
+        return NULL;
+    }
     void* page_ptr = NULL;
-    int res = ch_load_page(&PAGER->ch, page_index, &page_ptr);
+    int res = ch_load_page(&pager->ch, pg_local(page_index), &page_ptr);
     if (res == CH_FAIL) {
         logger(LL_ERROR, __func__, "Unable to load page %ld", page_index);
         return NULL;
@@ -161,7 +261,7 @@ int pg_write(int64_t page_index, void* src, size_t size, off_t offset){
     logger(LL_DEBUG, __func__,
            "Writing to page, page index: %ld, src: %p, size: %ld, offset: %ld",
            page_index, src, size, offset);
-    int res = ch_write(&PAGER->ch, page_index, src, size, offset);
+    int res = ch_write(&pg_pager_of(page_index)->ch, pg_local(page_index), src, size, offset);
     if(res == CH_FAIL){
         logger(LL_ERROR, __func__,
                "Unable to write to page, page index: %ld, src: %p, size: %ld, offset: %ld",
@@ -182,7 +282,7 @@ int pg_write(int64_t page_index, void* src, size_t size, off_t offset){
 
 int pg_copy_read(int64_t page_index, void* dest, size_t size, off_t offset){
     logger(LL_DEBUG, __func__, "Reading from page");
-    if(ch_copy_read(&PAGER->ch, page_index, dest, size, offset) == CH_FAIL){
+    if(ch_copy_read(&pg_pager_of(page_index)->ch, pg_local(page_index), dest, size, offset) == CH_FAIL){
         logger(LL_ERROR, __func__, "Unable to read from page");
         return PAGER_FAIL;
     }
@@ -207,6 +307,22 @@ off_t pg_file_size(void){
  int64_t pg_max_page_index(void){
      return $pg_max_page_index();
  }
+
+/**
+ * @brief       Get max page index in the space of given page
+ * @param[in]   page_index: index of page
+ * @return      max page index, tagged the same way as page_index
+ */
+
+int64_t pg_max_page_index_of(int64_t page_index){
+    if(!pg_is_temp(page_index)){
+        return $pg_max_page_index();
+    }
+    if(!pg_temp_pager || ch_max_page_index((&pg_temp_pager->ch)) < 0){
+        return -1;
+    }
+    return ch_max_page_index((&pg_temp_pager->ch)) | PG_TEMP_BIT;
+}
 /**
  * @brief   Get current cached size
  * @return  cached size
@@ -215,4 +331,40 @@ size_t pg_cached_size(void){
     return ch_size(&PAGER->ch);
  }
 
+/**
+ * @brief       Set space where new pages are allocated
+ * @param[in]   space: PG_MAIN or PG_TEMP
+ * @return      previous space
+ */
+
+int pg_use_space(int space){
+    int previous = pg_space;
+    pg_space = space;
+    return previous;
+}
+
+/**
+ * @brief       Get space of page
+ * @param[in]   page_index: index of page
+ * @return      PG_MAIN or PG_TEMP
+ */
 
+int pg_space_of(int64_t page_index){
+    return pg_is_temp(page_index) ? PG_TEMP : PG_MAIN;
+}
+
+/**
+ * @brief       Drop everything allocated in temp space
+ * @return      PAGER_SUCCESS on success, PAGER_FAIL otherwise
+ * @warning     all indexes of temp pages become invalid
+ */
+
+int pg_temp_reset(void){
+    if(!pg_temp_pager){
+        return PAGER_SUCCESS;
+    }
+    int res = ch_delete(&pg_temp_pager->ch) == CH_FAIL ? PAGER_FAIL : PAGER_SUCCESS;
+    free(pg_temp_pager);
+    pg_temp_pager = NULL;
+    return res;
+}
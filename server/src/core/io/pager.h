@@ -14,11 +14,26 @@ typedef struct pager{
 
 enum PagerStatuses{PAGER_SUCCESS = 0, PAGER_FAIL = -1, PAGER_DELETED=-2};
 
+/**
+ * Temp space is a second pager over a scratch file next to the database,
+ * it holds intermediate schemas and result tables of queries. Its pages are
+ * addressed by indexes with PG_TEMP_BIT set, so every pager call is routed by
+ * the index alone. New structures are allocated in the current space, pages
+ * added to an existing structure go to the space of the structure.
+ */
+
+#define PG_TEMP_BIT (INT64_C(1) << 62)
+#define pg_is_temp(page_index) ((page_index) > 0 && ((page_index) & PG_TEMP_BIT))
+
+enum PagerSpaces{PG_MAIN = 0, PG_TEMP = 1};
+
 
 int pg_init(const char* file_name);
 int pg_delete(void);
 int pg_close(void);
 int64_t pg_alloc(void);
+int64_t pg_alloc_near(int64_t page_index);
+int64_t pg_alloc_run(int64_t count);
 int pg_dealloc(int64_t page_index);
 int pg_rm_cached(int64_t page_index);
 void* pg_load_page(int64_t page_index);
@@ -26,6 +41,10 @@ int pg_write(int64_t page_index, void* src, size_t size, off_t offset);
 int pg_copy_read(int64_t page_index, void* dest, size_t size, off_t offset);
 off_t pg_file_size(void);
 int64_t pg_max_page_index(void);
+int64_t pg_max_page_index_of(int64_t page_index);
 size_t pg_cached_size(void);
+int pg_use_space(int space);
+int pg_space_of(int64_t page_index);
+int pg_temp_reset(void);
 
 
@@ -5,6 +5,8 @@
 #include "utils/logger.h"
 
 #include <math.h>
+#include <stddef.h>
+#include <string.h>
 
 /**
  * \brief       Allocates new linked block, with custom memory start
@@ -35,6 +37,7 @@ chblix_t lb_alloc_m(page_pool_t* page_pool, int64_t mem_start){
     lb->prev_block = chblix_fail();
     lb->chblix = chblix;
     lb->flag = LB_USED;
+    lb->length = 0;
     lb->mem_start = mem_start;
 
     lb_update_nova(page_pool, &chblix, lb);
@@ -58,6 +61,25 @@ chblix_t lb_alloc(page_pool_t* page_pool) {
     return lb_alloc_m(page_pool, sizeof(linked_block_t));
 }
 
+/**
+ * @brief       Cut read to the written length of chain
+ * @param[in]   lb: head of the chain
+ * @param[out]  dest: destination, part past the length is zeroed
+ * @param[in]   size: size to read, reduced to the size present in chain
+ * @param[in]   src_offset: offset to read from
+ * @return      LB_SUCCESS if everything is present, LB_PARTIAL otherwise
+ */
+
+static int lb_clamp(const linked_block_t* lb, void* dest, int64_t* size, int64_t src_offset){
+    if(src_offset + *size <= lb->length){
+        return LB_SUCCESS;
+    }
+    int64_t present = lb->length > src_offset ? lb->length - src_offset : 0;
+    memset((uint8_t*) dest + present, 0, *size - present);
+    *size = present;
+    return LB_PARTIAL;
+}
+
 /**
  * \brief       Loads linked block
  * \param[in]   page_pool_idx: Fist page index of page pool
@@ -249,7 +271,7 @@ chblix_t lb_go_to_nova(page_pool_t* ppl,
     chblix_t res = *chblix;
     /* Go to block */
     while (counter != block_idx) {
-        res = lb_get_next_nova(ppl, chblix);
+        res = lb_get_next_nova(ppl, &res);
         counter++;
     }
 
@@ -319,7 +341,7 @@ static chblix_t lb_go_to(int64_t pplidx,
     chblix_t res = *chblix;
     /* Go to block */
     while (counter != block_idx) {
-        res = lb_get_next(pplidx, chblix);
+        res = lb_get_next(pplidx, &res);
         counter++;
     }
 
@@ -358,6 +380,27 @@ int lb_write(page_pool_t* ppl,
         return LB_FAIL;
     }
 
+    /* Grow the chain length, bytes skipped by the write are zeroed */
+    if (src_offset + size > lb->length) {
+        int64_t length = lb->length;
+        lb->length = (int32_t)(src_offset + size);
+        if (ppl_write_block_nova(ppl, chblix, &lb->length, sizeof(lb->length),
+                                 offsetof(linked_block_t, length)) == PPL_FAIL) {
+            logger(LL_ERROR, __func__, "Unable to update length of block");
+            free(lb);
+            return LB_FAIL;
+        }
+        if (src_offset > length) {
+            void* zeros = calloc(src_offset - length, 1);
+            int res = lb_write(ppl, chblix, zeros, src_offset - length, length);
+            free(zeros);
+            if (res == LB_FAIL) {
+                free(lb);
+                return LB_FAIL;
+            }
+        }
+    }
+
     /* Initializing variables */
     int64_t useful_space_size = ppl->block_size - lb->mem_start;
     int64_t start_block = floor((double) src_offset / (double) useful_space_size);
@@ -393,8 +436,7 @@ int lb_write(page_pool_t* ppl,
             start_offset = 0;
 
             /* Go to next block */
-            start_point = lb_get_next(page_pool_index(ppl), &lb->chblix);
-            lb_load(page_pool_index(ppl), &start_point, lb);
+            start_point = lb_get_next(page_pool_index(ppl), &start_point);
 
         }
 
@@ -437,6 +479,11 @@ int lb_read_nova(page_pool_t* ppl,
         free(lb);
         return LB_FAIL;
     }
+    int res = lb_clamp(lb, dest, &size, src_offset);
+    if (size == 0) {
+        free(lb);
+        return res;
+    }
     /* Initializing variables */
     int64_t useful_space_size = ppl->block_size - lb->mem_start;
     int64_t start_block = floor((double) src_offset / (double) useful_space_size);
@@ -473,14 +520,14 @@ int lb_read_nova(page_pool_t* ppl,
             start_offset = 0;
 
             /* Go to next block */
-            start_point = lb_get_next_nova(ppl, &lb->chblix);
-            lb_load_nova_ppp(ppl, &start_point, lb);
+            start_point = lb_get_next_nova(ppl, &start_point);
+            start_chunk = lp_load(start_point.chunk_idx);
 
         }
 
     }
     free(lb);
-    return LB_SUCCESS;
+    return res;
 
 }
 
@@ -527,6 +574,11 @@ int lb_read(int64_t pplidx,
         free(lb);
         return LB_FAIL;
     }
+    int res = lb_clamp(lb, dest, &size, src_offset);
+    if (size == 0) {
+        free(lb);
+        return res;
+    }
 
     /* Initializing variables */
     int64_t useful_space_size = ppl->block_size - lb->mem_start;
@@ -563,14 +615,13 @@ int lb_read(int64_t pplidx,
             start_offset = 0;
 
             /* Go to next block */
-            start_point = lb_get_next(pplidx, &lb->chblix);
-            lb_load(pplidx, &start_point, lb);
+            start_point = lb_get_next(pplidx, &start_point);
 
         }
 
     }
     free(lb);
-    return LB_SUCCESS;
+    return res;
 }
 
 
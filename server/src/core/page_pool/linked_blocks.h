@@ -8,6 +8,7 @@ typedef struct linked_block{
     chblix_t prev_block;
     chblix_t chblix;
     char flag;
+    int32_t length; //bytes written to the chain, reads past it get zeros
     int64_t mem_start;
 } linked_block_t;
 
@@ -16,7 +17,7 @@ typedef struct ptr_chblix{
     int64_t block_idx;
 } ptr_chblix_t;
 
-typedef enum {LB_SUCCESS = 0, LB_FAIL = -1} linked_block_status_t;
+typedef enum {LB_SUCCESS = 0, LB_FAIL = -1, LB_PARTIAL = 1} linked_block_status_t;
 typedef enum {LB_FREE = 0, LB_USED = 1} linked_block_flag_t;
 
 #define lb_for_each(chunk, chblix, ppl) \
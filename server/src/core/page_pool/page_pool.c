@@ -43,7 +43,7 @@ int chblix_cmp(const chblix_t* chblix1, const chblix_t* chblix2){
 
 int64_t ppl_chunk_init(page_pool_t* ppl){
     logger(LL_DEBUG, __func__, "Initializing chunk");
-    int64_t page_index = lp_init_m(sizeof(chunk_t));
+    int64_t page_index = lp_init_near(ppl->lp_header.page_index, sizeof(chunk_t));
     if(page_index == LP_FAIL){
         logger(LL_ERROR, __func__, "Unable to load chunk");
         return PPL_FAIL;
@@ -100,10 +100,10 @@ chunk_t* ppl_create_page(page_pool_t* ppl){
 chunk_t* ppl_load_chunk(int64_t chunk_index){
     logger(LL_DEBUG, __func__, "Loading page %ld", chunk_index);
 
-    if(chunk_index > pg_max_page_index()){
+    if(chunk_index > pg_max_page_index_of(chunk_index)){
         logger(LL_ERROR, __func__,
                "chunk_t index is out of range %ld, max index: %ld",
-               chunk_index, pg_max_page_index());
+               chunk_index, pg_max_page_index_of(chunk_index));
         return NULL;
     }
 
@@ -332,13 +332,7 @@ chblix_t ppl_alloc_nova(page_pool_t* ppl){
         logger(LL_ERROR, __func__, "Unable to load current page");
         return (chblix_t){.chunk_idx = PPL_FAIL, .block_idx = PPL_FAIL};
     }
-    // Check if next block not already initialized
-    if(current->num_of_used_blocks < current->capacity){
-        chblix_t chblix = {.chunk_idx = current->page_index, .block_idx = current->num_of_used_blocks };
-        current->num_of_used_blocks++;
-        ppl_write_block_nova(ppl, &chblix, &current->num_of_used_blocks,
-                        sizeof(int64_t), 0);
-    }
+    // Expand before initialization, so that the first block of a new chunk is initialized too
     if (current->num_of_free_blocks == 0){
         current->next = -1;
         if(ppl_pool_expand(ppl) == PPL_FAIL){
@@ -347,6 +341,13 @@ chblix_t ppl_alloc_nova(page_pool_t* ppl){
         }
         current = ppl_load_chunk(ppl->current_idx);
     }
+    // Check if next block not already initialized
+    if(current->num_of_used_blocks < current->capacity){
+        chblix_t chblix = {.chunk_idx = current->page_index, .block_idx = current->num_of_used_blocks };
+        current->num_of_used_blocks++;
+        ppl_write_block_nova(ppl, &chblix, &current->num_of_used_blocks,
+                        sizeof(int64_t), 0);
+    }
 
     chblix_t chblixres;
 
@@ -560,7 +561,7 @@ int64_t ppl_init(int64_t block_size){
 
 page_pool_t* ppl_load(int64_t start_page_index){
     logger(LL_DEBUG, __func__, "Loading chunk_t Pool %ld.", start_page_index);
-    if(start_page_index > pg_max_page_index()){
+    if(start_page_index > pg_max_page_index_of(start_page_index)){
         logger(LL_ERROR, __func__, "You need to init page pool before");
         return NULL;
     }
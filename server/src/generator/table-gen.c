@@ -88,16 +88,15 @@ int gen_fill_element(db_t* db, field_t* field, uint8_t* element){
         case DT_VARCHAR: {
             size_t size = 1 + arc4random_uniform(257);
             char* rand_varchar = malloc(size);
-            for(int64_t i = 0; i < size; ++i){
+            for(int64_t i = 0; i < size - 1; ++i){
                 rand_varchar[i] = (char)((uint32_t)'a' + arc4random_uniform(26));
             }
-            vch_ticket_t ticket = vch_add(db->varchar_mgr_idx, rand_varchar);
-            if(chblix_cmp(&ticket.block, &CHBLIX_FAIL) == 0){
+            rand_varchar[size - 1] = '\0';
+            if(sch_put_varchar(db->varchar_mgr_idx, field, rand_varchar, element) == SCHEMA_FAIL){
                 logger(LL_ERROR, __func__, "Failed to add varchar");
+                free(rand_varchar);
                 return -1;
             }
-
-            memcpy(element, &ticket, sizeof(vch_ticket_t));
             free(rand_varchar);
             break;
         }
@@ -6,6 +6,7 @@
 #include "backend/db/db.h"
 #include "backend/connection/query_execute/reqexe.h"
 #include "backend/table/table.h"
+#include "backend/comparator/jit.h"
 #include <signal.h>
 
 #define DEFAULT_FILE "main.db"
@@ -62,6 +63,7 @@ void client_handler(struct handler_args *args) {
         if(resp->table !=NULL && strcmp(resp->table->name,"TEMP") == 0){
             tab_drop(args->db, resp->table);
         }
+        pg_temp_reset();
         free(message);
         free(resp);
         xmlFree(response_xml);
@@ -74,11 +76,19 @@ void client_handler(struct handler_args *args) {
 int main(int argc, char **argv) {
     char *filename = DEFAULT_FILE;
     int port = DEFAULT_PORT;
-    if (argc > 1) {
-        port = atoi(argv[1]);
-    }
-    if (argc > 2) {
-        filename = argv[2];
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--jit") == 0) {
+            if (!jit_set_enabled(true)) {
+                logger(LL_WARN, __func__, "JIT is not supported on this machine, filters are interpreted");
+            }
+        } else if (strcmp(argv[i], "--no-jit") == 0) {
+            jit_set_enabled(false);
+        } else if (positional++ == 0) {
+            port = atoi(argv[i]);
+        } else {
+            filename = argv[i];
+        }
     }
 
 
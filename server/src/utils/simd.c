@@ -0,0 +1,451 @@
+#include "simd.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#define SIMD_TARGET(t) __attribute__((target(t)))
+#else
+#define SIMD_X86 0
+#endif
+
+typedef struct simd_kernels {
+    int64_t (*find_first_i64)(const int64_t*, int64_t, int64_t);
+    int64_t (*count_eq_i64)(const int64_t*, int64_t, int64_t);
+    void (*cmp_mask_i64)(const int64_t*, int64_t, int64_t, simd_op_t, uint64_t*);
+    int64_t (*find_first_f64)(const double*, int64_t, double);
+    int64_t (*count_eq_f64)(const double*, int64_t, double);
+    void (*cmp_mask_f64)(const double*, int64_t, double, simd_op_t, uint64_t*);
+} simd_kernels_t;
+
+#define scalar_cmp(a, b, op) \
+    ((op) == SIMD_EQ ? (a) == (b) : \
+     (op) == SIMD_NE ? (a) != (b) : \
+     (op) == SIMD_LT ? (a) < (b) : \
+     (op) == SIMD_LE ? (a) <= (b) : \
+     (op) == SIMD_GT ? (a) > (b) : (a) >= (b))
+
+/* Scalar kernels, also used for the tails of vector loops */
+
+static int64_t scalar_find_first_i64(const int64_t* data, int64_t n, int64_t value){
+    for (int64_t i = 0; i < n; i++) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return SIMD_NOT_FOUND;
+}
+
+static int64_t scalar_count_eq_i64(const int64_t* data, int64_t n, int64_t value){
+    int64_t count = 0;
+    for (int64_t i = 0; i < n; i++) {
+        count += data[i] == value;
+    }
+    return count;
+}
+
+static void scalar_cmp_mask_i64(const int64_t* data, int64_t n, int64_t value, simd_op_t op, uint64_t* mask){
+    memset(mask, 0, simd_mask_words(n) * sizeof(uint64_t));
+    for (int64_t i = 0; i < n; i++) {
+        mask[i / 64] |= (uint64_t) scalar_cmp(data[i], value, op) << (i % 64);
+    }
+}
+
+static int64_t scalar_find_first_f64(const double* data, int64_t n, double value){
+    for (int64_t i = 0; i < n; i++) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return SIMD_NOT_FOUND;
+}
+
+static int64_t scalar_count_eq_f64(const double* data, int64_t n, double value){
+    int64_t count = 0;
+    for (int64_t i = 0; i < n; i++) {
+        count += data[i] == value;
+    }
+    return count;
+}
+
+static void scalar_cmp_mask_f64(const double* data, int64_t n, double value, simd_op_t op, uint64_t* mask){
+    memset(mask, 0, simd_mask_words(n) * sizeof(uint64_t));
+    for (int64_t i = 0; i < n; i++) {
+        mask[i / 64] |= (uint64_t) scalar_cmp(data[i], value, op) << (i % 64);
+    }
+}
+
+static const simd_kernels_t scalar_kernels = {
+        scalar_find_first_i64, scalar_count_eq_i64, scalar_cmp_mask_i64,
+        scalar_find_first_f64, scalar_count_eq_f64, scalar_cmp_mask_f64
+};
+
+#if SIMD_X86
+
+/* SSE4.2 kernels, 2 lanes per vector */
+
+SIMD_TARGET("sse4.2")
+static inline int sse_mask_i64(__m128i v, __m128i key, simd_op_t op){
+    switch (op) {
+        case SIMD_EQ: return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(v, key)));
+        case SIMD_NE: return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(v, key))) ^ 0x3;
+        case SIMD_GT: return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(v, key)));
+        case SIMD_LE: return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(v, key))) ^ 0x3;
+        case SIMD_LT: return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(key, v)));
+        default:      return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(key, v))) ^ 0x3;
+    }
+}
+
+SIMD_TARGET("sse4.2")
+static inline int sse_mask_f64(__m128d v, __m128d key, simd_op_t op){
+    switch (op) {
+        case SIMD_EQ: return _mm_movemask_pd(_mm_cmpeq_pd(v, key));
+        case SIMD_NE: return _mm_movemask_pd(_mm_cmpneq_pd(v, key));
+        case SIMD_LT: return _mm_movemask_pd(_mm_cmplt_pd(v, key));
+        case SIMD_LE: return _mm_movemask_pd(_mm_cmple_pd(v, key));
+        case SIMD_GT: return _mm_movemask_pd(_mm_cmpgt_pd(v, key));
+        default:      return _mm_movemask_pd(_mm_cmpge_pd(v, key));
+    }
+}
+
+SIMD_TARGET("sse4.2")
+static int64_t sse_find_first_i64(const int64_t* data, int64_t n, int64_t value){
+    __m128i key = _mm_set1_epi64x(value);
+    int64_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        int bits = sse_mask_i64(_mm_loadu_si128((const __m128i*)(data + i)), key, SIMD_EQ);
+        if (bits) {
+            return i + __builtin_ctz(bits);
+        }
+    }
+    int64_t tail = scalar_find_first_i64(data + i, n - i, value);
+    return tail == SIMD_NOT_FOUND ? SIMD_NOT_FOUND : i + tail;
+}
+
+SIMD_TARGET("sse4.2,popcnt")
+static int64_t sse_count_eq_i64(const int64_t* data, int64_t n, int64_t value){
+    __m128i key = _mm_set1_epi64x(value);
+    int64_t count = 0;
+    int64_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        count += __builtin_popcount(sse_mask_i64(_mm_loadu_si128((const __m128i*)(data + i)), key, SIMD_EQ));
+    }
+    return count + scalar_count_eq_i64(data + i, n - i, value);
+}
+
+SIMD_TARGET("sse4.2")
+static void sse_cmp_mask_i64(const int64_t* data, int64_t n, int64_t value, simd_op_t op, uint64_t* mask){
+    __m128i key = _mm_set1_epi64x(value);
+    int64_t full = n / 64 * 64;
+    for (int64_t w = 0; w < full; w += 64) {
+        uint64_t word = 0;
+        for (int64_t j = 0; j < 64; j += 2) {
+            word |= (uint64_t) sse_mask_i64(_mm_loadu_si128((const __m128i*)(data + w + j)), key, op) << j;
+        }
+        mask[w / 64] = word;
+    }
+    if (full < n) {
+        scalar_cmp_mask_i64(data + full, n - full, value, op, mask + full / 64);
+    }
+}
+
+SIMD_TARGET("sse4.2")
+static int64_t sse_find_first_f64(const double* data, int64_t n, double value){
+    __m128d key = _mm_set1_pd(value);
+    int64_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        int bits = sse_mask_f64(_mm_loadu_pd(data + i), key, SIMD_EQ);
+        if (bits) {
+            return i + __builtin_ctz(bits);
+        }
+    }
+    int64_t tail = scalar_find_first_f64(data + i, n - i, value);
+    return tail == SIMD_NOT_FOUND ? SIMD_NOT_FOUND : i + tail;
+}
+
+SIMD_TARGET("sse4.2,popcnt")
+static int64_t sse_count_eq_f64(const double* data, int64_t n, double value){
+    __m128d key = _mm_set1_pd(value);
+    int64_t count = 0;
+    int64_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        count += __builtin_popcount(sse_mask_f64(_mm_loadu_pd(data + i), key, SIMD_EQ));
+    }
+    return count + scalar_count_eq_f64(data + i, n - i, value);
+}
+
+SIMD_TARGET("sse4.2")
+static void sse_cmp_mask_f64(const double* data, int64_t n, double value, simd_op_t op, uint64_t* mask){
+    __m128d key = _mm_set1_pd(value);
+    int64_t full = n / 64 * 64;
+    for (int64_t w = 0; w < full; w += 64) {
+        uint64_t word = 0;
+        for (int64_t j = 0; j < 64; j += 2) {
+            word |= (uint64_t) sse_mask_f64(_mm_loadu_pd(data + w + j), key, op) << j;
+        }
+        mask[w / 64] = word;
+    }
+    if (full < n) {
+        scalar_cmp_mask_f64(data + full, n - full, value, op, mask + full / 64);
+    }
+}
+
+static const simd_kernels_t sse_kernels = {
+        sse_find_first_i64, sse_count_eq_i64, sse_cmp_mask_i64,
+        sse_find_first_f64, sse_count_eq_f64, sse_cmp_mask_f64
+};
+
+/* AVX2 kernels, 4 lanes per vector */
+
+SIMD_TARGET("avx2")
+static inline int avx_mask_i64(__m256i v, __m256i key, simd_op_t op){
+    switch (op) {
+        case SIMD_EQ: return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, key)));
+        case SIMD_NE: return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, key))) ^ 0xF;
+        case SIMD_GT: return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(v, key)));
+        case SIMD_LE: return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(v, key))) ^ 0xF;
+        case SIMD_LT: return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(key, v)));
+        default:      return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(key, v))) ^ 0xF;
+    }
+}
+
+SIMD_TARGET("avx2")
+static inline int avx_mask_f64(__m256d v, __m256d key, simd_op_t op){
+    switch (op) {
+        case SIMD_EQ: return _mm256_movemask_pd(_mm256_cmp_pd(v, key, _CMP_EQ_OQ));
+        case SIMD_NE: return _mm256_movemask_pd(_mm256_cmp_pd(v, key, _CMP_NEQ_UQ));
+        case SIMD_LT: return _mm256_movemask_pd(_mm256_cmp_pd(v, key, _CMP_LT_OQ));
+        case SIMD_LE: return _mm256_movemask_pd(_mm256_cmp_pd(v, key, _CMP_LE_OQ));
+        case SIMD_GT: return _mm256_movemask_pd(_mm256_cmp_pd(v, key, _CMP_GT_OQ));
+        default:      return _mm256_movemask_pd(_mm256_cmp_pd(v, key, _CMP_GE_OQ));
+    }
+}
+
+SIMD_TARGET("avx2")
+static int64_t avx_find_first_i64(const int64_t* data, int64_t n, int64_t value){
+    __m256i key = _mm256_set1_epi64x(value);
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int bits = avx_mask_i64(_mm256_loadu_si256((const __m256i*)(data + i)), key, SIMD_EQ);
+        if (bits) {
+            return i + __builtin_ctz(bits);
+        }
+    }
+    int64_t tail = scalar_find_first_i64(data + i, n - i, value);
+    return tail == SIMD_NOT_FOUND ? SIMD_NOT_FOUND : i + tail;
+}
+
+SIMD_TARGET("avx2")
+static int64_t avx_count_eq_i64(const int64_t* data, int64_t n, int64_t value){
+    __m256i key = _mm256_set1_epi64x(value);
+    __m256i acc = _mm256_setzero_si256();
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        /* equal lanes are -1, subtracting them counts matches per lane */
+        acc = _mm256_sub_epi64(acc, _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(data + i)), key));
+    }
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i*) lanes, acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + scalar_count_eq_i64(data + i, n - i, value);
+}
+
+SIMD_TARGET("avx2")
+static void avx_cmp_mask_i64(const int64_t* data, int64_t n, int64_t value, simd_op_t op, uint64_t* mask){
+    __m256i key = _mm256_set1_epi64x(value);
+    int64_t full = n / 64 * 64;
+    for (int64_t w = 0; w < full; w += 64) {
+        uint64_t word = 0;
+        for (int64_t j = 0; j < 64; j += 4) {
+            word |= (uint64_t) avx_mask_i64(_mm256_loadu_si256((const __m256i*)(data + w + j)), key, op) << j;
+        }
+        mask[w / 64] = word;
+    }
+    if (full < n) {
+        scalar_cmp_mask_i64(data + full, n - full, value, op, mask + full / 64);
+    }
+}
+
+SIMD_TARGET("avx2")
+static int64_t avx_find_first_f64(const double* data, int64_t n, double value){
+    __m256d key = _mm256_set1_pd(value);
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int bits = avx_mask_f64(_mm256_loadu_pd(data + i), key, SIMD_EQ);
+        if (bits) {
+            return i + __builtin_ctz(bits);
+        }
+    }
+    int64_t tail = scalar_find_first_f64(data + i, n - i, value);
+    return tail == SIMD_NOT_FOUND ? SIMD_NOT_FOUND : i + tail;
+}
+
+SIMD_TARGET("avx2")
+static int64_t avx_count_eq_f64(const double* data, int64_t n, double value){
+    __m256d key = _mm256_set1_pd(value);
+    __m256i acc = _mm256_setzero_si256();
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d eq = _mm256_cmp_pd(_mm256_loadu_pd(data + i), key, _CMP_EQ_OQ);
+        acc = _mm256_sub_epi64(acc, _mm256_castpd_si256(eq));
+    }
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i*) lanes, acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + scalar_count_eq_f64(data + i, n - i, value);
+}
+
+SIMD_TARGET("avx2")
+static void avx_cmp_mask_f64(const double* data, int64_t n, double value, simd_op_t op, uint64_t* mask){
+    __m256d key = _mm256_set1_pd(value);
+    int64_t full = n / 64 * 64;
+    for (int64_t w = 0; w < full; w += 64) {
+        uint64_t word = 0;
+        for (int64_t j = 0; j < 64; j += 4) {
+            word |= (uint64_t) avx_mask_f64(_mm256_loadu_pd(data + w + j), key, op) << j;
+        }
+        mask[w / 64] = word;
+    }
+    if (full < n) {
+        scalar_cmp_mask_f64(data + full, n - full, value, op, mask + full / 64);
+    }
+}
+
+static const simd_kernels_t avx_kernels = {
+        avx_find_first_i64, avx_count_eq_i64, avx_cmp_mask_i64,
+        avx_find_first_f64, avx_count_eq_f64, avx_cmp_mask_f64
+};
+
+#endif
+
+static const simd_kernels_t* simd_active = NULL;
+static simd_level_t simd_active_level = SIMD_SCALAR;
+
+/**
+ * @brief       Detects the best level supported by CPU
+ * @return      supported simd level
+ */
+
+static simd_level_t simd_detect(void){
+#if SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) {
+        return SIMD_SSE42;
+    }
+#endif
+    return SIMD_SCALAR;
+}
+
+/**
+ * @brief       Select kernels
+ * @param[in]   level: requested simd level, lowered to the supported one
+ * @return      selected level
+ */
+
+simd_level_t simd_set_level(simd_level_t level){
+    simd_level_t supported = simd_detect();
+    if (level > supported) {
+        level = supported;
+    }
+    simd_active = &scalar_kernels;
+#if SIMD_X86
+    if (level == SIMD_AVX2) {
+        simd_active = &avx_kernels;
+    } else if (level == SIMD_SSE42) {
+        simd_active = &sse_kernels;
+    }
+#endif
+    simd_active_level = level;
+    return level;
+}
+
+/**
+ * @brief       Get active simd level
+ * @return      active simd level
+ */
+
+simd_level_t simd_level(void){
+    if (!simd_active) {
+        simd_set_level(SIMD_AVX2);
+    }
+    return simd_active_level;
+}
+
+#define simd_kernels() (simd_active ? simd_active : (simd_level(), simd_active))
+
+/**
+ * @brief       Find first element equal to value
+ * @param[in]   data: array
+ * @param[in]   n: number of elements
+ * @param[in]   value: value to find
+ * @return      index of first occurrence or SIMD_NOT_FOUND
+ */
+
+int64_t simd_find_first_i64(const int64_t* data, int64_t n, int64_t value){
+    return simd_kernels()->find_first_i64(data, n, value);
+}
+
+/**
+ * @brief       Count elements equal to value
+ * @param[in]   data: array
+ * @param[in]   n: number of elements
+ * @param[in]   value: value to count
+ * @return      number of occurrences
+ */
+
+int64_t simd_count_eq_i64(const int64_t* data, int64_t n, int64_t value){
+    return simd_kernels()->count_eq_i64(data, n, value);
+}
+
+/**
+ * @brief       Compare every element with value
+ * @param[in]   data: array
+ * @param[in]   n: number of elements
+ * @param[in]   value: right operand of comparison
+ * @param[in]   op: comparison
+ * @param[out]  mask: simd_mask_words(n) words, bit i is set if data[i] op value
+ */
+
+void simd_cmp_mask_i64(const int64_t* data, int64_t n, int64_t value, simd_op_t op, uint64_t* mask){
+    simd_kernels()->cmp_mask_i64(data, n, value, op, mask);
+}
+
+/**
+ * @brief       Find first element equal to value
+ * @param[in]   data: array
+ * @param[in]   n: number of elements
+ * @param[in]   value: value to find
+ * @return      index of first occurrence or SIMD_NOT_FOUND
+ */
+
+int64_t simd_find_first_f64(const double* data, int64_t n, double value){
+    return simd_kernels()->find_first_f64(data, n, value);
+}
+
+/**
+ * @brief       Count elements equal to value
+ * @param[in]   data: array
+ * @param[in]   n: number of elements
+ * @param[in]   value: value to count
+ * @return      number of occurrences
+ */
+
+int64_t simd_count_eq_f64(const double* data, int64_t n, double value){
+    return simd_kernels()->count_eq_f64(data, n, value);
+}
+
+/**
+ * @brief       Compare every element with value, NaN compares unequal to everything
+ * @param[in]   data: array
+ * @param[in]   n: number of elements
+ * @param[in]   value: right operand of comparison
+ * @param[in]   op: comparison
+ * @param[out]  mask: simd_mask_words(n) words, bit i is set if data[i] op value
+ */
+
+void simd_cmp_mask_f64(const double* data, int64_t n, double value, simd_op_t op, uint64_t* mask){
+    simd_kernels()->cmp_mask_f64(data, n, value, op, mask);
+}
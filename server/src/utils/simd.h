@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Search kernels over contiguous int64/double arrays. The best
+ * implementation (AVX2, SSE4.2 or scalar) is picked at runtime on first use.
+ */
+
+typedef enum {SIMD_SCALAR = 0, SIMD_SSE42 = 1, SIMD_AVX2 = 2} simd_level_t;
+
+typedef enum {SIMD_EQ = 0, SIMD_NE, SIMD_LT, SIMD_LE, SIMD_GT, SIMD_GE} simd_op_t;
+
+#define SIMD_NOT_FOUND (-1)
+#define simd_mask_words(n) (((n) + 63) / 64)
+#define simd_mask_test(mask, i) (((mask)[(i) / 64] >> ((i) % 64)) & 1)
+
+simd_level_t simd_level(void);
+simd_level_t simd_set_level(simd_level_t level);
+int64_t simd_find_first_i64(const int64_t* data, int64_t n, int64_t value);
+int64_t simd_count_eq_i64(const int64_t* data, int64_t n, int64_t value);
+void simd_cmp_mask_i64(const int64_t* data, int64_t n, int64_t value, simd_op_t op, uint64_t* mask);
+int64_t simd_find_first_f64(const double* data, int64_t n, double value);
+int64_t simd_count_eq_f64(const double* data, int64_t n, double value);
+void simd_cmp_mask_f64(const double* data, int64_t n, double value, simd_op_t op, uint64_t* mask);
@@ -0,0 +1,87 @@
+#include "../src/test.h"
+#include "backend/db/db.h"
+#include "backend/journal/dictionary.h"
+#include "backend/table/table.h"
+#include <stdio.h>
+#include <string.h>
+
+DEFINE_TEST(intern_and_grow){
+    db_t* db = db_init("test.db");
+    int64_t dict = dict_init();
+    assert(dict != DICT_FAIL);
+    char str[64];
+    for(int round = 0; round < 2; round++){
+        for(int32_t i = 0; i < 1000; i++){
+            sprintf(str, i % 2 ? "city %d" : "a rather long city name number %d", i);
+            assert(dict_intern(db->varchar_mgr_idx, dict, str) == i);
+        }
+    }
+    assert(dict_size(dict) == 1000);
+    assert(dict_find(db->varchar_mgr_idx, dict, "city 7") == 7);
+    assert(dict_find(db->varchar_mgr_idx, dict, "city 8") == DICT_NOT_FOUND);
+
+    vch_ticket_t ticket;
+    assert(dict_ticket(dict, 998, &ticket) == PA_SUCCESS);
+    char* read = vch_acquire(db->varchar_mgr_idx, &ticket);
+    assert(strcmp(read, "a rather long city name number 998") == 0);
+    vch_release(&ticket, read);
+    assert(dict_destroy(db->varchar_mgr_idx, dict) == PA_SUCCESS);
+    db_drop();
+}
+
+DEFINE_TEST(dict_column_filter){
+    db_t* db = db_init("test.db");
+    const char* countries[] = {"Russia", "Argentina", "Zimbabwe"};
+
+    schema_t* schema = sch_init();
+    sch_add_int_field(schema, "ID");
+    sch_add_dict_varchar_field(schema, "COUNTRY");
+    table_t* table = tab_init(db, "test", schema);
+    field_t id_field;
+    field_t country_field;
+    sch_get_field(schema, "ID", &id_field);
+    sch_get_field(schema, "COUNTRY", &country_field);
+    assert(sch_is_dict_field(&country_field));
+    assert(country_field.size == sizeof(int32_t));
+
+    char* row = malloc(schema->slot_size);
+    for(int64_t i = 0; i < 300; i++){
+        memcpy(row + id_field.offset, &i, sizeof(int64_t));
+        assert(sch_put_varchar(db->varchar_mgr_idx, &country_field, countries[i % 3], row + country_field.offset) == SCHEMA_SUCCESS);
+        tab_insert(table, schema, row);
+    }
+    free(row);
+    assert(dict_size(country_field.dict) == 3);
+
+    vch_ticket_t value = vch_add(db->varchar_mgr_idx, "Argentina");
+    row_likedlist_t* eq = tab_filter(db, table, schema, &country_field, COND_EQ, &value, DT_VARCHAR);
+    row_likedlist_t* gt = tab_filter(db, table, schema, &country_field, COND_GT, &value, DT_VARCHAR);
+    vch_ticket_t missing = vch_add(db->varchar_mgr_idx, "Peru");
+    row_likedlist_t* neq = tab_filter(db, table, schema, &country_field, COND_NEQ, &missing, DT_VARCHAR);
+    int64_t eq_count = 0;
+    int64_t gt_count = 0;
+    int64_t neq_count = 0;
+    for(row_node_t* node = eq->head; node != NULL; node = node->next){
+        assert(*(int64_t*)((char*)node->row + id_field.offset) % 3 == 1);
+        eq_count++;
+    }
+    for(row_node_t* node = gt->head; node != NULL; node = node->next){
+        gt_count++;
+    }
+    for(row_node_t* node = neq->head; node != NULL; node = node->next){
+        neq_count++;
+    }
+    assert(eq_count == 100);
+    assert(gt_count == 200);
+    assert(neq_count == 300);
+    row_likedlist_free(eq);
+    row_likedlist_free(gt);
+    row_likedlist_free(neq);
+    db_drop();
+}
+
+int main(){
+    RUN_SINGLE_TEST(intern_and_grow);
+    RUN_SINGLE_TEST(dict_column_filter);
+    return 0;
+}
@@ -42,8 +42,51 @@ DEFINE_TEST(close_and_open){
 }
 
 
+DEFINE_TEST(random_access){
+    assert(pg_init("test.db") == PAGER_SUCCESS);
+    int64_t array = pa_init(sizeof(int64_t));
+    int64_t count = 200000;
+    for(int64_t i = 0; i < count; i++){
+        assert(pa_append(array, &i, sizeof(int64_t)) == PA_SUCCESS);
+    }
+    assert(pa_size(array) == count);
+    srand(42);
+    for(int64_t i = 0; i < 10000; i++){
+        int64_t idx = rand() % count;
+        int64_t value = -1;
+        assert(pa_at(array, idx, &value) == PA_SUCCESS);
+        assert(value == idx);
+    }
+    pa_destroy(array);
+    pg_delete();
+}
+
+DEFINE_TEST(append_blocks_and_read_range){
+    assert(pg_init("test.db") == PAGER_SUCCESS);
+    int64_t array = pa_init(sizeof(int64_t));
+    int64_t count = 50000;
+    int64_t* values = malloc(count * sizeof(int64_t));
+    for(int64_t i = 0; i < count; i++){
+        values[i] = i * 3;
+    }
+    assert(pa_append(array, &values[0], sizeof(int64_t)) == PA_SUCCESS);
+    assert(pa_append_blocks(array, &values[1], count - 1) == PA_SUCCESS);
+    assert(pa_size(array) == count);
+
+    int64_t* read = malloc(count * sizeof(int64_t));
+    assert(pa_read_blocks(array, 0, read, count * (int64_t)sizeof(int64_t), 0) == PA_SUCCESS);
+    assert(memcmp(values, read, count * sizeof(int64_t)) == 0);
+    assert(pa_read_blocks(array, 1234, read, 4000 * (int64_t)sizeof(int64_t), 0) == PA_SUCCESS);
+    assert(memcmp(values + 1234, read, 4000 * sizeof(int64_t)) == 0);
+    free(values);
+    free(read);
+    pa_destroy(array);
+    pg_delete();
+}
 
 int main(){
     RUN_SINGLE_TEST(write_and_read);
     RUN_SINGLE_TEST(close_and_open);
+    RUN_SINGLE_TEST(random_access);
+    RUN_SINGLE_TEST(append_blocks_and_read_range);
 }
\ No newline at end of file
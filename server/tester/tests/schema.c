@@ -1,6 +1,8 @@
 #include "../src/test.h"
 #include "core/io/pager.h"
 #include "backend/table/schema.h"
+#include "backend/table/schema_desc.h"
+#include "backend/db/db.h"
 
 DEFINE_TEST(create_add_foreach_sch){
     assert(pg_init("test.db") == PAGER_SUCCESS);
@@ -34,7 +36,105 @@ DEFINE_TEST(delete_field){
     pg_delete();
 }
 
+DEFINE_TEST(descriptor_version){
+    assert(pg_init("test.db") == PAGER_SUCCESS);
+    schema_t* schema = sch_init();
+    sch_add_int_field(schema, "CREDIT");
+    sch_add_float_field(schema, "DEBIT");
+    int64_t schidx = schema_index(schema);
+    sch_desc_t* desc = sch_desc_load(schidx);
+    assert(desc != NULL && desc->count == 2);
+    assert(sch_desc_load(schidx) == desc);
+    assert(sch_desc_field(desc, "DEBIT")->type == DT_FLOAT);
+    assert(sch_desc_field(desc, "STUDENT") == NULL);
+
+    sch_add_bool_field(schema, "STUDENT");
+    desc = sch_desc_load(schidx);
+    assert(desc->count == 3 && desc->slot_size == sch_load(schidx)->slot_size);
+    field_t* student = sch_desc_field(desc, "STUDENT");
+    assert(student != NULL && student->type == DT_BOOL);
+
+    sch_delete_field(sch_load(schidx), "CREDIT");
+    desc = sch_desc_load(schidx);
+    assert(desc->count == 2);
+    assert(sch_desc_field(desc, "CREDIT") == NULL);
+    sch_desc_clear();
+    pg_delete();
+}
+
+DEFINE_TEST(descriptor_saved_version){
+    db_init("test.db");
+    schema_t* schema = sch_init();
+    sch_add_int_field(schema, "CREDIT");
+    int64_t schidx = schema_index(schema);
+    int64_t version = schema->version;
+    assert(sch_desc_load(schidx) != NULL);
+    db_close();
+
+    /* Versions continue after the last one saved in the reopened file */
+    db_t* db = db_init("test.db");
+    assert(db->schema_version >= version);
+    schema = sch_init();
+    assert(schema->version > version);
+
+    /* Changes of schemas do not write the db header until it is closed */
+    assert(db->schema_version < schema->version);
+
+    /* Descriptor of deleted schema is not found for a schema on its index */
+    schidx = schema_index(schema);
+    sch_add_int_field(schema, "CREDIT");
+    assert(sch_desc_load(schidx) != NULL);
+    assert(sch_delete(schidx) == SCHEMA_SUCCESS);
+    schema = sch_init();
+    sch_add_bool_field(schema, "STUDENT");
+    sch_desc_t* desc = sch_desc_load(schema_index(schema));
+    assert(desc != NULL && desc->count == 1);
+    assert(sch_desc_field(desc, "CREDIT") == NULL && sch_desc_field(desc, "STUDENT") != NULL);
+    db_drop();
+}
+
+DEFINE_TEST(optimize_layout){
+    assert(pg_init("test.db") == PAGER_SUCCESS);
+    schema_t* schema = sch_init();
+    sch_add_bool_field(schema, "STUDENT");
+    sch_add_char_field(schema, "CODE", 3);
+    sch_add_int_field(schema, "CREDIT");
+    sch_add_varchar_field(schema, "NAME");
+    sch_add_dict_varchar_field(schema, "CITY");
+    sch_add_float_field(schema, "DEBIT");
+    int64_t schidx = schema_index(schema);
+    assert(sch_optimize_layout(schema) == SCHEMA_SUCCESS);
+
+    const char* order[] = {"STUDENT", "CODE", "CREDIT", "NAME", "CITY", "DEBIT"};
+    int64_t i = 0;
+    int64_t end = 0;
+    sch_for_each(sch_load(schidx), chunk, field, chblix, schidx){
+        assert(strcmp(field.name, order[i++]) == 0);
+        end = (int64_t)(field.offset + field.size) > end ? (int64_t)(field.offset + field.size) : end;
+    }
+    assert(i == 6);
+    field_t credit, debit, name, city, student, code;
+    sch_get_field(sch_load(schidx), "CREDIT", &credit);
+    sch_get_field(sch_load(schidx), "DEBIT", &debit);
+    sch_get_field(sch_load(schidx), "NAME", &name);
+    sch_get_field(sch_load(schidx), "CITY", &city);
+    sch_get_field(sch_load(schidx), "STUDENT", &student);
+    sch_get_field(sch_load(schidx), "CODE", &code);
+    assert(credit.offset == 0 && debit.offset == 8);
+    assert(city.offset == 16 && student.offset == 20);
+    assert(name.offset % 8 == 0 && name.offset > student.offset);
+    assert(code.offset > name.offset);
+    /* Rows are padded so that the next row in a page starts aligned */
+    assert(sch_load(schidx)->slot_size == sch_row_align(end));
+    assert(sch_load(schidx)->slot_size % SCH_ROW_ALIGN == 0);
+    sch_desc_clear();
+    pg_delete();
+}
+
 int main(){
     RUN_SINGLE_TEST(create_add_foreach_sch);
     RUN_SINGLE_TEST(delete_field);
+    RUN_SINGLE_TEST(descriptor_version);
+    RUN_SINGLE_TEST(descriptor_saved_version);
+    RUN_SINGLE_TEST(optimize_layout);
 }
\ No newline at end of file
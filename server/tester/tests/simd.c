@@ -0,0 +1,92 @@
+#include "../src/test.h"
+#include "utils/simd.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIMD_TEST_SIZE 1003
+
+static void check_i64(const int64_t* data, int64_t n, int64_t value){
+    int64_t first = SIMD_NOT_FOUND;
+    int64_t count = 0;
+    for(int64_t i = n - 1; i >= 0; i--){
+        if(data[i] == value){
+            first = i;
+            count++;
+        }
+    }
+    assert(simd_find_first_i64(data, n, value) == first);
+    assert(simd_count_eq_i64(data, n, value) == count);
+
+    uint64_t mask[simd_mask_words(SIMD_TEST_SIZE)];
+    for(simd_op_t op = SIMD_EQ; op <= SIMD_GE; op++){
+        simd_cmp_mask_i64(data, n, value, op, mask);
+        for(int64_t i = 0; i < n; i++){
+            bool expected = op == SIMD_EQ ? data[i] == value :
+                            op == SIMD_NE ? data[i] != value :
+                            op == SIMD_LT ? data[i] < value :
+                            op == SIMD_LE ? data[i] <= value :
+                            op == SIMD_GT ? data[i] > value : data[i] >= value;
+            assert(simd_mask_test(mask, i) == expected);
+        }
+    }
+}
+
+static void check_f64(const double* data, int64_t n, double value){
+    int64_t first = SIMD_NOT_FOUND;
+    int64_t count = 0;
+    for(int64_t i = n - 1; i >= 0; i--){
+        if(data[i] == value){
+            first = i;
+            count++;
+        }
+    }
+    assert(simd_find_first_f64(data, n, value) == first);
+    assert(simd_count_eq_f64(data, n, value) == count);
+
+    uint64_t mask[simd_mask_words(SIMD_TEST_SIZE)];
+    for(simd_op_t op = SIMD_EQ; op <= SIMD_GE; op++){
+        simd_cmp_mask_f64(data, n, value, op, mask);
+        for(int64_t i = 0; i < n; i++){
+            bool expected = op == SIMD_EQ ? data[i] == value :
+                            op == SIMD_NE ? data[i] != value :
+                            op == SIMD_LT ? data[i] < value :
+                            op == SIMD_LE ? data[i] <= value :
+                            op == SIMD_GT ? data[i] > value : data[i] >= value;
+            assert(simd_mask_test(mask, i) == expected);
+        }
+    }
+}
+
+DEFINE_TEST(levels_agree_with_scalar){
+    int64_t ints[SIMD_TEST_SIZE];
+    double doubles[SIMD_TEST_SIZE];
+    srand(7);
+    for(int64_t i = 0; i < SIMD_TEST_SIZE; i++){
+        ints[i] = (rand() % 21) - 10;
+        doubles[i] = (double)((rand() % 21) - 10) / 2;
+    }
+    ints[5] = INT64_MIN;
+    ints[6] = INT64_MAX;
+    doubles[7] = NAN;
+    for(simd_level_t level = SIMD_SCALAR; level <= SIMD_AVX2; level++){
+        if(simd_set_level(level) != level){
+            continue;
+        }
+        for(int64_t n = 0; n <= SIMD_TEST_SIZE; n += 59){
+            check_i64(ints, n, 3);
+            check_i64(ints, n, INT64_MIN);
+            check_i64(ints, n, 100);
+            check_f64(doubles, n, 1.5);
+            check_f64(doubles, n, NAN);
+        }
+        check_i64(ints, SIMD_TEST_SIZE, -4);
+        check_f64(doubles, SIMD_TEST_SIZE, -2.0);
+    }
+}
+
+int main(){
+    RUN_SINGLE_TEST(levels_agree_with_scalar);
+    return 0;
+}
@@ -2,6 +2,11 @@
 #include "core/io/pager.h"
 #include "backend/table/schema.h"
 #include "backend/table/table.h"
+#include "backend/table/operator.h"
+#include "backend/comparator/jit.h"
+#include "backend/connection/ast.h"
+#include "backend/connection/query_execute/queries/queries_include.h"
+#include "backend/connection/query_execute/queries/subqueries/subqueries_include.h"
 #ifdef LOGGER_LEVEL
 #undef LOGGER_LEVEL
 #endif
@@ -170,6 +175,84 @@ DEFINE_TEST(get_table_after_close){
     db_drop();
 }
 
+DEFINE_TEST(metatable_index){
+    db_t* db = db_init("test.db");
+    table_t* students = table_student(db, 1);
+    table_t* temps[200];
+    for(int i = 0; i < 200; i++){
+        temps[i] = tab_init(db, "TEMP", init_schema());
+    }
+    assert(mtab_find_table_by_name(db->meta_table_idx, "TEMP") == table_index(temps[0]));
+    assert(mtab_find_table_by_name(db->meta_table_idx, "STUDENTS") == table_index(students));
+    assert(mtab_find_table_by_name(db->meta_table_idx, "NOBODY") == TABLE_FAIL);
+
+    assert(tab_drop(db, temps[0]) == PPL_SUCCESS);
+    assert(mtab_find_table_by_name(db->meta_table_idx, "TEMP") == table_index(temps[1]));
+    for(int i = 1; i < 200; i++){
+        assert(tab_drop(db, temps[i]) == PPL_SUCCESS);
+    }
+    assert(mtab_find_table_by_name(db->meta_table_idx, "TEMP") == TABLE_FAIL);
+    int64_t tabix = table_index(tab_init(db, "TEMP", init_schema()));
+
+    db_close();
+    db = db_init("test.db");
+    assert(mtab_find_table_by_name(db->meta_table_idx, "TEMP") == tabix);
+    assert(mtab_find_table_by_name(db->meta_table_idx, "STUDENTS") != TABLE_FAIL);
+    assert(mtab_find_table_by_name(db->meta_table_idx, "METATABLE") == db->meta_table_idx);
+    db_drop();
+}
+
+DEFINE_TEST(temp_space){
+    db_t* db = db_init("test.db");
+    table_t* students = table_student(db, 1);
+    int64_t students_idx = table_index(students);
+    schema_t* schema = sch_load(students->schidx);
+    field_t field;
+    sch_get_field(schema, "ID", &field);
+    int64_t max_page = pg_max_page_index();
+
+    int space = pg_use_space(PG_TEMP);
+    int64_t id = 2;
+    table_t* result = tab_select_op(db, students, schema, &field, "TEMP", COND_GT, &id, DT_INT);
+    assert(result != NULL && pg_is_temp(table_index(result)));
+    assert(pg_is_temp(result->schidx));
+    assert(mtab_find_table_by_name(db->meta_table_idx, "TEMP") == TABLE_FAIL);
+    int64_t count = 0;
+    void* row = malloc(schema->slot_size);
+    tab_for_each_row(result, chunk, chblix, row, sch_load(result->schidx)){
+        count++;
+    }
+    assert(count == 2);
+    assert(pg_max_page_index() == max_page);
+
+    /* Growth of main table stays in main space */
+    void* copy = malloc(schema->slot_size);
+    tab_for_each_row(students, chunk1, chblix1, copy, schema){
+        break;
+    }
+    for(int i = 0; i < 2000; i++){
+        chblix_t rowix = tab_insert(students, schema, copy);
+        assert(chblix_cmp(&rowix, &CHBLIX_FAIL) != 0 && !pg_is_temp(rowix.chunk_idx));
+    }
+    free(copy);
+    pg_use_space(space);
+    assert(tab_drop(db, result) == PPL_SUCCESS);
+    assert(pg_temp_reset() == PAGER_SUCCESS);
+
+    students = tab_load(students_idx);
+    count = 0;
+    tab_for_each_row(students, chunk2, chblix2, row, schema){
+        count++;
+    }
+    assert(count == 2004);
+    db_close();
+    db = db_init("test.db");
+    int64_t tabix = mtab_find_table_by_name(db->meta_table_idx, "STUDENTS");
+    assert(tabix == students_idx && !pg_is_temp(tabix));
+    free(row);
+    db_drop();
+}
+
 DEFINE_TEST(varchar){
     db_t* db = db_init("test.db");
 
@@ -206,6 +289,213 @@ DEFINE_TEST(varchar){
     db_drop();
 }
 
+DEFINE_TEST(inline_varchar){
+    db_t* db = db_init("test.db");
+
+    char* long_city = "Llanfairpwllgwyngyllgogerychwyrndrobwllllantysiliogogogoch";
+    schema_t* schema = sch_init();
+    sch_add_varchar_field(schema, "NAME");
+    sch_add_varchar_field_inline(schema, "CITY", 32);
+    table_t* table = tab_init(db, "test", schema);
+
+    field_t name_field;
+    field_t city_field;
+    sch_get_field(schema, "NAME", &name_field);
+    sch_get_field(schema, "CITY", &city_field);
+    assert(name_field.size == sizeof(vch_ticket_t));
+    assert(vch_inline_capacity(city_field.size) == 32);
+
+    char* row = malloc(schema->slot_size);
+    assert(vch_put(db->varchar_mgr_idx, "Alex", (vch_ticket_t*)(row + name_field.offset), (int64_t)name_field.size) == LB_SUCCESS);
+    assert(vch_put(db->varchar_mgr_idx, "Saint Petersburg", (vch_ticket_t*)(row + city_field.offset), (int64_t)city_field.size) == LB_SUCCESS);
+    tab_insert(table, schema, row);
+    assert(vch_put(db->varchar_mgr_idx, "Alexander the Great of Macedonia", (vch_ticket_t*)(row + name_field.offset), (int64_t)name_field.size) == LB_SUCCESS);
+    assert(vch_put(db->varchar_mgr_idx, long_city, (vch_ticket_t*)(row + city_field.offset), (int64_t)city_field.size) == LB_SUCCESS);
+    tab_insert(table, schema, row);
+
+    int64_t count = 0;
+    tab_for_each_row(table, chunk, chblix, row, schema){
+        vch_ticket_t* name = (vch_ticket_t*)(row + name_field.offset);
+        vch_ticket_t* city = (vch_ticket_t*)(row + city_field.offset);
+        char* name_str = vch_acquire(db->varchar_mgr_idx, name);
+        char* city_str = vch_acquire(db->varchar_mgr_idx, city);
+        if(count == 0){
+            assert(vch_is_inline(name) && vch_is_inline(city));
+            assert(!strcmp(name_str, "Alex"));
+            assert(!strcmp(city_str, "Saint Petersburg"));
+        } else {
+            assert(!vch_is_inline(name) && !vch_is_inline(city));
+            assert(!strcmp(name_str, "Alexander the Great of Macedonia"));
+            assert(!strcmp(city_str, long_city));
+        }
+        vch_release(name, name_str);
+        vch_release(city, city_str);
+        count++;
+    }
+    assert(count == 2);
+    free(row);
+
+    /* CREATE gives string column the inline capacity of its definition */
+    struct ast* root = newcreate(strdup("CREATED"), newlist(newcreate_pair(strdup("CITY"), NT_STRING, 64), NULL));
+    struct response* resp = create_response();
+    assert(create_exec(&(default_query_args_t) {.db = db, .root = root, .resp = resp}) == 0);
+    table = tab_load(mtab_find_table_by_name(db->meta_table_idx, "CREATED"));
+    schema = sch_load(table->schidx);
+    sch_get_field(schema, "CITY", &city_field);
+    assert(vch_inline_capacity(city_field.size) == 64);
+    free(resp->message);
+    free_ast(root);
+    root = newcreate(strdup("INVALID"), newlist(newcreate_pair(strdup("ID"), NT_INTEGER, 8), NULL));
+    assert(create_exec(&(default_query_args_t) {.db = db, .root = root, .resp = resp}) == -1);
+    assert(mtab_find_table_by_name(db->meta_table_idx, "INVALID") == TABLE_FAIL);
+    free(resp->message);
+    free(resp);
+    free_ast(root);
+    db_drop();
+}
+
+static void fill_names(db_t* db, table_t* table, schema_t* schema, int64_t count, char letter){
+    field_t id_field;
+    field_t name_field;
+    sch_get_field(schema, "ID", &id_field);
+    sch_get_field(schema, "NAME", &name_field);
+    char* row = malloc(schema->slot_size);
+    char name[101];
+    memset(name, letter, 100);
+    name[100] = '\0';
+    for(int64_t i = 0; i < count; i++){
+        memcpy(row + id_field.offset, &i, sizeof(int64_t));
+        assert(sch_put_varchar(db->varchar_mgr_idx, &name_field, name, row + name_field.offset) == SCHEMA_SUCCESS);
+        tab_insert(table, schema, row);
+    }
+    free(row);
+}
+
+DEFINE_TEST(varchar_reclaim){
+    db_t* db = db_init("test.db");
+    schema_t* schema = sch_init();
+    sch_add_int_field(schema, "ID");
+    sch_add_varchar_field(schema, "NAME");
+    table_t* table = tab_init(db, "test", schema);
+    field_t id_field;
+    field_t name_field;
+    sch_get_field(schema, "ID", &id_field);
+    sch_get_field(schema, "NAME", &name_field);
+    fill_names(db, table, schema, 200, 'a');
+
+    /* Result table shares tickets, dropping it keeps source strings */
+    int64_t zero = 0;
+    table_t* result = tab_select_op(db, table, schema, &id_field, "TEMP", COND_GTE, &zero, DT_INT);
+    assert(result != NULL && result->vchmgr_idx == TAB_SHARED_VARCHARS);
+    tab_drop(db, result);
+    char* row = malloc(schema->slot_size);
+    tab_for_each_row(table, chunk, chblix, row, schema){
+        char* name = vch_acquire(db->varchar_mgr_idx, (vch_ticket_t*)(row + name_field.offset));
+        assert(name != NULL && name[0] == 'a' && strlen(name) == 100);
+        vch_release((vch_ticket_t*)(row + name_field.offset), name);
+    }
+
+    /* Deleted and overwritten strings are reused */
+    int64_t max_page = 0;
+    for(int round = 0; round < 5; round++){
+        int64_t limit = 200;
+        assert(tab_delete_op(db, table, schema, &id_field, COND_LT, &limit) == TABLE_SUCCESS);
+        fill_names(db, table, schema, 200, (char)('b' + round));
+        vch_ticket_t* slot = malloc(name_field.size);
+        tab_for_each_row(table, chunk2, chblix2, row, schema){
+            assert(vch_put(db->varchar_mgr_idx, "some other long name that does not fit inline", slot,
+                           (int64_t) name_field.size) == LB_SUCCESS);
+            assert(tab_update_field(table, schema, &chblix2, &name_field, slot) == TABLE_SUCCESS);
+        }
+        free(slot);
+        if(round == 0){
+            max_page = pg_max_page_index();
+        }
+        assert(pg_max_page_index() == max_page);
+    }
+
+    /* Dropped table frees its strings */
+    tab_drop(db, table);
+    schema = sch_init();
+    sch_add_int_field(schema, "ID");
+    sch_add_varchar_field(schema, "NAME");
+    table = tab_init(db, "test", schema);
+    fill_names(db, table, schema, 200, 'z');
+    assert(pg_max_page_index() == max_page);
+    free(row);
+    db_drop();
+}
+
+DEFINE_TEST(alter_columns){
+    db_t* db = db_init("test.db");
+    schema_t* schema = sch_init();
+    sch_add_int_field(schema, "ID");
+    sch_add_varchar_field(schema, "NAME");
+    table_t* table = tab_init(db, "test", schema);
+    fill_names(db, table, schema, 50, 'a');
+
+    /* Adding columns does not touch rows */
+    int64_t max_page = pg_max_page_index();
+    assert(tab_add_column(table, "AGE", DT_INT, sizeof(int64_t)) == TABLE_SUCCESS);
+    assert(tab_add_column(table, "CITY", DT_VARCHAR, vch_slot_size(VCH_DEFAULT_INLINE_SIZE)) == TABLE_SUCCESS);
+    assert(tab_add_column(table, "AGE", DT_INT, sizeof(int64_t)) == TABLE_FAIL);
+    assert(pg_max_page_index() == max_page);
+
+    field_t id_field;
+    field_t age_field;
+    field_t city_field;
+    sch_get_field(schema, "ID", &id_field);
+    sch_get_field(schema, "AGE", &age_field);
+    sch_get_field(schema, "CITY", &city_field);
+    char* row = malloc(schema->slot_size);
+    vch_ticket_t* city = malloc(city_field.size);
+    assert(vch_put(db->varchar_mgr_idx, "Kazan", city, (int64_t) city_field.size) == LB_SUCCESS);
+    tab_for_each_row(table, chunk, chblix, row, schema){
+        int64_t id = *(int64_t*)(row + id_field.offset);
+        assert(*(int64_t*)(row + age_field.offset) == 0);
+        assert(vch_is_inline((vch_ticket_t*)(row + city_field.offset)));
+        assert(!strcmp(vch_inline_str((vch_ticket_t*)(row + city_field.offset)), ""));
+        /* Rows take the new layout when they are written */
+        if(id % 2 == 0){
+            assert(tab_update_field(table, schema, &chblix, &age_field, &id) == TABLE_SUCCESS);
+        }
+        if(id % 3 == 0){
+            assert(tab_update_field(table, schema, &chblix, &city_field, city) == TABLE_SUCCESS);
+        }
+    }
+    int64_t new_id = 50;
+    field_t name_field;
+    sch_get_field(schema, "NAME", &name_field);
+    assert(sch_put_varchar(db->varchar_mgr_idx, &name_field, "Ivan", row + name_field.offset) == SCHEMA_SUCCESS);
+    memcpy(row + id_field.offset, &new_id, sizeof(int64_t));
+    memcpy(row + age_field.offset, &new_id, sizeof(int64_t));
+    memcpy(row + city_field.offset, city, city_field.size);
+    tab_insert(table, schema, row);
+
+    /* Dropped column keeps its bytes, the new one with the same name is empty */
+    assert(tab_drop_column(table, "NAME") == TABLE_SUCCESS);
+    assert(tab_drop_column(table, "NAME") == TABLE_FAIL);
+    assert(tab_add_column(table, "NAME", DT_VARCHAR, vch_slot_size(VCH_DEFAULT_INLINE_SIZE)) == TABLE_SUCCESS);
+    sch_get_field(schema, "NAME", &name_field);
+    free(row);
+    row = malloc(schema->slot_size);
+    int64_t count = 0;
+    tab_for_each_row(table, chunk2, chblix2, row, schema){
+        int64_t id = *(int64_t*)(row + id_field.offset);
+        int64_t age = *(int64_t*)(row + age_field.offset);
+        assert(age == (id % 2 == 0 || id == 50 ? id : 0));
+        char* city_str = vch_acquire(db->varchar_mgr_idx, (vch_ticket_t*)(row + city_field.offset));
+        assert(!strcmp(city_str, id % 3 == 0 || id == 50 ? "Kazan" : ""));
+        vch_release((vch_ticket_t*)(row + city_field.offset), city_str);
+        assert(!strcmp(vch_inline_str((vch_ticket_t*)(row + name_field.offset)), ""));
+        count++;
+    }
+    assert(count == 51);
+    free(city);
+    free(row);
+    db_drop();
+}
+
 DEFINE_TEST(several_tables){
     db_t* db = db_init("test.db");
 
@@ -267,6 +557,1310 @@ DEFINE_TEST(join){
                                              &right_field, "JOIN");
     assert(join_tablix != NULL);
     tab_print(db, join_tablix, sch_load(join_tablix->schidx));
+
+    /* Right row starts aligned after the left row of 37 bytes */
+    schema_t* join_schema = sch_load(join_tablix->schidx);
+    field_t id_field;
+    assert(sch_get_field(join_schema, "ID", &id_field) == SCHEMA_SUCCESS);
+    assert(id_field.offset == 40 && (int64_t) id_field.offset == sch_join_offset(left_schema));
+    assert(join_schema->slot_size >= (int64_t) id_field.offset + right_schema->slot_size);
+    const char* names[] = {"John", "Nick", "Alex"};
+    int64_t count = 0;
+    char* row = malloc(join_schema->slot_size);
+    tab_for_each_row(join_tablix, chunk, chblix, row, join_schema){
+        int64_t id;
+        memcpy(&id, row + id_field.offset, sizeof(id));
+        assert(id >= 1 && id <= 3 && strcmp(row + left_field.offset, names[id - 1]) == 0);
+        assert(strcmp(row + id_field.offset + right_field.offset, names[id - 1]) == 0);
+        count++;
+    }
+    assert(count == 3);
+    free(row);
+    db_drop();
+}
+
+static table_t* table_keys(db_t* db, const char* name, int64_t count, int64_t modulo){
+    schema_t* schema = sch_init();
+    sch_add_int_field(schema, "ID");
+    sch_add_varchar_field(schema, "NAME");
+    table_t* table = tab_init(db, name, schema);
+    field_t id_field;
+    field_t name_field;
+    sch_get_field(schema, "ID", &id_field);
+    sch_get_field(schema, "NAME", &name_field);
+    char* row = malloc(schema->slot_size);
+    char str[64];
+    for(int64_t i = 0; i < count; i++){
+        int64_t id = i % modulo;
+        snprintf(str, sizeof(str), "a rather long name number %ld", id % 7);
+        memcpy(row + id_field.offset, &id, sizeof(int64_t));
+        assert(sch_put_varchar(db->varchar_mgr_idx, &name_field, str, row + name_field.offset) == SCHEMA_SUCCESS);
+        tab_insert(table, schema, row);
+    }
+    free(row);
+    return table;
+}
+
+static int64_t join_checksum(row_likedlist_t* list, int64_t left_id, int64_t right_id){
+    int64_t sum = 0;
+    for(row_node_t* node = list->head; node != NULL; node = node->next){
+        int64_t left;
+        int64_t right;
+        memcpy(&left, node->row + left_id, sizeof(int64_t));
+        memcpy(&right, node->row + right_id, sizeof(int64_t));
+        sum += left * 1000 + right;
+    }
+    return sum;
+}
+
+/* Check that lists hold the same rows in any order */
+static void check_same_rows(row_likedlist_t* list, row_likedlist_t* expected, int64_t left_id, int64_t right_id){
+    assert(list != NULL && expected != NULL);
+    assert(list->size == expected->size);
+    assert(join_checksum(list, left_id, right_id) == join_checksum(expected, left_id, right_id));
+}
+
+/* Check that lists hold the same rows in the same order */
+static void check_same_order(row_likedlist_t* list, row_likedlist_t* expected, int64_t left_id, int64_t right_id){
+    assert(list != NULL && expected != NULL && list->size == expected->size);
+    for(row_node_t *node = list->head, *other = expected->head; node != NULL; node = node->next, other = other->next){
+        assert(memcmp(node->row + left_id, other->row + left_id, sizeof(int64_t)) == 0);
+        assert(memcmp(node->row + right_id, other->row + right_id, sizeof(int64_t)) == 0);
+    }
+}
+
+DEFINE_TEST(hash_join){
+    db_t* db = db_init("test.db");
+    table_t* big = table_keys(db, "BIG", 300, 50);
+    table_t* small = table_keys(db, "SMALL", 40, 40);
+    schema_t* schema = sch_load(big->schidx);
+    field_t id_field;
+    field_t name_field;
+    sch_get_field(schema, "ID", &id_field);
+    sch_get_field(schema, "NAME", &name_field);
+    field_t* fields[] = {&id_field, &name_field};
+
+    for(int f = 0; f < 2; f++){
+        for(int swap = 0; swap < 2; swap++){
+            row_likedlist_t* left = tab_table2rll(db, swap ? small : big);
+            row_likedlist_t* right = tab_table2rll(db, swap ? big : small);
+            row_likedlist_t* nested = rll_filter_var(db, right, fields[f], COND_EQ, left, fields[f], fields[f]->type);
+            row_likedlist_t* hashed = rll_hash_join(db, right, fields[f], left, fields[f]);
+            int64_t right_id = sch_join_offset(schema) + id_field.offset;
+            check_same_rows(hashed, nested, id_field.offset, right_id);
+            assert(hashed->size > 0);
+            row_likedlist_free(nested);
+            row_likedlist_free(hashed);
+            row_likedlist_free(left);
+            row_likedlist_free(right);
+        }
+    }
+    db_drop();
+}
+
+DEFINE_TEST(merge_join){
+    db_t* db = db_init("test.db");
+    table_t* big = table_keys(db, "BIG", 200, 50);
+    table_t* small = table_keys(db, "SMALL", 40, 40);
+    schema_t* schema = sch_load(big->schidx);
+    field_t id_field;
+    field_t name_field;
+    sch_get_field(schema, "ID", &id_field);
+    sch_get_field(schema, "NAME", &name_field);
+    field_t* fields[] = {&id_field, &name_field};
+    condition_t conditions[] = {COND_LT, COND_LTE, COND_GT, COND_GTE};
+
+    row_likedlist_t* left = tab_table2rll(db, big);
+    row_likedlist_t* right = tab_table2rll(db, small);
+    int64_t right_id = sch_join_offset(schema) + id_field.offset;
+    for(int f = 0; f < 2; f++){
+        for(int c = 0; c < 4; c++){
+            row_likedlist_t* nested = rll_filter_var(db, right, fields[f], conditions[c], left, fields[f], fields[f]->type);
+            row_likedlist_t* merged = rll_merge_join(db, right, fields[f], conditions[c], left, fields[f]);
+            check_same_rows(merged, nested, id_field.offset, right_id);
+            assert(merged->size > 0);
+            row_likedlist_free(nested);
+            row_likedlist_free(merged);
+        }
+    }
+    assert(rll_merge_join(db, right, &id_field, COND_EQ, left, &id_field) == NULL);
+    row_likedlist_free(left);
+    row_likedlist_free(right);
+    db_drop();
+}
+
+static void check_index_filter(db_t* db, table_t* table, field_t* field, void* value, int64_t id_offset){
+    condition_t conditions[] = {COND_EQ, COND_LT, COND_LTE, COND_GT, COND_GTE};
+    schema_t* schema = sch_load(table->schidx);
+    row_likedlist_t* all = tab_table2rll(db, table);
+    for(int c = 0; c < 5; c++){
+        row_likedlist_t* indexed = tab_filter(db, table, schema, field, conditions[c], value, field->type);
+        row_likedlist_t* scanned = rll_filter(db, all, field, conditions[c], value, field->type);
+        check_same_rows(indexed, scanned, id_offset, id_offset);
+        row_likedlist_free(indexed);
+        row_likedlist_free(scanned);
+    }
+    row_likedlist_free(all);
+}
+
+DEFINE_TEST(btree_index){
+    db_t* db = db_init("test.db");
+    table_t* table = table_keys(db, "KEYS", 3000, 500);
+    int64_t tablix = table_index(table);
+    assert(tab_create_index(table, "ID", IDX_BTREE) == TABLE_SUCCESS);
+    assert(tab_create_index(table, "NAME", IDX_BTREE) == TABLE_SUCCESS);
+    assert(tab_create_index(table, "ID", IDX_HASH) == TABLE_FAIL);
+    table = tab_load(tablix);
+    schema_t* schema = sch_load(table->schidx);
+    field_t id_field;
+    field_t name_field;
+    sch_get_field(schema, "ID", &id_field);
+    sch_get_field(schema, "NAME", &name_field);
+    assert(sch_is_indexed_field(&id_field) && sch_is_indexed_field(&name_field));
+    assert(bt_size(id_field.index) == 3000 && bt_size(name_field.index) == 3000);
+
+    int64_t id = 250;
+    check_index_filter(db, table, &id_field, &id, id_field.offset);
+    chblix_t rowix = tab_get_row(db, table, schema, &id_field, &id, DT_INT);
+    assert(chblix_cmp(&rowix, &CHBLIX_FAIL) != 0);
+    char* row = malloc(schema->slot_size);
+    assert(tab_select_row(tablix, &rowix, row) == TABLE_SUCCESS);
+    vch_ticket_t name;
+    memcpy(&name, row + name_field.offset, sizeof(vch_ticket_t));
+    check_index_filter(db, table, &name_field, &name, id_field.offset);
+
+    /* Maintenance on update, delete and insert */
+    int64_t moved = 1000;
+    assert(tab_update_element(table, &rowix, &id_field, &moved) == TABLE_SUCCESS);
+    check_index_filter(db, table, &id_field, &moved, id_field.offset);
+    check_index_filter(db, table, &id_field, &id, id_field.offset);
+    assert(tab_delete_op(db, table, schema, &id_field, COND_LT, &id) != TABLE_FAIL);
+    assert(bt_size(id_field.index) == 1500 && bt_size(name_field.index) == 1500);
+    check_index_filter(db, table, &id_field, &id, id_field.offset);
+    check_index_filter(db, table, &name_field, &name, id_field.offset);
+    id = 42;
+    memcpy(row + id_field.offset, &id, sizeof(int64_t));
+    tab_insert(table, schema, row);
+    check_index_filter(db, table, &id_field, &id, id_field.offset);
+    free(row);
+
+    db_close();
+    db = db_init("test.db");
+    table = tab_load(tablix);
+    schema = sch_load(table->schidx);
+    sch_get_field(schema, "ID", &id_field);
+    assert(sch_is_indexed_field(&id_field) && bt_size(id_field.index) == 1501);
+    check_index_filter(db, table, &id_field, &id, id_field.offset);
+    assert(tab_drop(db, table) == PPL_SUCCESS);
+    db_drop();
+}
+
+DEFINE_TEST(inline_varchar_index){
+    db_t* db = db_init("test.db");
+    const char* cities[] = {"Omsk", "Saint Petersburg on Neva River", "Nizhny Novgorod Oblast, Russia",
+                            "Llanfairpwllgwyngyllgogerychwyrndrobwllllantysiliogogogoch"};
+    index_kind_t kinds[] = {IDX_BTREE, IDX_HASH};
+    for(int k = 0; k < 2; k++){
+        schema_t* schema = sch_init();
+        sch_add_int_field(schema, "ID");
+        sch_add_varchar_field_inline(schema, "CITY", 32);
+        table_t* table = tab_init(db, k ? "HASHED" : "SORTED", schema);
+        int64_t tablix = table_index(table);
+        field_t id_field;
+        field_t city_field;
+        sch_get_field(schema, "ID", &id_field);
+        sch_get_field(schema, "CITY", &city_field);
+        char* row = calloc(1, schema->slot_size);
+        for(int64_t id = 0; id < 200; id++){
+            memcpy(row + id_field.offset, &id, sizeof(int64_t));
+            assert(sch_put_varchar(db->varchar_mgr_idx, &city_field, cities[id % 4], row + city_field.offset) == SCHEMA_SUCCESS);
+            tab_insert(table, schema, row);
+        }
+        assert(tab_create_index(table, "CITY", kinds[k]) == TABLE_SUCCESS);
+        table = tab_load(tablix);
+        sch_get_field(sch_load(table->schidx), "CITY", &city_field);
+
+        /* Whole slot keeps inline strings longer than a bare ticket holds */
+        assert(VCH_TICKET_HEADER + (int64_t) strlen(cities[1]) >= (int64_t) sizeof(vch_ticket_t));
+        char* slot = malloc(city_field.size);
+        for(int c = 0; c < 4; c++){
+            assert(sch_put_varchar(db->varchar_mgr_idx, &city_field, cities[c], slot) == SCHEMA_SUCCESS);
+            assert(vch_is_inline((vch_ticket_t*) slot) == (c < 3));
+            check_index_filter(db, table, &city_field, slot, id_field.offset);
+            vch_ticket_t constant = vch_transient(cities[c]);
+            check_index_filter(db, table, &city_field, &constant, id_field.offset);
+            row_likedlist_t* found = tab_filter(db, table, sch_load(table->schidx), &city_field, COND_EQ, slot, DT_VARCHAR);
+            assert(found != NULL && found->size == 50);
+            row_likedlist_free(found);
+        }
+        free(slot);
+        free(row);
+    }
+    db_drop();
+}
+
+DEFINE_TEST(failed_index_insert){
+    db_t* db = db_init("test.db");
+    schema_t* schema = sch_init();
+    sch_add_int_field(schema, "ID");
+    sch_add_dict_varchar_field(schema, "CITY");
+    table_t* table = tab_init(db, "CITIES", schema);
+    int64_t tablix = table_index(table);
+    assert(tab_create_index(table, "ID", IDX_BTREE) == TABLE_SUCCESS);
+    assert(tab_create_index(table, "CITY", IDX_HASH) == TABLE_SUCCESS);
+    table = tab_load(tablix);
+    schema = sch_load(table->schidx);
+    field_t id_field;
+    field_t city_field;
+    sch_get_field(schema, "ID", &id_field);
+    sch_get_field(schema, "CITY", &city_field);
+
+    char* row = calloc(1, schema->slot_size);
+    for(int64_t id = 0; id < 10; id++){
+        memcpy(row + id_field.offset, &id, sizeof(int64_t));
+        assert(sch_put_varchar(db->varchar_mgr_idx, &city_field, id % 2 ? "Omsk" : "Tomsk", row + city_field.offset) == SCHEMA_SUCCESS);
+        chblix_t rowix = tab_insert(table, schema, row);
+        assert(chblix_cmp(&rowix, &CHBLIX_FAIL) != 0);
+    }
+
+    /* Code missing from the dictionary fails the second index after the first one took the row */
+    int64_t id = 42;
+    int32_t code = 1000;
+    memcpy(row + id_field.offset, &id, sizeof(int64_t));
+    memcpy(row + city_field.offset, &code, sizeof(int32_t));
+    chblix_t rowix = tab_insert(table, schema, row);
+    assert(chblix_cmp(&rowix, &CHBLIX_FAIL) == 0);
+    assert(bt_size(id_field.index) == 10 && idx_size(IDX_HASH, city_field.index) == 10);
+    rowix = tab_get_row(db, table, schema, &id_field, &id, DT_INT);
+    assert(chblix_cmp(&rowix, &CHBLIX_FAIL) == 0);
+    int64_t count = 0;
+    tab_for_each_row(table, chunk, chblix, row, schema){
+        count++;
+    }
+    assert(count == 10);
+    free(row);
+    db_drop();
+}
+
+DEFINE_TEST(hash_index){
+    db_t* db = db_init("test.db");
+    table_t* table = table_keys(db, "KEYS", 6000, 900);
+    table_t* dups = table_keys(db, "DUPS", 1000, 3);
+    table_t* outer = table_keys(db, "OUTER", 50, 1000);
+    int64_t tablix = table_index(table);
+    int64_t dupsix = table_index(dups);
+    assert(tab_create_index(table, "ID", IDX_HASH) == TABLE_SUCCESS);
+    assert(tab_create_index(table, "NAME", IDX_HASH) == TABLE_SUCCESS);
+    assert(tab_create_index(dups, "ID", IDX_HASH) == TABLE_SUCCESS);
+    table = tab_load(tablix);
+    dups = tab_load(dupsix);
+    schema_t* schema = sch_load(table->schidx);
+    field_t id_field;
+    field_t name_field;
+    sch_get_field(schema, "ID", &id_field);
+    sch_get_field(schema, "NAME", &name_field);
+    assert(id_field.index_kind == IDX_HASH && idx_size(IDX_HASH, id_field.index) == 6000);
+    assert(hx_load(id_field.index)->depth > 0);
+
+    /* Ranges are not answered by hash index and fall back to scan */
+    int64_t id = 450;
+    check_index_filter(db, table, &id_field, &id, id_field.offset);
+    chblix_t rowix = tab_get_row(db, table, schema, &id_field, &id, DT_INT);
+    assert(chblix_cmp(&rowix, &CHBLIX_FAIL) != 0);
+    char* row = malloc(schema->slot_size);
+    assert(tab_select_row(tablix, &rowix, row) == TABLE_SUCCESS);
+    vch_ticket_t name;
+    memcpy(&name, row + name_field.offset, sizeof(vch_ticket_t));
+    check_index_filter(db, table, &name_field, &name, id_field.offset);
+    field_t dups_field;
+    sch_get_field(sch_load(dups->schidx), "ID", &dups_field);
+    for(id = 0; id < 4; id++){
+        check_index_filter(db, dups, &dups_field, &id, dups_field.offset);
+    }
+
+    /* Index nested-loop join gives the same rows as hash join */
+    row_likedlist_t* left = tab_table2rll(db, outer);
+    row_likedlist_t* right = tab_table2rll(db, table);
+    int64_t right_id = sch_join_offset(sch_load(outer->schidx)) + id_field.offset;
+    for(int f = 0; f < 2; f++){
+        field_t* field = f == 0 ? &id_field : &name_field;
+        row_likedlist_t* hashed = rll_hash_join(db, right, field, left, field);
+        row_likedlist_t* indexed = tab_index_join(db, table, schema, field, left, field);
+        check_same_rows(indexed, hashed, id_field.offset, right_id);
+        assert(indexed->size > 0);
+        row_likedlist_free(hashed);
+        row_likedlist_free(indexed);
+    }
+    row_likedlist_free(left);
+    row_likedlist_free(right);
+
+    /* Maintenance on update, delete and insert */
+    id = 450;
+    int64_t moved = 5000;
+    assert(tab_update_element(table, &rowix, &id_field, &moved) == TABLE_SUCCESS);
+    check_index_filter(db, table, &id_field, &moved, id_field.offset);
+    check_index_filter(db, table, &id_field, &id, id_field.offset);
+    assert(tab_delete_op(db, table, schema, &id_field, COND_LT, &id) != TABLE_FAIL);
+    assert(idx_size(IDX_HASH, id_field.index) == 2850 && idx_size(IDX_HASH, name_field.index) == 2850);
+    check_index_filter(db, table, &name_field, &name, id_field.offset);
+    id = 7;
+    memcpy(row + id_field.offset, &id, sizeof(int64_t));
+    tab_insert(table, schema, row);
+    check_index_filter(db, table, &id_field, &id, id_field.offset);
+    free(row);
+
+    db_close();
+    db = db_init("test.db");
+    table = tab_load(tablix);
+    schema = sch_load(table->schidx);
+    sch_get_field(schema, "ID", &id_field);
+    assert(idx_size(IDX_HASH, id_field.index) == 2851);
+    check_index_filter(db, table, &id_field, &id, id_field.offset);
+    assert(tab_drop(db, table) == PPL_SUCCESS);
+    assert(tab_drop(db, tab_load(dupsix)) == PPL_SUCCESS);
+    db_drop();
+}
+
+static void check_cached_join(db_t* db, table_t* table, field_t* field, row_likedlist_t* left, int64_t id_offset){
+    row_likedlist_t* right = tab_table2rll(db, table);
+    int64_t right_id = sch_join_offset(left->schema) + id_offset;
+    row_likedlist_t* hashed = rll_hash_join(db, right, field, left, field);
+    row_likedlist_t* cached = tab_cached_join(db, table, sch_load(table->schidx), field, left, field);
+    check_same_rows(cached, hashed, id_offset, right_id);
+    assert(cached->size > 0);
+    row_likedlist_free(hashed);
+    row_likedlist_free(cached);
+    row_likedlist_free(right);
+}
+
+DEFINE_TEST(join_cache){
+    db_t* db = db_init("test.db");
+    table_t* big = table_keys(db, "BIG", 300, 50);
+    table_t* small = table_keys(db, "SMALL", 40, 40);
+    schema_t* schema = sch_load(big->schidx);
+    field_t id_field;
+    field_t name_field;
+    sch_get_field(schema, "ID", &id_field);
+    sch_get_field(schema, "NAME", &name_field);
+    row_likedlist_t* left = tab_table2rll(db, small);
+
+    assert(jc_memory() == 0);
+    check_cached_join(db, big, &id_field, left, id_field.offset);
+    int64_t memory = jc_memory();
+    assert(memory > 0);
+    check_cached_join(db, big, &id_field, left, id_field.offset);
+    assert(jc_memory() == memory);
+    check_cached_join(db, big, &name_field, left, id_field.offset);
+    assert(jc_memory() > memory);
+
+    /* Write of a column drops only its join index, inserted rows are added to all of them */
+    chblix_t rowix = tab_get_row(db, big, schema, &id_field, &(int64_t){7}, DT_INT);
+    int64_t id = 1000;
+    assert(tab_update_element(big, &rowix, &id_field, &id) == TABLE_SUCCESS);
+    assert(jc_memory() > 0 && jc_memory() < 2 * memory);
+    check_cached_join(db, big, &id_field, left, id_field.offset);
+    memory = jc_memory();
+    char* row = calloc(1, schema->slot_size);
+    for(id = 0; id < 40; id++){
+        memcpy(row + id_field.offset, &id, sizeof(int64_t));
+        assert(sch_put_varchar(db->varchar_mgr_idx, &name_field, "a rather long name number 3", row + name_field.offset) == SCHEMA_SUCCESS);
+        tab_insert(big, schema, row);
+    }
+    free(row);
+    assert(jc_memory() == memory);
+    check_cached_join(db, big, &id_field, left, id_field.offset);
+    check_cached_join(db, big, &name_field, left, id_field.offset);
+    assert(jc_memory() == memory);
+
+    /* Rows past twice the buckets grow the index */
+    row = calloc(1, schema->slot_size);
+    for(id = 0; id < 300; id++){
+        memcpy(row + id_field.offset, &id, sizeof(int64_t));
+        assert(sch_put_varchar(db->varchar_mgr_idx, &name_field, "a rather long name number 5", row + name_field.offset) == SCHEMA_SUCCESS);
+        tab_insert(big, schema, row);
+    }
+    free(row);
+    assert(jc_memory() > memory);
+    memory = jc_memory();
+    check_cached_join(db, big, &id_field, left, id_field.offset);
+    check_cached_join(db, big, &name_field, left, id_field.offset);
+    assert(jc_memory() == memory);
+
+    row_likedlist_free(left);
+    assert(tab_drop(db, big) == PPL_SUCCESS);
+    assert(jc_memory() == 0);
+    db_drop();
+}
+
+DEFINE_TEST(join_cache_budget){
+    db_t* db = db_init("test.db");
+    table_t* tables[] = {table_keys(db, "SMALL", 100, 100), table_keys(db, "MIDDLE", 200, 200),
+                         table_keys(db, "LARGE", 400, 400)};
+    field_t id_field;
+    sch_get_field(sch_load(tables[0]->schidx), "ID", &id_field);
+    row_likedlist_t* left = tab_table2rll(db, tables[0]);
+
+    /* Sizes of the join indexes of each table */
+    int64_t sizes[3];
+    for(int t = 0; t < 3; t++){
+        int64_t before = jc_memory();
+        check_cached_join(db, tables[t], &id_field, left, id_field.offset);
+        sizes[t] = jc_memory() - before;
+        assert(sizes[t] > 0);
+    }
+    assert(sizes[0] < sizes[1] && sizes[1] < sizes[2]);
+
+    /* Least recently used index is dropped to fit the budget */
+    jc_clear();
+    jc_set_budget(sizes[0] + sizes[2] + sizes[1] / 2);
+    check_cached_join(db, tables[0], &id_field, left, id_field.offset);
+    check_cached_join(db, tables[1], &id_field, left, id_field.offset);
+    check_cached_join(db, tables[0], &id_field, left, id_field.offset);
+    assert(jc_memory() == sizes[0] + sizes[1]);
+    check_cached_join(db, tables[2], &id_field, left, id_field.offset);
+    assert(jc_memory() == sizes[0] + sizes[2]);
+
+    /* Lower budget drops indexes at once, index larger than the budget is not built */
+    jc_set_budget(sizes[2]);
+    assert(jc_memory() <= sizes[2]);
+    jc_set_budget(sizes[1] - 1);
+    assert(jc_memory() == 0);
+    assert(jc_load(tables[1], &id_field) == NULL && jc_memory() == 0);
+    assert(jc_load(tables[0], &id_field) != NULL && jc_memory() == sizes[0]);
+
+    jc_set_budget(JC_MEMORY_BUDGET);
+    row_likedlist_free(left);
+    db_drop();
+}
+
+typedef struct scan_arg{
+    comp_pred_t pred;
+    int64_t offset;
+} scan_arg_t;
+
+static bool scan_matches(void* row, void* arg){
+    scan_arg_t* scan = arg;
+    return comp_pred_test(&scan->pred, (char*) row + scan->offset);
+}
+
+DEFINE_TEST(table_scan){
+    db_t* db = db_init("test.db");
+    table_t* table = table_keys(db, "KEYS", 300, 50);
+    schema_t* schema = sch_load(table->schidx);
+    field_t id_field;
+    sch_get_field(schema, "ID", &id_field);
+    row_likedlist_t* all = tab_table2rll(db, table);
+    assert(all != NULL && all->size == 300);
+
+    /* Scan with predicate keeps the same rows as filter of the whole table */
+    condition_t conditions[] = {COND_EQ, COND_NEQ, COND_LT, COND_GTE};
+    for(int c = 0; c < 4; c++){
+        int64_t id = 30;
+        scan_arg_t arg = {.offset = id_field.offset};
+        comp_pred_init(&arg.pred, db, &id_field, conditions[c], &id);
+        row_likedlist_t* scanned = tab_scan(db, table, scan_matches, &arg);
+        row_likedlist_t* filtered = rll_filter(db, all, &id_field, conditions[c], &id, DT_INT);
+        check_same_rows(scanned, filtered, id_field.offset, id_field.offset);
+        row_likedlist_free(scanned);
+        row_likedlist_free(filtered);
+    }
+
+    row_likedlist_free(all);
+    db_drop();
+}
+
+/* Condition on field of u with constant or with field of v, chain leans right */
+static struct ast* attr_condition(const char* attr, int cmp, struct ast* constant, int logic, struct ast* next){
+    return newfilter_condition(newfilter_expr(newattr_name(strdup("u"), strdup(attr)), constant, cmp), next, logic);
+}
+
+static struct ast* id_condition(int cmp, struct ast* constant, int logic, struct ast* next){
+    return attr_condition("ID", cmp, constant, logic, next);
+}
+
+static struct ast* scan_filter(int chain){
+    switch(chain){
+        case 0:
+            return newfilter(id_condition(NT_LT, newint(30), NT_AND, id_condition(NT_NEQ, newint(7), -1, NULL)));
+        case 1:
+            return newfilter(id_condition(NT_LT, newint(10), NT_OR, id_condition(NT_GTE, newint(45), -1, NULL)));
+        case 2:
+            return newfilter(id_condition(NT_LT, newint(30), NT_AND,
+                                          id_condition(NT_EQ, newattr_name(strdup("v"), strdup("ID")), -1, NULL)));
+        case 3:
+            return newfilter(id_condition(NT_EQ, newattr_name(strdup("v"), strdup("ID")), NT_OR,
+                                          id_condition(NT_LT, newint(5), -1, NULL)));
+        case 4:
+            return newfilter(id_condition(NT_GTE, newint(20), NT_AND,
+                                          id_condition(NT_EQ, newattr_name(strdup("v"), strdup("ID")), NT_OR,
+                                                       id_condition(NT_LT, newint(3), -1, NULL))));
+        default:
+            return newfilter(id_condition(NT_GTE, newint(20), NT_AND,
+                                          id_condition(NT_LT, newint(25), NT_OR,
+                                                       id_condition(NT_EQ, newattr_name(strdup("v"), strdup("ID")),
+                                                                    -1, NULL))));
+    }
+}
+
+DEFINE_TEST(scan_filters){
+    db_t* db = db_init("test.db");
+    table_t* table = table_keys(db, "KEYS", 300, 50);
+    int64_t tablix = table_index(table);
+    struct response* resp = create_response();
+    /*
+     * Conditions on v are left to filter_exec, only conditions every row must match are scanned then.
+     * Rows of v are rows of the same table, so ID of u joined with them keeps conditions on ID of u
+     */
+    bool complete[] = {true, true, false, false, false, false};
+    int64_t required[] = {2, 2, 1, 0, 1, 1};
+    bool uses_index[] = {true, false, true, false, true, true};
+
+    for(int indexed = 0; indexed < 2; indexed++){
+        schema_t* schema = sch_load(table->schidx);
+        field_t id_field;
+        sch_get_field(schema, "ID", &id_field);
+        for(int i = 0; i < 6; i++){
+            struct ast* filter = scan_filter(i);
+            struct filter_condition_ast* root =
+                    (struct filter_condition_ast*) ((struct filter_ast*) filter)->conditions_tree_root;
+            scan_pred_t pred;
+            assert(scan_pred_compile(db, schema, root, &pred) == complete[i]);
+            assert(pred.count == required[i]);
+            for(int64_t l = 0; l < pred.count && !complete[i]; l++){
+                assert(pred.leaves[l].required && pred.leaves[l].logic == (l + 1 < pred.count ? NT_AND : -1));
+            }
+            scan_pred_free(&pred);
+            assert(filter_uses_index(filter, schema) == (indexed && uses_index[i]));
+
+            /* Scan or index with recheck, then FILTER itself when the scan does not answer it */
+            row_likedlist_t* outer = tab_table2rll(db, table);
+            bool answered;
+            row_likedlist_t* scanned = filter_scan(db, filter, table, schema, &answered);
+            assert(scanned != NULL && answered == complete[i]);
+            if(!answered){
+                scanned = filter_exec(db, filter, scanned, schema, resp, outer);
+            }
+            row_likedlist_t* expected = filter_exec(db, filter, tab_table2rll(db, table), schema, resp, outer);
+            assert(resp->status == 0);
+            check_same_rows(scanned, expected, id_field.offset, id_field.offset);
+            assert(expected->size > 0);
+            assert(i != 0 || expected->size == 29 * 6);
+            assert(i != 2 || expected->size == 30 * 6 * 6);
+            assert(i != 5 || expected->size == 5 * 6 + 25 * 6 * 6);
+            row_likedlist_free(scanned);
+            row_likedlist_free(expected);
+            row_likedlist_free(outer);
+            free_ast(filter);
+        }
+        if(!indexed){
+            assert(tab_create_index(table, "ID", IDX_BTREE) == TABLE_SUCCESS);
+            table = tab_load(tablix);
+        }
+    }
+
+    /* FOR skips the FILTER answered by the scan and applies the one it does not answer */
+    schema_t* schema = sch_load(table->schidx);
+    field_t id_field;
+    sch_get_field(schema, "ID", &id_field);
+    for(int i = 0; i < 3; i++){
+        struct ast* root = newfor(strdup("u"), strdup("KEYS"), newlist(scan_filter(i), NULL),
+                                  newreturn(newattr_name(strdup("u"), NULL)));
+        struct response* for_resp = create_response();
+        assert(for_exec(&(default_query_args_t) {.db = db, .root = root, .resp = for_resp}) == 0);
+        assert(for_resp->status == 0 && for_resp->table != NULL);
+        struct ast* filter = scan_filter(i);
+        row_likedlist_t* all = tab_table2rll(db, table);
+        row_likedlist_t* expected = filter_exec(db, filter, all, schema, resp, all);
+        row_likedlist_t* result = tab_table2rll(db, for_resp->table);
+        check_same_rows(result, expected, id_field.offset, id_field.offset);
+        row_likedlist_free(result);
+        row_likedlist_free(expected);
+        free_ast(filter);
+        free_ast(root);
+        free(for_resp->message);
+        free(for_resp);
+    }
+    free(resp);
+    db_drop();
+}
+
+/* FILTERs of FOR u, listed from the last one as the parser lists them */
+static struct ast* pipeline_filters(int query){
+    struct ast* below = newfilter(id_condition(NT_LT, newint(30), -1, NULL));
+    switch(query){
+        case 0:
+            free_ast(below);
+            return newlist(newfilter(id_condition(NT_LT, newint(30), NT_AND, id_condition(NT_NEQ, newint(7), -1, NULL))),
+                           NULL);
+        case 1:
+            return newlist(below, newlist(newfilter(attr_condition(
+                    "NAME", NT_EQ, newstring(strdup("a rather long name number 3")), -1, NULL)), NULL));
+        case 2:
+            return newlist(newfilter(id_condition(NT_LT, newint(10), NT_OR, id_condition(NT_GT, newint(20), -1, NULL))),
+                           newlist(below, NULL));
+        case 3:
+            free_ast(below);
+            return newlist(newfilter(attr_condition("NAME", NT_NEQ, newstring(strdup("a rather long name number 1")),
+                                                    -1, NULL)),
+                           newlist(newfilter(id_condition(NT_GT, newint(40), NT_OR,
+                                                          id_condition(NT_LT, newint(3), -1, NULL))), NULL));
+        default:
+            free_ast(below);
+            return newlist(newfilter(attr_condition("SCORE", NT_GT, newfloat(15.0), NT_AND,
+                                                    id_condition(NT_NEQ, newint(3), -1, NULL))), NULL);
+    }
+}
+
+/* FOR u IN table with FILTERs, optionally FOR v IN SMALL FILTER v.ID == u.ID FILTER v.ID > 3 RETURN MERGE */
+static struct ast* pipeline_query(const char* table, struct ast* filters, bool nested){
+    if(!nested){
+        return newfor(strdup("u"), strdup(table), filters, newreturn(newattr_name(strdup("u"), NULL)));
+    }
+    struct ast* join = newfilter(newfilter_condition(
+            newfilter_expr(newattr_name(strdup("v"), strdup("ID")), newattr_name(strdup("u"), strdup("ID")), NT_EQ), NULL, -1));
+    struct ast* constant = newfilter(newfilter_condition(
+            newfilter_expr(newattr_name(strdup("v"), strdup("ID")), newint(3), NT_GT), NULL, -1));
+    struct ast* inner = newfor(strdup("v"), strdup("SMALL"), newlist(constant, newlist(join, NULL)),
+                               newreturn(newmerge(strdup("u"), strdup("v"))));
+    return newfor(strdup("u"), strdup(table), newlist(inner, filters), newreturn(newmerge(strdup("u"), strdup("v"))));
+}
+
+/* Last list node of the FILTERs of a FOR, their head once for_exec lists them in place */
+static struct ast* last_filter(struct ast* root){
+    struct ast* list = ((struct for_ast*) root)->nonterm_list_head;
+    while(list != NULL && ((struct list_ast*) list)->next != NULL){
+        list = ((struct list_ast*) list)->next;
+    }
+    return list;
+}
+
+/* Points a FOR executed by for_exec to the whole list of its FILTERs, reversed from the former last one */
+static void restore_filters(struct ast* root, struct ast* last){
+    struct for_ast* for_ast = (struct for_ast*) root;
+    if(for_ast->nonterm_list_head != NULL && ((struct list_ast*) for_ast->nonterm_list_head)->next == NULL){
+        for_ast->nonterm_list_head = last;
+    }
+}
+
+DEFINE_TEST(pipeline_rows){
+    db_t* db = db_init("test.db");
+    table_t* big = table_keys(db, "BIG", 300, 50);
+    table_keys(db, "SMALL", 120, 40);
+    table_t* students = table_student(db, 1);
+    schema_t* schema = sch_load(big->schidx);
+    field_t id_field;
+    sch_get_field(schema, "ID", &id_field);
+
+    /* Conjunctions of int and float comparisons are compared by columns, others are checked by rows */
+    struct ast* filters[] = {
+        newfilter(id_condition(NT_LT, newint(30), NT_AND, id_condition(NT_NEQ, newint(7), -1, NULL))),
+        newfilter(attr_condition("NAME", NT_EQ, newstring(strdup("a rather long name number 3")), -1, NULL)),
+        newfilter(id_condition(NT_LT, newint(10), NT_OR, id_condition(NT_GT, newint(20), -1, NULL))),
+        newfilter(attr_condition("SCORE", NT_GT, newfloat(15.0), NT_AND, id_condition(NT_NEQ, newint(3), -1, NULL))),
+        newfilter(attr_condition("PASS", NT_EQ, newbool(1), -1, NULL)),
+    };
+    bool vectorizable[] = {true, false, false, true, false};
+    for(int i = 0; i < 5; i++){
+        scan_pred_t pred;
+        struct filter_condition_ast* root =
+                (struct filter_condition_ast*) ((struct filter_ast*) filters[i])->conditions_tree_root;
+        assert(scan_pred_compile(db, sch_load((i < 3 ? big : students)->schidx), root, &pred));
+        assert(scan_pred_vectorizable(&pred) == vectorizable[i]);
+        scan_pred_free(&pred);
+        free_ast(filters[i]);
+    }
+
+    /*
+     * Pipeline and row lists return the same rows in the same order, whether the first FILTER
+     * is compared by columns or checked by the scan and the next ones by columns or by rows
+     */
+    int64_t expected[] = {29 * 6, 4 * 6, 10 * 6 + 9 * 6, 12 * 6 - 2 * 6, 2};
+    for(int query = 0; query < 6; query++){
+        bool nested = query == 5;
+        int64_t right_id = nested ? sch_join_offset(schema) + id_field.offset : id_field.offset;
+        row_likedlist_t* results[2];
+        for(int lists = 0; lists < 2; lists++){
+            bool enabled = pipeline_set_enabled(!lists);
+            struct response* resp = create_response();
+            struct ast* root = pipeline_query(query == 4 ? "STUDENTS" : "BIG", pipeline_filters(nested ? 0 : query), nested);
+            struct ast* last = last_filter(root);
+            struct ast* inner = nested ? ((struct list_ast*) ((struct for_ast*) root)->nonterm_list_head)->value : NULL;
+            struct ast* inner_last = nested ? last_filter(inner) : NULL;
+            assert(for_exec(&(default_query_args_t) {.db = db, .root = root, .resp = resp}) == 0);
+            pipeline_set_enabled(enabled);
+            assert(resp->status == 0 && resp->table != NULL);
+            results[lists] = tab_table2rll(db, resp->table);
+            if(nested){
+                restore_filters(inner, inner_last);
+            }
+            restore_filters(root, last);
+            free_ast(root);
+            free(resp->message);
+            free(resp);
+        }
+        check_same_order(results[0], results[1], id_field.offset, right_id);
+        assert(results[0]->size == (nested ? 25 * 6 * 3 : expected[query]));
+        row_likedlist_free(results[0]);
+        row_likedlist_free(results[1]);
+    }
+    assert(pipeline_enabled());
+    db_drop();
+}
+
+DEFINE_TEST(laid_out_filters){
+    db_t* db = db_init("test.db");
+    schema_t* schema = sch_init();
+    sch_add_int_field(schema, "ID");
+    sch_add_bool_field(schema, "PASS");
+    assert(sch_optimize_layout(schema) == SCHEMA_SUCCESS);
+    assert(schema->slot_size == 16);
+    table_t* table = tab_init(db, "FLAGS", schema);
+    field_t id_field;
+    field_t pass_field;
+    sch_get_field(schema, "ID", &id_field);
+    sch_get_field(schema, "PASS", &pass_field);
+    char* row = calloc(1, schema->slot_size);
+    for(int64_t id = 0; id < 20; id++){
+        bool pass = id % 2;
+        memcpy(row + id_field.offset, &id, sizeof(int64_t));
+        memcpy(row + pass_field.offset, &pass, sizeof(bool));
+        tab_insert(table, schema, row);
+    }
+    free(row);
+
+    /* Condition on v keeps the chain off bitmaps, AND joins whole padded rows */
+    struct ast* filter = newfilter(id_condition(NT_LT, newint(10), NT_AND,
+                                                attr_condition("PASS", NT_EQ, newbool(1), NT_AND,
+                                                               id_condition(NT_EQ, newattr_name(strdup("v"), strdup("ID")),
+                                                                            -1, NULL))));
+    struct response* resp = create_response();
+    row_likedlist_t* outer = tab_table2rll(db, table);
+    row_likedlist_t* filtered = filter_exec(db, filter, tab_table2rll(db, table), schema, resp, outer);
+    assert(resp->status == 0 && filtered != NULL && filtered->size == 5);
+    for(row_node_t* node = filtered->head; node != NULL; node = node->next){
+        int64_t id;
+        memcpy(&id, node->row + id_field.offset, sizeof(int64_t));
+        assert(id < 10 && id % 2 == 1 && node->row[pass_field.offset]);
+    }
+    row_likedlist_free(filtered);
+    row_likedlist_free(outer);
+    free_ast(filter);
+    free(resp);
+    db_drop();
+}
+
+DEFINE_TEST(filter_bitmaps){
+    db_t* db = db_init("test.db");
+    table_t* table = table_keys(db, "KEYS", 300, 50);
+    schema_t* schema = sch_load(table->schidx);
+    field_t id_field;
+    sch_get_field(schema, "ID", &id_field);
+    row_likedlist_t* all = tab_table2rll(db, table);
+    int64_t words = rll_bitmap_words(all->size);
+    uint64_t* below = malloc(words * sizeof(uint64_t));
+    uint64_t* above = malloc(words * sizeof(uint64_t));
+    uint64_t* equal = malloc(words * sizeof(uint64_t));
+    int64_t bound = 20;
+    int64_t low = 10;
+    int64_t id = 45;
+    rll_filter_bits(db, all, &id_field, COND_LT, &bound, below);
+    rll_filter_bits(db, all, &id_field, COND_GTE, &low, above);
+    rll_filter_bits(db, all, &id_field, COND_EQ, &id, equal);
+    row_likedlist_t* below_rows = rll_filter(db, all, &id_field, COND_LT, &bound, DT_INT);
+    row_likedlist_t* above_rows = rll_filter(db, all, &id_field, COND_GTE, &low, DT_INT);
+    row_likedlist_t* equal_rows = rll_filter(db, all, &id_field, COND_EQ, &id, DT_INT);
+
+    /* Marked rows are the rows of filter */
+    row_likedlist_t* selected = rll_select_bits(all, below);
+    check_same_order(selected, below_rows, id_field.offset, id_field.offset);
+    assert(selected->size == 120);
+    row_likedlist_free(selected);
+
+    /* AND and OR of bitmaps keep the same rows as joins of lists */
+    for(int64_t i = 0; i < words; i++){
+        above[i] &= below[i];
+        equal[i] |= below[i];
+    }
+    row_likedlist_t* and_rows = rll_join_and(below_rows, above_rows);
+    row_likedlist_t* or_rows = rll_join_or(below_rows, equal_rows);
+    selected = rll_select_bits(all, above);
+    check_same_order(selected, and_rows, id_field.offset, id_field.offset);
+    assert(selected->size == 60);
+    row_likedlist_free(selected);
+    selected = rll_select_bits(all, equal);
+    check_same_rows(selected, or_rows, id_field.offset, id_field.offset);
+    assert(selected->size == 126);
+    row_likedlist_free(selected);
+
+    row_likedlist_free(and_rows);
+    row_likedlist_free(or_rows);
+    row_likedlist_free(below_rows);
+    row_likedlist_free(above_rows);
+    row_likedlist_free(equal_rows);
+    free(below);
+    free(above);
+    free(equal);
+    row_likedlist_free(all);
+
+    /* FILTER of constants keeps the order of the list, rows matching only the right side of OR are not moved last */
+    struct response* resp = create_response();
+    struct ast* filter = scan_filter(1);
+    all = tab_table2rll(db, table);
+    row_likedlist_t* filtered = filter_exec(db, filter, tab_table2rll(db, table), schema, resp, all);
+    bool answered;
+    row_likedlist_t* scanned = filter_scan(db, filter, table, schema, &answered);
+    assert(resp->status == 0 && answered);
+    check_same_order(filtered, scanned, id_field.offset, id_field.offset);
+    assert(filtered->size == 15 * 6);
+    row_likedlist_free(filtered);
+    row_likedlist_free(scanned);
+    free_ast(filter);
+
+    /* Joined rows sharing the first source row are paired by AND as complex_condition pairs them */
+    filter = newfilter(id_condition(NT_GTE, newint(10), NT_AND, id_condition(NT_LT, newint(20), -1, NULL)));
+    struct ast* lower = newfilter(id_condition(NT_GTE, newint(10), -1, NULL));
+    struct ast* upper = newfilter(id_condition(NT_LT, newint(20), -1, NULL));
+    row_likedlist_t* joined[3];
+    for(int i = 0; i < 3; i++){
+        joined[i] = rll_hash_join(db, all, &id_field, all, &id_field);
+    }
+    assert(!rll_unique_rowix(joined[0]) && rll_unique_rowix(all));
+    filtered = filter_exec(db, filter, joined[0], joined[0]->schema, resp, all);
+    row_likedlist_t* lower_rows = filter_exec(db, lower, joined[1], joined[1]->schema, resp, all);
+    row_likedlist_t* upper_rows = filter_exec(db, upper, joined[2], joined[2]->schema, resp, all);
+    and_rows = rll_join_and(lower_rows, upper_rows);
+    assert(resp->status == 0);
+    int64_t right_id = sch_join_offset(schema) + id_field.offset;
+    check_same_order(filtered, and_rows, id_field.offset, right_id);
+    assert(filtered->size == 10 * 6 * 6 * 6);
+    row_likedlist_free(filtered);
+    row_likedlist_free(lower_rows);
+    row_likedlist_free(upper_rows);
+    row_likedlist_free(and_rows);
+    row_likedlist_free(all);
+    free_ast(filter);
+    free_ast(lower);
+    free_ast(upper);
+    free(resp);
+    db_drop();
+}
+
+/* Checksum of rows operator hands out, read row by row or by batches */
+static int64_t op_checksum(operator_t* op, int64_t left_id, int64_t right_id, bool batches, int64_t* count){
+    int64_t sum = 0;
+    *count = 0;
+    op_batch_t* batch = batches ? op_batch_init(op->schema->slot_size) : NULL;
+    assert((batch != NULL || !batches) && op_open(op) == OP_SUCCESS);
+    void* row;
+    while(batches ? op_next_batch(op, batch) == OP_SUCCESS : op_next(op, &row) == OP_SUCCESS){
+        assert(!batches || (batch->selected > 0 && batch->selected <= batch->count && batch->count <= OP_BATCH_SIZE));
+        for(int64_t i = 0; i < (batches ? batch->selected : 1); i++){
+            char* current = batches ? (char*) op_batch_row(batch, i) : row;
+            int64_t left;
+            int64_t right;
+            memcpy(&left, current + left_id, sizeof(int64_t));
+            memcpy(&right, current + right_id, sizeof(int64_t));
+            sum += left * 1000 + right;
+            (*count)++;
+        }
+    }
+    op_close(op);
+    op_batch_free(batch);
+    return sum;
+}
+
+/* Check that operator hands out rows of the list, in its order when read row by row */
+static void check_op_rows(operator_t* op, row_likedlist_t* expected, int64_t left_id, int64_t right_id){
+    int64_t count;
+    for(int batches = 0; batches < 2; batches++){
+        assert(op_checksum(op, left_id, right_id, batches, &count) == join_checksum(expected, left_id, right_id));
+        assert(count == expected->size);
+    }
+    row_node_t* node = expected->head;
+    void* row;
+    assert(op_open(op) == OP_SUCCESS);
+    while(op_next(op, &row) == OP_SUCCESS){
+        assert(node != NULL);
+        assert(memcmp((char*) row + left_id, node->row + left_id, sizeof(int64_t)) == 0);
+        assert(memcmp((char*) row + right_id, node->row + right_id, sizeof(int64_t)) == 0);
+        node = node->next;
+    }
+    op_close(op);
+}
+
+DEFINE_TEST(operators){
+    db_t* db = db_init("test.db");
+    table_t* big = table_keys(db, "BIG", 300, 50);
+    table_t* small = table_keys(db, "SMALL", 40, 40);
+    schema_t* schema = sch_load(big->schidx);
+    field_t id_field;
+    field_t name_field;
+    sch_get_field(schema, "ID", &id_field);
+    sch_get_field(schema, "NAME", &name_field);
+    int64_t bound = 30;
+    int64_t excluded = 7;
+    scan_arg_t lt = {.offset = id_field.offset};
+    scan_arg_t neq = {.offset = id_field.offset};
+    comp_pred_init(&lt.pred, db, &id_field, COND_LT, &bound);
+    comp_pred_init(&neq.pred, db, &id_field, COND_NEQ, &excluded);
+
+    /* Scan with filter hands out the same rows as filters of list */
+    row_likedlist_t* all = tab_table2rll(db, big);
+    row_likedlist_t* below = rll_filter(db, all, &id_field, COND_LT, &bound, DT_INT);
+    row_likedlist_t* filtered = rll_filter(db, below, &id_field, COND_NEQ, &excluded, DT_INT);
+    operator_t* op = op_filter_init(op_scan_init(big, scan_matches, &lt), scan_matches, &neq);
+    check_op_rows(op, filtered, id_field.offset, id_field.offset);
+    assert(filtered->size > 0);
+    op_free(op);
+
+    /* Hash join keeps the left order and matches rows of list join */
+    row_likedlist_t* right = tab_table2rll(db, small);
+    int64_t right_id = sch_join_offset(schema) + id_field.offset;
+    field_t* fields[] = {&id_field, &name_field};
+    for(int f = 0; f < 2; f++){
+        row_likedlist_t* joined = rll_hash_join(db, right, fields[f], filtered, fields[f]);
+        op = op_hash_join_init(db, op_filter_init(op_scan_init(big, scan_matches, &lt), scan_matches, &neq), fields[f],
+                               op_scan_init(small, NULL, NULL), fields[f]);
+        assert(op != NULL && op->schema->slot_size == 2 * schema->slot_size);
+        check_op_rows(op, joined, id_field.offset, right_id);
+        int64_t count = joined->size;
+        assert(count > 0);
+        row_likedlist_free(joined);
+
+        /* Projection read by rows, by batches and written to table keeps every joined row */
+        field_t projected[2];
+        assert(sch_get_field(op->schema, "ID", &projected[0]) == SCHEMA_SUCCESS);
+        assert(sch_get_field(op->schema, "NAME", &projected[1]) == SCHEMA_SUCCESS);
+        op = op_project_init(op, projected, 2);
+        assert(op != NULL);
+        field_t projected_id;
+        assert(sch_get_field(op->schema, "ID", &projected_id) == SCHEMA_SUCCESS);
+        int64_t rows;
+        int64_t sum = op_checksum(op, projected_id.offset, projected_id.offset, false, &rows);
+        assert(rows == count && op_checksum(op, projected_id.offset, projected_id.offset, true, &rows) == sum);
+        assert(rows == count);
+        table_t* result = tab_op2table(db, op, "TEMP");
+        assert(result != NULL);
+        rows = 0;
+        char* buf = malloc(sch_load(result->schidx)->slot_size);
+        tab_for_each_row(result, chunk, chblix, buf, sch_load(result->schidx)){
+            rows++;
+        }
+        free(buf);
+        assert(rows == count);
+        op_free(op);
+    }
+
+    row_likedlist_free(right);
+    row_likedlist_free(filtered);
+    row_likedlist_free(below);
+    row_likedlist_free(all);
+    db_drop();
+}
+
+DEFINE_TEST(operator_batches){
+    db_t* db = db_init("test.db");
+    table_t* big = table_keys(db, "BIG", 5000, 700);
+    table_t* small = table_keys(db, "SMALL", 1500, 100);
+    schema_t* schema = sch_load(big->schidx);
+    field_t id_field;
+    sch_get_field(schema, "ID", &id_field);
+    int64_t right_id = sch_join_offset(schema) + id_field.offset;
+    condition_t conditions[] = {COND_EQ, COND_NEQ, COND_LT, COND_LTE, COND_GT, COND_GTE};
+    int64_t excluded = 7;
+    scan_arg_t neq = {.offset = id_field.offset};
+    comp_pred_init(&neq.pred, db, &id_field, COND_NEQ, &excluded);
+
+    /* Batches hand out the same rows as reading row by row */
+    for(int c = 0; c < 6; c++){
+        int64_t value = 50;
+        int64_t rows;
+        int64_t batched;
+        operator_t* op = op_compare_init(db, op_filter_init(op_scan_init(big, NULL, NULL), scan_matches, &neq),
+                                         &id_field, conditions[c], &value);
+        assert(op != NULL);
+        int64_t sum = op_checksum(op, id_field.offset, id_field.offset, false, &rows);
+        assert(op_checksum(op, id_field.offset, id_field.offset, true, &batched) == sum);
+        assert(batched == rows && rows > 0);
+        op_free(op);
+
+        /* Join output of more than one batch */
+        op = op_hash_join_init(db, op_compare_init(db, op_scan_init(big, NULL, NULL), &id_field, conditions[c], &value),
+                               &id_field, op_scan_init(small, scan_matches, &neq), &id_field);
+        assert(op != NULL);
+        sum = op_checksum(op, id_field.offset, right_id, false, &rows);
+        assert(op_checksum(op, id_field.offset, right_id, true, &batched) == sum);
+        assert(batched == rows);
+        assert(rows > OP_BATCH_SIZE || conditions[c] == COND_EQ);
+        op_free(op);
+    }
+
+    table_t* students = table_student(db, 1);
+    schema_t* student_schema = sch_load(students->schidx);
+    field_t score_field;
+    field_t student_id;
+    sch_get_field(student_schema, "SCORE", &score_field);
+    sch_get_field(student_schema, "ID", &student_id);
+    double score = 20.0;
+    int64_t batched;
+    operator_t* op = op_compare_init(db, op_scan_init(students, NULL, NULL), &score_field, COND_GT, &score);
+    assert(op_checksum(op, student_id.offset, student_id.offset, true, &batched) == 2 * 1001 + 3 * 1001 + 4 * 1001);
+    assert(batched == 3);
+    op_free(op);
+    db_drop();
+}
+
+DEFINE_TEST(compiled_predicates){
+    db_t* db = db_init("test.db");
+    condition_t conditions[] = {COND_EQ, COND_NEQ, COND_LT, COND_LTE, COND_GT, COND_GTE};
+    field_t int_field = {.type = DT_INT, .size = sizeof(int64_t), .dict = DICT_NONE};
+    field_t float_field = {.type = DT_FLOAT, .size = sizeof(double), .dict = DICT_NONE};
+    int64_t ints[] = {INT64_MIN, -5, 0, 5, INT64_MAX};
+    double floats[] = {-1e300, -0.5, 0.0, 0.5, 1e300};
+    for(int c = 0; c < 6; c++){
+        for(int i = 0; i < 5; i++){
+            comp_pred_t int_pred;
+            comp_pred_t float_pred;
+            comp_pred_init(&int_pred, db, &int_field, conditions[c], &ints[i]);
+            comp_pred_init(&float_pred, db, &float_field, conditions[c], &floats[i]);
+            for(int j = 0; j < 5; j++){
+                int cmp = (ints[j] > ints[i]) - (ints[j] < ints[i]);
+                bool expected = conditions[c] == COND_EQ ? cmp == 0 : conditions[c] == COND_NEQ ? cmp != 0 :
+                                conditions[c] == COND_LT ? cmp < 0 : conditions[c] == COND_LTE ? cmp <= 0 :
+                                conditions[c] == COND_GT ? cmp > 0 : cmp >= 0;
+                /* Values far apart used to overflow the difference */
+                assert(comp_compare(db, DT_INT, &ints[j], &ints[i], conditions[c]) == expected);
+                assert(comp_pred_test(&int_pred, &ints[j]) == expected);
+                assert(comp_pred_test(&float_pred, &floats[j]) == expected);
+            }
+        }
+    }
+
+    table_t* table = table_keys(db, "KEYS", 100, 50);
+    schema_t* schema = sch_load(table->schidx);
+    field_t name_field;
+    sch_get_field(schema, "NAME", &name_field);
+    char* names[] = {"a rather long name number 3", "a rather", "b", "a rather long name number 9"};
+    void* element = malloc(name_field.size);
+    for(int c = 0; c < 6; c++){
+        for(int i = 0; i < 4; i++){
+            vch_ticket_t value = vch_transient(names[i]);
+            comp_pred_t pred;
+            comp_pred_init(&pred, db, &name_field, conditions[c], &value);
+            int64_t matched = 0;
+            tab_for_each_element(table, chunk, chblix, element, &name_field){
+                bool res = comp_pred_test(&pred, element);
+                assert(res == comp_compare(db, DT_VARCHAR, element, &value, conditions[c]));
+                matched += res;
+            }
+            assert(conditions[c] != COND_EQ || matched == (i == 0 ? 14 : 0));
+        }
+    }
+    free(element);
+
+    bool bools[] = {false, true};
+    field_t bool_field = {.type = DT_BOOL, .size = sizeof(bool), .dict = DICT_NONE};
+    char chars[][8] = {"", "ab", "abc", "b"};
+    field_t char_field = {.type = DT_CHAR, .size = sizeof(chars[0]), .dict = DICT_NONE};
+    field_t unknown_field = {.type = DT_UNKNOWN, .size = sizeof(int64_t), .dict = DICT_NONE};
+    for(int c = 0; c < 6; c++){
+        for(int i = 0; i < 2; i++){
+            comp_pred_t pred;
+            comp_pred_init(&pred, db, &bool_field, conditions[c], &bools[i]);
+            for(int j = 0; j < 2; j++){
+                assert(comp_pred_test(&pred, &bools[j]) == comp_compare(db, DT_BOOL, &bools[j], &bools[i], conditions[c]));
+            }
+        }
+        for(int i = 0; i < 4; i++){
+            comp_pred_t pred;
+            comp_pred_init(&pred, db, &char_field, conditions[c], chars[i]);
+            for(int j = 0; j < 4; j++){
+                assert(comp_pred_test(&pred, chars[j]) == comp_compare(db, DT_CHAR, chars[j], chars[i], conditions[c]));
+            }
+        }
+        comp_pred_t pred;
+        comp_pred_init(&pred, db, &unknown_field, conditions[c], &ints[0]);
+        assert(!comp_pred_test(&pred, &ints[0]));
+    }
+
+    /* Equality on dictionary column compares codes, other conditions decode the element */
+    schema = sch_init();
+    sch_add_int_field(schema, "ID");
+    sch_add_dict_varchar_field(schema, "CITY");
+    table = tab_init(db, "CITIES", schema);
+    field_t id_field;
+    field_t city_field;
+    sch_get_field(schema, "ID", &id_field);
+    sch_get_field(schema, "CITY", &city_field);
+    char* cities[] = {"Omsk", "Tomsk", "Kazan", "Omsk", "Perm", "Tomsk", "Omsk"};
+    char* row = calloc(1, schema->slot_size);
+    for(int64_t id = 0; id < 7; id++){
+        memcpy(row + id_field.offset, &id, sizeof(int64_t));
+        assert(sch_put_varchar(db->varchar_mgr_idx, &city_field, cities[id], row + city_field.offset) == SCHEMA_SUCCESS);
+        chblix_t rowix = tab_insert(table, schema, row);
+        assert(chblix_cmp(&rowix, &CHBLIX_FAIL) != 0);
+    }
+    char* values[] = {"Omsk", "Perm", "Moscow", "A", "Zelenograd"};
+    for(int c = 0; c < 6; c++){
+        for(int i = 0; i < 5; i++){
+            vch_ticket_t value = vch_transient(values[i]);
+            comp_pred_t pred;
+            comp_pred_init(&pred, db, &city_field, conditions[c], &value);
+            assert(pred.by_code == (conditions[c] == COND_EQ || conditions[c] == COND_NEQ));
+            int64_t matched = 0;
+            int64_t expected_matched = 0;
+            tab_for_each_row(table, chunk, chblix, row, schema){
+                int64_t id;
+                memcpy(&id, row + id_field.offset, sizeof(int64_t));
+                int cmp = strcmp(cities[id], values[i]);
+                bool expected = conditions[c] == COND_EQ ? cmp == 0 : conditions[c] == COND_NEQ ? cmp != 0 :
+                                conditions[c] == COND_LT ? cmp < 0 : conditions[c] == COND_LTE ? cmp <= 0 :
+                                conditions[c] == COND_GT ? cmp > 0 : cmp >= 0;
+                bool res = comp_pred_test(&pred, row + city_field.offset);
+                assert(res == expected);
+                matched += res;
+                expected_matched += expected;
+            }
+            assert(matched == expected_matched);
+            assert(conditions[c] != COND_EQ || matched == (i == 0 ? 3 : i == 1 ? 1 : 0));
+        }
+    }
+    free(row);
+    db_drop();
+}
+
+DEFINE_TEST(jit_predicates){
+    db_t* db = db_init("test.db");
+    bool enabled = jit_set_enabled(true);
+    condition_t conditions[] = {COND_EQ, COND_NEQ, COND_LT, COND_LTE, COND_GT, COND_GTE};
+    /* Aligned rows of int, float, bool, char and varchar fields, varchar is tested by its predicate */
+    field_t fields[] = {
+        {.type = DT_INT, .size = sizeof(int64_t), .offset = 0, .dict = DICT_NONE},
+        {.type = DT_FLOAT, .size = sizeof(double), .offset = 8, .dict = DICT_NONE},
+        {.type = DT_BOOL, .size = sizeof(bool), .offset = 16, .dict = DICT_NONE},
+        {.type = DT_CHAR, .size = 8, .offset = 17, .dict = DICT_NONE},
+        {.type = DT_VARCHAR, .size = vch_slot_size(VCH_DEFAULT_INLINE_SIZE), .offset = 32, .dict = DICT_NONE},
+    };
+    int64_t ints[] = {INT64_MIN, -5, 0, 5, INT64_MAX};
+    double floats[] = {-1e300, -0.5, -0.0, 0.0, 0.5};
+    bool bools[] = {false, true, false, true, true};
+    char chars[][8] = {"", "ab", "abc", "abd", "b"};
+    char* strings[] = {"", "ab", "a rather long name number 3", "a rather long name number 9", "b"};
+    vch_ticket_t tickets[5];
+    _Alignas(SCH_ROW_ALIGN) uint8_t rows[5][sch_row_align(32 + vch_slot_size(VCH_DEFAULT_INLINE_SIZE))];
+    void* values[5][5];
+    for(int i = 0; i < 5; i++){
+        tickets[i] = vch_transient(strings[i]);
+        memcpy(rows[i] + fields[0].offset, &ints[i], sizeof(int64_t));
+        memcpy(rows[i] + fields[1].offset, &floats[i], sizeof(double));
+        memcpy(rows[i] + fields[2].offset, &bools[i], sizeof(bool));
+        memcpy(rows[i] + fields[3].offset, chars[i], 8);
+        assert(sch_put_varchar(db->varchar_mgr_idx, &fields[4], strings[i], rows[i] + fields[4].offset) == SCHEMA_SUCCESS);
+        values[0][i] = &ints[i];
+        values[1][i] = &floats[i];
+        values[2][i] = &bools[i];
+        values[3][i] = chars[i];
+        values[4][i] = &tickets[i];
+    }
+
+    for(int f = 0; f < 5; f++){
+        for(int c = 0; c < 6; c++){
+            for(int i = 0; i < 5; i++){
+                comp_pred_t pred;
+                comp_pred_init(&pred, db, &fields[f], conditions[c], values[f][i]);
+                jit_leaf_t leaf = {.offset = (int64_t) fields[f].offset, .pred = &pred, .logic = JIT_LAST};
+                jit_code_t* code = jit_compile(&leaf, 1);
+                assert(!code == !enabled);
+                for(int j = 0; j < 5 && code; j++){
+                    bool expected = comp_compare(db, fields[f].type, rows[j] + fields[f].offset, values[f][i], conditions[c]);
+                    assert(jit_test(code, rows[j]) == expected);
+                }
+                jit_free(code);
+            }
+        }
+    }
+
+    /* Chains of every field with every logic, decided as scan_pred_eval does it */
+    jit_code_t* empty = jit_compile(NULL, 0);
+    assert(!empty || jit_test(empty, rows[0]));
+    jit_free(empty);
+    comp_pred_t preds[5];
+    jit_leaf_t leaves[5];
+    for(uint64_t seed = 0; seed < 2000 && enabled; seed++){
+        uint64_t state = seed;
+        for(int f = 0; f < 5; f++){
+            comp_pred_init(&preds[f], db, &fields[f], conditions[state % 6], values[f][state / 6 % 5]);
+            leaves[f].offset = (int64_t) fields[f].offset;
+            leaves[f].pred = &preds[f];
+            leaves[f].logic = f == 4 ? JIT_LAST : state / 30 % 2 ? JIT_OR : JIT_AND;
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+        jit_code_t* code = jit_compile(leaves, 5);
+        assert(code);
+        for(int j = 0; j < 5; j++){
+            bool expected = true;
+            for(int f = 0; f < 5; f++){
+                expected = comp_compare(db, fields[f].type, rows[j] + fields[f].offset, preds[f].value, preds[f].cond);
+                if(leaves[f].logic == JIT_AND ? !expected : leaves[f].logic != JIT_OR || expected){
+                    break;
+                }
+            }
+            assert(jit_test(code, rows[j]) == expected);
+        }
+        jit_free(code);
+    }
+    jit_set_enabled(false);
+    db_drop();
+}
+
+DEFINE_TEST(jit_scan){
+    db_t* db = db_init("test.db");
+    table_t* table = table_keys(db, "KEYS", 300, 50);
+    int64_t tablix = table_index(table);
+    struct ast* filters[8];
+    for(int i = 0; i < 6; i++){
+        filters[i] = scan_filter(i);
+    }
+    filters[6] = newfilter(id_condition(NT_LT, newint(30), NT_AND,
+                                        attr_condition("NAME", NT_EQ, newstring(strdup("a rather long name number 3")),
+                                                       -1, NULL)));
+    filters[7] = newfilter(attr_condition("NAME", NT_GT, newstring(strdup("a rather long name number 4")), NT_OR,
+                                          id_condition(NT_EQ, newint(2), -1, NULL)));
+
+    /* Compiled chain answers the scan and the recheck of index as the interpreter does */
+    for(int indexed = 0; indexed < 2; indexed++){
+        schema_t* schema = sch_load(table->schidx);
+        field_t id_field;
+        sch_get_field(schema, "ID", &id_field);
+        for(int i = 0; i < 8; i++){
+            row_likedlist_t* results[2];
+            bool answered[2];
+            for(int jit = 0; jit < 2; jit++){
+                bool enabled = jit_set_enabled(jit);
+                struct filter_condition_ast* root =
+                        (struct filter_condition_ast*) ((struct filter_ast*) filters[i])->conditions_tree_root;
+                scan_pred_t pred;
+                scan_pred_compile(db, schema, root, &pred);
+                assert(!pred.jit == (!enabled || pred.count == 0));
+                scan_pred_free(&pred);
+                results[jit] = filter_scan(db, filters[i], table, schema, &answered[jit]);
+            }
+            assert(answered[0] == answered[1]);
+            check_same_order(results[1], results[0], id_field.offset, id_field.offset);
+            assert(results[0]->size > 0);
+            assert(i != 6 || results[0]->size == 4 * 6);
+            row_likedlist_free(results[0]);
+            row_likedlist_free(results[1]);
+        }
+        if(!indexed){
+            assert(tab_create_index(table, "ID", IDX_BTREE) == TABLE_SUCCESS);
+            table = tab_load(tablix);
+        }
+    }
+    jit_set_enabled(false);
+    for(int i = 0; i < 8; i++){
+        free_ast(filters[i]);
+    }
     db_drop();
 }
 
@@ -343,6 +1937,7 @@ DEFINE_TEST(update_row_op){
     row.PASS = true;
     field_t field;
     sch_get_field(schema, "SCORE", &field);
+    assert(tab_update_row_op(db, table, schema, &field, COND_EQ, &value, DT_INT, &row) == TABLE_FAIL);
     int res = tab_update_row_op(db,table, schema, &field, COND_EQ, &value, DT_FLOAT, &row);
     assert(res == TABLE_SUCCESS);
     bool flag = false;
@@ -425,10 +2020,33 @@ int main(){
     RUN_SINGLE_TEST(update);
     RUN_SINGLE_TEST(delete);
     RUN_SINGLE_TEST(get_table_after_close);
+    RUN_SINGLE_TEST(metatable_index);
+    RUN_SINGLE_TEST(temp_space);
     RUN_SINGLE_TEST(varchar);
+    RUN_SINGLE_TEST(inline_varchar);
+    RUN_SINGLE_TEST(varchar_reclaim);
+    RUN_SINGLE_TEST(alter_columns);
     RUN_SINGLE_TEST(several_tables);
     RUN_SINGLE_TEST(print);
     RUN_SINGLE_TEST(join);
+    RUN_SINGLE_TEST(hash_join);
+    RUN_SINGLE_TEST(merge_join);
+    RUN_SINGLE_TEST(btree_index);
+    RUN_SINGLE_TEST(inline_varchar_index);
+    RUN_SINGLE_TEST(failed_index_insert);
+    RUN_SINGLE_TEST(hash_index);
+    RUN_SINGLE_TEST(join_cache);
+    RUN_SINGLE_TEST(join_cache_budget);
+    RUN_SINGLE_TEST(table_scan);
+    RUN_SINGLE_TEST(scan_filters);
+    RUN_SINGLE_TEST(pipeline_rows);
+    RUN_SINGLE_TEST(laid_out_filters);
+    RUN_SINGLE_TEST(filter_bitmaps);
+    RUN_SINGLE_TEST(operators);
+    RUN_SINGLE_TEST(operator_batches);
+    RUN_SINGLE_TEST(compiled_predicates);
+    RUN_SINGLE_TEST(jit_predicates);
+    RUN_SINGLE_TEST(jit_scan);
     RUN_SINGLE_TEST(select);
     RUN_SINGLE_TEST(update_row_op);
     RUN_SINGLE_TEST(update_element_op);
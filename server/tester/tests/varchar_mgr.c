@@ -0,0 +1,156 @@
+#include "../src/test.h"
+#include "backend/db/db.h"
+#include "backend/journal/lob_store.h"
+#include "backend/journal/varchar_mgr.h"
+#include "core/io/pager.h"
+#include <stdlib.h>
+#include <string.h>
+
+static char* make_string(int64_t length){
+    char* str = malloc(length + 1);
+    for(int64_t i = 0; i < length; i++){
+        str[i] = (char)('a' + i % 26);
+    }
+    str[length] = '\0';
+    return str;
+}
+
+DEFINE_TEST(size_classes_and_extent){
+    db_t* db = db_init("test.db");
+    int64_t lengths[] = {3, 30, 100, 400, 1500, 2100, 10000};
+    int32_t flags[] = {VCH_INLINE, VCH_POOLED, VCH_POOLED, VCH_POOLED, VCH_POOLED, VCH_LOB, VCH_LOB};
+    size_t count = sizeof(lengths) / sizeof(lengths[0]);
+    vch_ticket_t tickets[sizeof(lengths) / sizeof(lengths[0])];
+
+    for(size_t i = 0; i < count; i++){
+        char* str = make_string(lengths[i]);
+        tickets[i] = vch_add(db->varchar_mgr_idx, str);
+        assert(tickets[i].flags == flags[i]);
+        assert(tickets[i].size == lengths[i] + 1);
+        free(str);
+    }
+    for(size_t i = 0; i < count; i++){
+        char* expected = make_string(lengths[i]);
+        char* str = vch_acquire(db->varchar_mgr_idx, &tickets[i]);
+        assert(str != NULL && strcmp(expected, str) == 0);
+        vch_release(&tickets[i], str);
+        free(expected);
+    }
+    for(size_t i = 0; i < count; i++){
+        assert(vch_delete(db->varchar_mgr_idx, &tickets[i]) == LB_SUCCESS);
+    }
+    db_drop();
+}
+
+DEFINE_TEST(reuse_after_delete){
+    db_t* db = db_init("test.db");
+    char* str = make_string(300);
+    for(int i = 0; i < 1000; i++){
+        vch_ticket_t ticket = vch_add(db->varchar_mgr_idx, str);
+        assert(ticket.flags == VCH_POOLED);
+        char* read = vch_acquire(db->varchar_mgr_idx, &ticket);
+        assert(strcmp(read, str) == 0);
+        vch_release(&ticket, read);
+        assert(vch_delete(db->varchar_mgr_idx, &ticket) == LB_SUCCESS);
+    }
+    free(str);
+    db_drop();
+}
+
+DEFINE_TEST(lob_stream){
+    db_init("test.db");
+    /* Bigger than one run, so object consists of several extents */
+    int64_t size = LOB_MAX_RUN * PAGE_SIZE * 2 + 12345;
+    char* data = make_string(size - 1);
+    int64_t lob = lob_write(data, size);
+    assert(lob != LOB_FAIL);
+    assert(lob_size(lob) == size);
+    lob_header_t* header = pg_load_page(lob);
+    assert(header->extent_count == 3);
+
+    lob_stream_t stream;
+    assert(lob_stream_open(lob, &stream) == LOB_SUCCESS);
+    const char* chunk;
+    int64_t len;
+    int64_t pos = 0;
+    while((len = lob_stream_next(&stream, &chunk)) > 0){
+        assert(len <= PAGE_SIZE);
+        assert(memcmp(data + pos, chunk, len) == 0);
+        pos += len;
+    }
+    assert(len == 0 && pos == size);
+
+    char* read = malloc(size);
+    assert(lob_read(lob, read, size) == LOB_SUCCESS);
+    assert(memcmp(data, read, size) == 0);
+    assert(lob_delete(lob) == LOB_SUCCESS);
+    free(read);
+    free(data);
+    db_drop();
+}
+
+DEFINE_TEST(prefix_compare){
+    db_t* db = db_init("test.db");
+    const char* strs[] = {
+            "",
+            "abc",
+            "abcdefghijkl",
+            "abcdefghijklm",
+            "abcdefghijklmnopqrstuvwxyz0123456789",
+            "abcdefghijklmnopqrstuvwxyz0123456788",
+            "abcdefghijklmnopqrstuvwxyz0123456789",
+            "abd",
+    };
+    size_t count = sizeof(strs) / sizeof(strs[0]);
+    vch_ticket_t tickets[sizeof(strs) / sizeof(strs[0])];
+    for(size_t i = 0; i < count; i++){
+        tickets[i] = vch_add(db->varchar_mgr_idx, (char*) strs[i]);
+    }
+    assert(!vch_is_inline(&tickets[4]) && !vch_is_inline(&tickets[6]));
+    assert(vch_hash(&tickets[4]) == vch_hash(&tickets[6]));
+    for(size_t i = 0; i < count; i++){
+        for(size_t j = 0; j < count; j++){
+            int expected = strcmp(strs[i], strs[j]);
+            int res = vch_cmp(db->varchar_mgr_idx, &tickets[i], &tickets[j]);
+            assert((expected < 0) == (res < 0) && (expected > 0) == (res > 0));
+            assert(vch_eq(db->varchar_mgr_idx, &tickets[i], &tickets[j]) == (expected == 0));
+        }
+    }
+    db_drop();
+}
+
+DEFINE_TEST(transient_constant){
+    db_t* db = db_init("test.db");
+    int64_t lengths[] = {5, 100, 3000};
+    size_t count = sizeof(lengths) / sizeof(lengths[0]);
+    vch_ticket_t stored[sizeof(lengths) / sizeof(lengths[0])];
+    char* strs[sizeof(lengths) / sizeof(lengths[0])];
+    for(size_t i = 0; i < count; i++){
+        strs[i] = make_string(lengths[i]);
+        stored[i] = vch_add(db->varchar_mgr_idx, strs[i]);
+    }
+    int64_t max_page = pg_max_page_index();
+    for(size_t i = 0; i < count; i++){
+        vch_ticket_t constant = vch_transient(strs[i]);
+        assert(vch_is_transient(&constant));
+        assert(vch_acquire(db->varchar_mgr_idx, &constant) == strs[i]);
+        for(size_t j = 0; j < count; j++){
+            assert(vch_eq(db->varchar_mgr_idx, &stored[j], &constant) == (i == j));
+            assert((vch_cmp(db->varchar_mgr_idx, &stored[j], &constant) < 0) == (strcmp(strs[j], strs[i]) < 0));
+        }
+    }
+    assert(pg_max_page_index() == max_page);
+    for(size_t i = 0; i < count; i++){
+        free(strs[i]);
+    }
+    db_drop();
+}
+
+int main(){
+    RUN_SINGLE_TEST(size_classes_and_extent);
+    RUN_SINGLE_TEST(reuse_after_delete);
+    RUN_SINGLE_TEST(lob_stream);
+    RUN_SINGLE_TEST(prefix_compare);
+    RUN_SINGLE_TEST(transient_constant);
+    return 0;
+}